@@ -315,6 +315,7 @@ class SEQUENCER_PT_sequencer_overlay(Panel):
 
         col = split.column()
         col.prop(st.cache_overlay, "show_cache", text="Cache")
+        col.prop(overlay_settings, "show_render_times", text="Render Times")
 
 
 class SEQUENCER_PT_sequencer_overlay_strips(Panel):
@@ -518,6 +519,7 @@ class SEQUENCER_MT_view(Menu):
         layout.separator()
 
         layout.operator("sequencer.export_subtitles", text="Export Subtitles", icon='EXPORT')
+        layout.operator("sequencer.export_render_times", text="Export Render Times")
         layout.separator()
 
         # Note that the context is needed for the shortcut to display properly.
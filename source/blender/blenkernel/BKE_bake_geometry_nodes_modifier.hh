@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <condition_variable>
+
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_sub_frame.hh"
 
 #include "BKE_bake_items.hh"
@@ -16,6 +20,7 @@ struct NodesModifierData;
 struct Main;
 struct Object;
 struct Scene;
+struct TaskPool;
 
 namespace blender::bke::bake {
 
@@ -42,6 +47,20 @@ struct FrameCache {
    * or from an in-memory buffer.
    */
   std::optional<std::variant<std::string, Span<std::byte>>> meta_data_source;
+  /**
+   * Number of modifier evaluations that currently reference the state, possibly in other
+   * depsgraphs than the active one. The state of lazily loaded frames is only freed again when it
+   * has no users. Protected by #ModifierCache::mutex.
+   */
+  int users_num = 0;
+  /**
+   * Identifies the frame for the evaluations that use it, see #ModifierCache::remove_frame_users.
+   * Unlike the address of the frame, it is not reused by frames that are created after the cache
+   * has been reset.
+   */
+  uint64_t session_uid = next_session_uid();
+
+  static uint64_t next_session_uid();
 };
 
 /**
@@ -53,6 +72,49 @@ struct PrevCache {
   SubFrame frame;
 };
 
+struct NodeBakeCache;
+
+/**
+ * Loads baked frames that follow the current frame in the playback direction on a background
+ * thread. This way, reading and deserializing the baked data of the next frames happens while the
+ * current frame is displayed, instead of stalling the evaluation of the modifier.
+ *
+ * The loaded states are only handed over to the #FrameCache on the evaluation thread, so that the
+ * frame cache itself is never modified concurrently.
+ */
+class FramePrefetcher : NonCopyable, NonMovable {
+ private:
+  TaskPool *task_pool_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable loading_done_;
+  /** Frames that are currently loaded by the background thread. */
+  Set<const FrameCache *> loading_frames_;
+  /** Frames that have been loaded in the background but have not been used yet. */
+  Map<const FrameCache *, BakeState> loaded_states_;
+
+ public:
+  ~FramePrefetcher();
+
+  /** Start loading the given frame in the background if it is not loaded or loading already. */
+  void prefetch(const NodeBakeCache &bake_cache, const FrameCache &frame_cache);
+
+  /**
+   * Get the state that has been loaded in the background for the given frame. If the frame is
+   * still being loaded, this waits until it is done.
+   */
+  std::optional<BakeState> take_loaded_state(const FrameCache &frame_cache);
+
+  /**
+   * Free prefetched states of frames that are not in the given range anymore.
+   * \return True if any state was freed.
+   */
+  bool discard_outside(const NodeBakeCache &bake_cache, IndexRange frame_indices);
+
+ private:
+  static void load_task(TaskPool *__restrict pool, void *taskdata);
+  static void load_task_data_free(TaskPool *__restrict pool, void *taskdata);
+};
+
 /**
  * Baked data that corresponds to either a Simulation Output or Bake node.
  */
@@ -70,6 +132,14 @@ struct NodeBakeCache {
   /** Used to avoid checking if a bake exists many times. */
   bool failed_finding_bake = false;
 
+  /** Scene frame that has been read most recently, used to detect the playback direction. */
+  std::optional<SubFrame> last_read_frame;
+  /**
+   * Loads the next frames during playback. This is declared last, so that it is destructed (and
+   * thus stops using the data above) first.
+   */
+  std::unique_ptr<FramePrefetcher> prefetcher;
+
   /** Range spanning from the first to the last baked frame. */
   IndexRange frame_range() const;
 
@@ -108,8 +178,39 @@ struct ModifierCache {
   NodeBakeCache *get_node_bake_cache(const int id);
 
   void reset_cache(int id);
+
+  /**
+   * Remove the users that a modifier evaluation added to the frames with the given
+   * #FrameCache::session_uid, see #FrameCache::users_num. Frames that have been removed from the
+   * cache in the meantime are skipped. The mutex is expected to be locked.
+   */
+  void remove_frame_users(Span<uint64_t> frame_session_uids);
 };
 
+/**
+ * Number of lazily loaded frames that are read ahead of the current frame in the playback
+ * direction. Loaded frames that are further away than that from the current frame are freed
+ * again, to keep the memory usage of large baked simulations bounded.
+ */
+constexpr int bake_prefetch_frames_num = 8;
+
+/**
+ * Make sure the baked state of the frame is available when it is loaded lazily from disk or from
+ * packed data. Does nothing if the state is loaded already.
+ */
+void ensure_frame_loaded(NodeBakeCache &bake_cache, FrameCache &frame_cache);
+
+/**
+ * Called when the baked data around the frame at the given index is read for the current scene
+ * frame. If the scene frames are evaluated in playback order, the following baked frames are
+ * loaded in the background. Lazily loaded frames that are far away from the current frame are
+ * freed, unless they are still used by an evaluation in another depsgraph, as well as the blob
+ * data that is not shared with the remaining frames.
+ *
+ * This should only be called from the active depsgraph.
+ */
+void prefetch_frames(NodeBakeCache &bake_cache, int frame_index, SubFrame current_frame);
+
 /**
  * Reset all simulation caches in the scene, for use when some fundamental change made them
  * impossible to reuse.
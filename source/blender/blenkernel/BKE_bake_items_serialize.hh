@@ -154,6 +154,12 @@ class BlobReadSharing : NonCopyable, NonMovable {
   [[nodiscard]] std::optional<ImplicitSharingInfoAndData> read_shared(
       const io::serialize::DictionaryValue &io_data,
       FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const;
+
+  /**
+   * Free the data that is not used by anything but this map anymore, e.g. after the states that
+   * were read with it have been freed. It is read again when it is needed later on.
+   */
+  void remove_unused() const;
 };
 
 /**
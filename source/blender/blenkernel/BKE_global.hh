@@ -134,6 +134,13 @@ struct Global {
     void *file;
   } log;
 
+  /**
+   * File to write a trace of every compositor evaluation to, where `#` characters are replaced by
+   * the frame number. Empty if traces are not written.
+   * Set via `--debug-compositor-trace` command line argument.
+   */
+  char compositor_trace_filepath[/*FILE_MAX*/ 1024];
+
   /**
    * Debug flag, #G_DEBUG, #G_DEBUG_PYTHON & friends, set via:
    * - Command line arguments: `--debug`, `--debug-memory` ... etc.
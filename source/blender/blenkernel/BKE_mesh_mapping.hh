@@ -304,6 +304,10 @@ GroupedSpan<int> build_edge_to_corner_map(Span<int> corner_edges,
                                           Array<int> &r_offsets,
                                           Array<int> &r_indices);
 
+void build_edge_to_face_indices(OffsetIndices<int> faces,
+                                Span<int> corner_edges,
+                                OffsetIndices<int> offsets,
+                                MutableSpan<int> face_indices);
 GroupedSpan<int> build_edge_to_face_map(OffsetIndices<int> faces,
                                         Span<int> corner_edges,
                                         int edges_num,
@@ -78,6 +78,7 @@ class InverseEvalParams;
 }  // namespace nodes
 namespace compositor {
 class Context;
+class InputRegionParams;
 class NodeOperation;
 class ShaderNode;
 }  // namespace compositor
@@ -137,6 +138,8 @@ using NodeGetCompositorOperationFunction =
                                             blender::nodes::DNode node);
 using NodeGetCompositorShaderNodeFunction =
     blender::compositor::ShaderNode *(*)(blender::nodes::DNode node);
+using NodeGetCompositorInputRegionFunction =
+    void (*)(blender::compositor::InputRegionParams &params);
 using NodeExtraInfoFunction = void (*)(blender::nodes::NodeExtraInfoParams &params);
 using NodeInverseElemEvalFunction =
     void (*)(blender::nodes::value_elem::InverseElemEvalParams &params);
@@ -327,6 +330,11 @@ struct bNodeType {
    * responsibility of the caller. */
   NodeGetCompositorShaderNodeFunction get_compositor_shader_node;
 
+  /* Compute the region of an input of this node that is needed to compute the needed regions of
+   * its outputs. Used by the CPU compositor to only compute the pixels of the upstream results
+   * that can influence the final output. If not set, the entire input is assumed to be needed. */
+  NodeGetCompositorInputRegionFunction get_compositor_input_region;
+
   /* A message to display in the node header for unsupported compositor nodes. The message
    * is assumed to be static and thus require no memory handling. This field is to be removed when
    * all nodes are supported. */
@@ -2,8 +2,12 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_bake_geometry_nodes_modifier.hh"
 #include "BKE_collection.hh"
 #include "BKE_main.hh"
@@ -15,6 +19,7 @@
 #include "BLI_fileops.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
 
 #include "MOD_nodes.hh"
 
@@ -38,6 +43,12 @@ void NodeBakeCache::reset()
   new (this) NodeBakeCache();
 }
 
+uint64_t FrameCache::next_session_uid()
+{
+  static std::atomic<uint64_t> session_uid_counter = 0;
+  return session_uid_counter.fetch_add(1) + 1;
+}
+
 IndexRange NodeBakeCache::frame_range() const
 {
   if (this->frames.is_empty()) {
@@ -48,6 +59,191 @@ IndexRange NodeBakeCache::frame_range() const
   return IndexRange::from_begin_end_inclusive(start_frame, end_frame);
 }
 
+static std::optional<BakeState> load_frame_state(const NodeBakeCache &bake_cache,
+                                                 const FrameCache &frame_cache)
+{
+  if (!frame_cache.meta_data_source.has_value()) {
+    return std::nullopt;
+  }
+  if (bake_cache.memory_blob_reader) {
+    if (const auto *meta_buffer = std::get_if<Span<std::byte>>(&*frame_cache.meta_data_source)) {
+      const std::string meta_str{reinterpret_cast<const char *>(meta_buffer->data()),
+                                 size_t(meta_buffer->size())};
+      std::istringstream meta_stream{meta_str};
+      return deserialize_bake(
+          meta_stream, *bake_cache.memory_blob_reader, *bake_cache.blob_sharing);
+    }
+  }
+  if (!bake_cache.blobs_dir) {
+    return std::nullopt;
+  }
+  const auto *meta_path = std::get_if<std::string>(&*frame_cache.meta_data_source);
+  if (!meta_path) {
+    return std::nullopt;
+  }
+  DiskBlobReader blob_reader{*bake_cache.blobs_dir};
+  fstream meta_file{*meta_path};
+  return deserialize_bake(meta_file, blob_reader, *bake_cache.blob_sharing);
+}
+
+struct FramePrefetchTask {
+  FramePrefetcher *prefetcher;
+  const NodeBakeCache *bake_cache;
+  const FrameCache *frame_cache;
+};
+
+FramePrefetcher::~FramePrefetcher()
+{
+  if (task_pool_) {
+    BLI_task_pool_cancel(task_pool_);
+    BLI_task_pool_free(task_pool_);
+  }
+}
+
+void FramePrefetcher::prefetch(const NodeBakeCache &bake_cache, const FrameCache &frame_cache)
+{
+  std::lock_guard lock{mutex_};
+  if (loading_frames_.contains(&frame_cache) || loaded_states_.contains(&frame_cache)) {
+    return;
+  }
+  if (!task_pool_) {
+    /* Load frames one after the other, so that the next frame is always available first. */
+    task_pool_ = BLI_task_pool_create_background_serial(this, TASK_PRIORITY_LOW);
+  }
+  loading_frames_.add_new(&frame_cache);
+  FramePrefetchTask *task = MEM_new<FramePrefetchTask>(__func__);
+  task->prefetcher = this;
+  task->bake_cache = &bake_cache;
+  task->frame_cache = &frame_cache;
+  /* The task data is freed by the pool, so that tasks that are canceled before they run do not
+   * leak it. */
+  BLI_task_pool_push(task_pool_, load_task, task, true, load_task_data_free);
+}
+
+void FramePrefetcher::load_task(TaskPool *__restrict pool, void *taskdata)
+{
+  FramePrefetchTask *task = static_cast<FramePrefetchTask *>(taskdata);
+  FramePrefetcher &prefetcher = *task->prefetcher;
+  std::optional<BakeState> state;
+  if (!BLI_task_pool_current_canceled(pool)) {
+    state = load_frame_state(*task->bake_cache, *task->frame_cache);
+  }
+  {
+    std::lock_guard lock{prefetcher.mutex_};
+    prefetcher.loading_frames_.remove(task->frame_cache);
+    if (state.has_value()) {
+      prefetcher.loaded_states_.add(task->frame_cache, std::move(*state));
+    }
+  }
+  prefetcher.loading_done_.notify_all();
+}
+
+void FramePrefetcher::load_task_data_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<FramePrefetchTask *>(taskdata));
+}
+
+std::optional<BakeState> FramePrefetcher::take_loaded_state(const FrameCache &frame_cache)
+{
+  std::unique_lock lock{mutex_};
+  loading_done_.wait(lock, [&]() { return !loading_frames_.contains(&frame_cache); });
+  return loaded_states_.pop_try(&frame_cache);
+}
+
+bool FramePrefetcher::discard_outside(const NodeBakeCache &bake_cache,
+                                      const IndexRange frame_indices)
+{
+  Vector<BakeState> states_to_free;
+  {
+    std::lock_guard lock{mutex_};
+    for (const int i : bake_cache.frames.index_range()) {
+      if (frame_indices.contains(i)) {
+        continue;
+      }
+      if (std::optional<BakeState> state = loaded_states_.pop_try(bake_cache.frames[i].get())) {
+        states_to_free.append(std::move(*state));
+      }
+    }
+  }
+  /* States are freed outside of the lock, because that can take a while for large geometries. */
+  return !states_to_free.is_empty();
+}
+
+void ensure_frame_loaded(NodeBakeCache &bake_cache, FrameCache &frame_cache)
+{
+  if (!frame_cache.state.items_by_id.is_empty()) {
+    return;
+  }
+  if (bake_cache.prefetcher) {
+    if (std::optional<BakeState> state = bake_cache.prefetcher->take_loaded_state(frame_cache)) {
+      frame_cache.state = std::move(*state);
+      return;
+    }
+  }
+  if (std::optional<BakeState> state = load_frame_state(bake_cache, frame_cache)) {
+    frame_cache.state = std::move(*state);
+  }
+}
+
+void prefetch_frames(NodeBakeCache &bake_cache,
+                     const int frame_index,
+                     const SubFrame current_frame)
+{
+  const std::optional<SubFrame> last_frame = bake_cache.last_read_frame;
+  bake_cache.last_read_frame = current_frame;
+
+  /* Free lazily loaded frames that are far away from the current frame, they can be loaded again
+   * when they are needed. The neighbors of the current frame are kept because they may be used for
+   * interpolation. */
+  const IndexRange frames_to_keep = IndexRange::from_begin_end_inclusive(
+      std::max(0, frame_index - bake_prefetch_frames_num),
+      std::min(int(bake_cache.frames.size()) - 1, frame_index + bake_prefetch_frames_num));
+  bool freed_state = false;
+  if (bake_cache.prefetcher) {
+    freed_state = bake_cache.prefetcher->discard_outside(bake_cache, frames_to_keep);
+  }
+  for (const int i : bake_cache.frames.index_range()) {
+    FrameCache &frame_cache = *bake_cache.frames[i];
+    if (frames_to_keep.contains(i) || !frame_cache.meta_data_source.has_value()) {
+      continue;
+    }
+    /* Other depsgraphs may still reference the state while they are evaluated. */
+    if (frame_cache.users_num > 0 || frame_cache.state.items_by_id.is_empty()) {
+      continue;
+    }
+    frame_cache.state = {};
+    freed_state = true;
+  }
+  if (freed_state && bake_cache.blob_sharing) {
+    /* The blob sharing keeps the data of the freed states alive otherwise. */
+    bake_cache.blob_sharing->remove_unused();
+  }
+
+  if (!last_frame.has_value()) {
+    return;
+  }
+  /* Only read ahead during playback, i.e. when the frames are evaluated in order. */
+  const float delta = float(current_frame) - float(*last_frame);
+  if (delta == 0.0f || std::abs(delta) > 1.0f) {
+    return;
+  }
+  const int direction = delta > 0.0f ? 1 : -1;
+  for (const int i : IndexRange(1, bake_prefetch_frames_num)) {
+    const int prefetch_index = frame_index + i * direction;
+    if (!bake_cache.frames.index_range().contains(prefetch_index)) {
+      break;
+    }
+    const FrameCache &frame_cache = *bake_cache.frames[prefetch_index];
+    if (!frame_cache.meta_data_source.has_value() || !frame_cache.state.items_by_id.is_empty()) {
+      continue;
+    }
+    if (!bake_cache.prefetcher) {
+      bake_cache.prefetcher = std::make_unique<FramePrefetcher>();
+    }
+    bake_cache.prefetcher->prefetch(bake_cache, frame_cache);
+  }
+}
+
 SimulationNodeCache *ModifierCache::get_simulation_node_cache(const int id)
 {
   std::unique_ptr<SimulationNodeCache> *ptr = this->simulation_cache_by_id.lookup_ptr(id);
@@ -71,6 +267,23 @@ NodeBakeCache *ModifierCache::get_node_bake_cache(const int id)
   return nullptr;
 }
 
+void ModifierCache::remove_frame_users(const Span<uint64_t> frame_session_uids)
+{
+  auto remove_users = [&](NodeBakeCache &bake_cache) {
+    for (const std::unique_ptr<FrameCache> &frame_cache : bake_cache.frames) {
+      const int64_t users_num = std::count(
+          frame_session_uids.begin(), frame_session_uids.end(), frame_cache->session_uid);
+      frame_cache->users_num = std::max<int>(0, frame_cache->users_num - int(users_num));
+    }
+  };
+  for (std::unique_ptr<SimulationNodeCache> &node_cache : this->simulation_cache_by_id.values()) {
+    remove_users(node_cache->bake);
+  }
+  for (std::unique_ptr<BakeNodeCache> &node_cache : this->bake_cache_by_id.values()) {
+    remove_users(node_cache->bake);
+  }
+}
+
 void ModifierCache::reset_cache(const int id)
 {
   if (SimulationNodeCache *cache = this->get_simulation_node_cache(id)) {
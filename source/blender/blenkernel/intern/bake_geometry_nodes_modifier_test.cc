@@ -0,0 +1,198 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <sstream>
+
+#include "testing/testing.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_bake_geometry_nodes_modifier.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.hh"
+#include "BKE_pointcloud.hh"
+
+#include "DNA_pointcloud_types.h"
+
+namespace blender::bke::bake::tests {
+
+/**
+ * Bake with frames that are packed into memory and loaded lazily, like packed bakes in a file.
+ * Every frame contains a point cloud with its own positions.
+ */
+struct PackedBakeTestContext {
+  static constexpr int frames_num = 40;
+  static constexpr int points_num = 1000;
+
+  Vector<std::string> meta_data;
+  Vector<std::string> blobs;
+  NodeBakeCache bake_cache;
+
+  PackedBakeTestContext()
+  {
+    BKE_idtype_init();
+
+    MemoryBlobWriter blob_writer{"test"};
+    BlobWriteSharing blob_sharing;
+    for (const int i : IndexRange(frames_num)) {
+      PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+      pointcloud->positions_for_write().fill(float3(i));
+      BakeState state;
+      state.items_by_id.add_new(
+          0, std::make_unique<GeometryBakeItem>(GeometrySet::from_pointcloud(pointcloud)));
+      std::ostringstream meta_stream;
+      serialize_bake(state, blob_writer, blob_sharing, meta_stream);
+      meta_data.append(meta_stream.str());
+    }
+
+    bake_cache.memory_blob_reader = std::make_unique<MemoryBlobReader>();
+    bake_cache.blob_sharing = std::make_unique<BlobReadSharing>();
+    for (const auto item : blob_writer.get_stream_by_name().items()) {
+      blobs.append(item.value.stream->str());
+    }
+    int blob_index = 0;
+    for (const auto item : blob_writer.get_stream_by_name().items()) {
+      const std::string &blob = blobs[blob_index++];
+      bake_cache.memory_blob_reader->add(
+          item.key, Span(reinterpret_cast<const std::byte *>(blob.data()), blob.size()));
+    }
+
+    for (const int i : IndexRange(frames_num)) {
+      auto frame_cache = std::make_unique<FrameCache>();
+      frame_cache->frame = SubFrame(i);
+      frame_cache->meta_data_source = Span(
+          reinterpret_cast<const std::byte *>(meta_data[i].data()), meta_data[i].size());
+      bake_cache.frames.append(std::move(frame_cache));
+    }
+  }
+
+  /** Evaluate the frame like the modifier does in the active depsgraph. */
+  void read_frame(const int frame_index)
+  {
+    ensure_frame_loaded(bake_cache, *bake_cache.frames[frame_index]);
+    prefetch_frames(bake_cache, frame_index, SubFrame(frame_index));
+  }
+
+  int loaded_frames_num() const
+  {
+    int count = 0;
+    for (const std::unique_ptr<FrameCache> &frame_cache : bake_cache.frames) {
+      if (!frame_cache->state.items_by_id.is_empty()) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  const ImplicitSharingInfo *positions_sharing_info(const int frame_index) const
+  {
+    const BakeState &state = bake_cache.frames[frame_index]->state;
+    const auto &item = static_cast<const GeometryBakeItem &>(*state.items_by_id.lookup(0));
+    const PointCloud *pointcloud = item.geometry.get_pointcloud();
+    return pointcloud->attributes().lookup("position").sharing_info;
+  }
+};
+
+TEST(bake_geometry_nodes_modifier, load_frames)
+{
+  PackedBakeTestContext ctx;
+  ctx.read_frame(5);
+  const BakeState &state = ctx.bake_cache.frames[5]->state;
+  ASSERT_TRUE(state.items_by_id.contains(0));
+  const auto &item = static_cast<const GeometryBakeItem &>(*state.items_by_id.lookup(0));
+  const PointCloud *pointcloud = item.geometry.get_pointcloud();
+  ASSERT_NE(pointcloud, nullptr);
+  EXPECT_EQ(pointcloud->totpoint, PackedBakeTestContext::points_num);
+  EXPECT_EQ(pointcloud->positions().first(), float3(5));
+}
+
+TEST(bake_geometry_nodes_modifier, memory_bounded_when_scrubbing)
+{
+  PackedBakeTestContext ctx;
+  const int max_loaded_frames_num = bake_prefetch_frames_num * 2 + 1;
+
+  ctx.read_frame(0);
+  const ImplicitSharingInfo *first_positions = ctx.positions_sharing_info(0);
+  first_positions->add_weak_user();
+
+  /* Play forward and backward through the whole bake, then jump around. */
+  for (const int i : IndexRange(PackedBakeTestContext::frames_num)) {
+    ctx.read_frame(i);
+    EXPECT_LE(ctx.loaded_frames_num(), max_loaded_frames_num);
+  }
+  for (int i = PackedBakeTestContext::frames_num - 1; i >= 0; i--) {
+    ctx.read_frame(i);
+    EXPECT_LE(ctx.loaded_frames_num(), max_loaded_frames_num);
+  }
+  for (const int i : {3, 35, 12, 39, 0, 27}) {
+    ctx.read_frame(i);
+    EXPECT_LE(ctx.loaded_frames_num(), max_loaded_frames_num);
+  }
+
+  /* The data of the first frame was reloaded when playing backward, but the data that was loaded
+   * first must have been freed, including the blob data that was shared with the reader. */
+  ctx.read_frame(PackedBakeTestContext::frames_num - 1);
+  EXPECT_TRUE(first_positions->is_expired());
+  first_positions->remove_weak_user_and_delete_if_last();
+}
+
+TEST(bake_geometry_nodes_modifier, used_frames_are_not_freed)
+{
+  PackedBakeTestContext ctx;
+  ctx.read_frame(0);
+
+  /* Simulate another depsgraph that still references the state of the first frame. */
+  ctx.bake_cache.frames[0]->users_num++;
+  const ImplicitSharingInfo *positions = ctx.positions_sharing_info(0);
+
+  ctx.read_frame(PackedBakeTestContext::frames_num - 1);
+  EXPECT_FALSE(ctx.bake_cache.frames[0]->state.items_by_id.is_empty());
+  EXPECT_EQ(ctx.positions_sharing_info(0), positions);
+
+  /* Once the other depsgraph does not use the frame anymore, it can be freed. */
+  ctx.bake_cache.frames[0]->users_num--;
+  ctx.read_frame(PackedBakeTestContext::frames_num - 2);
+  EXPECT_TRUE(ctx.bake_cache.frames[0]->state.items_by_id.is_empty());
+}
+
+TEST(bake_geometry_nodes_modifier, remove_frame_users)
+{
+  ModifierCache modifier_cache;
+  auto node_cache = std::make_unique<BakeNodeCache>();
+  node_cache->bake.frames.append(std::make_unique<FrameCache>());
+  node_cache->bake.frames.append(std::make_unique<FrameCache>());
+  FrameCache &first_frame = *node_cache->bake.frames[0];
+  FrameCache &second_frame = *node_cache->bake.frames[1];
+  modifier_cache.bake_cache_by_id.add_new(0, std::move(node_cache));
+
+  first_frame.users_num = 2;
+  second_frame.users_num = 1;
+  const FrameCache removed_frame;
+  const Vector<uint64_t> used_frames = {
+      first_frame.session_uid, second_frame.session_uid, removed_frame.session_uid};
+  modifier_cache.remove_frame_users(used_frames);
+  EXPECT_EQ(first_frame.users_num, 1);
+  EXPECT_EQ(second_frame.users_num, 0);
+}
+
+TEST(bake_geometry_nodes_modifier, remove_frame_users_after_reset)
+{
+  ModifierCache modifier_cache;
+  modifier_cache.bake_cache_by_id.add_new(0, std::make_unique<BakeNodeCache>());
+  BakeNodeCache &node_cache = *modifier_cache.bake_cache_by_id.lookup(0);
+  node_cache.bake.frames.append(std::make_unique<FrameCache>());
+  const uint64_t old_frame_session_uid = node_cache.bake.frames[0]->session_uid;
+
+  /* A frame that is created after the reset may be allocated where the removed frame was, but it
+   * must not lose the users of other evaluations to an evaluation that used the removed frame. */
+  node_cache.reset();
+  node_cache.bake.frames.append(std::make_unique<FrameCache>());
+  FrameCache &new_frame = *node_cache.bake.frames[0];
+  new_frame.users_num = 1;
+  EXPECT_NE(new_frame.session_uid, old_frame_session_uid);
+
+  modifier_cache.remove_frame_users({old_frame_session_uid});
+  EXPECT_EQ(new_frame.users_num, 1);
+}
+
+}  // namespace blender::bke::bake::tests
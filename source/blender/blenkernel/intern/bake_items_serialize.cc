@@ -287,6 +287,18 @@ std::optional<ImplicitSharingInfoAndData> BlobReadSharing::read_shared(
   return data;
 }
 
+void BlobReadSharing::remove_unused() const
+{
+  std::lock_guard lock{mutex_};
+  runtime_by_stored_.remove_if([](const auto item) {
+    if (!item.value.sharing_info->is_mutable()) {
+      return false;
+    }
+    item.value.sharing_info->remove_user_and_delete_if_last();
+    return true;
+  });
+}
+
 static StringRefNull get_endian_io_name(const int endian)
 {
   if (endian == L_ENDIAN) {
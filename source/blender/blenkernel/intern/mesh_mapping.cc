@@ -446,6 +446,14 @@ GroupedSpan<int> build_edge_to_corner_map(const Span<int> corner_edges,
   return gather_groups(corner_edges, edges_num, r_offsets, r_indices);
 }
 
+void build_edge_to_face_indices(const OffsetIndices<int> faces,
+                                const Span<int> corner_edges,
+                                const OffsetIndices<int> offsets,
+                                MutableSpan<int> face_indices)
+{
+  reverse_group_indices_in_groups(faces, corner_edges, offsets, face_indices);
+}
+
 GroupedSpan<int> build_edge_to_face_map(const OffsetIndices<int> faces,
                                         const Span<int> corner_edges,
                                         const int edges_num,
@@ -454,7 +462,7 @@ GroupedSpan<int> build_edge_to_face_map(const OffsetIndices<int> faces,
 {
   r_offsets = create_reverse_offsets(corner_edges, edges_num);
   r_indices.reinitialize(r_offsets.last());
-  reverse_group_indices_in_groups(faces, corner_edges, OffsetIndices<int>(r_offsets), r_indices);
+  build_edge_to_face_indices(faces, corner_edges, OffsetIndices<int>(r_offsets), r_indices);
   return {OffsetIndices<int>(r_offsets), r_indices};
 }
 
@@ -156,6 +156,27 @@ blender::GroupedSpan<int> Mesh::vert_to_face_map() const
   return {offsets, this->runtime->vert_to_face_map_cache.data()};
 }
 
+blender::OffsetIndices<int> Mesh::edge_to_face_map_offsets() const
+{
+  using namespace blender;
+  this->runtime->edge_to_face_offset_cache.ensure([&](Array<int> &r_data) {
+    r_data = Array<int>(this->edges_num + 1, 0);
+    offset_indices::build_reverse_offsets(this->corner_edges(), r_data);
+  });
+  return OffsetIndices<int>(this->runtime->edge_to_face_offset_cache.data());
+}
+
+blender::GroupedSpan<int> Mesh::edge_to_face_map() const
+{
+  using namespace blender;
+  const OffsetIndices offsets = this->edge_to_face_map_offsets();
+  this->runtime->edge_to_face_map_cache.ensure([&](Array<int> &r_data) {
+    r_data.reinitialize(this->corners_num);
+    bke::mesh::build_edge_to_face_indices(this->faces(), this->corner_edges(), offsets, r_data);
+  });
+  return {offsets, this->runtime->edge_to_face_map_cache.data()};
+}
+
 blender::GroupedSpan<int> Mesh::vert_to_corner_map() const
 {
   using namespace blender;
@@ -323,6 +344,8 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
   mesh->runtime->vert_to_face_map_cache.tag_dirty();
   mesh->runtime->vert_to_corner_map_cache.tag_dirty();
   mesh->runtime->corner_to_face_map_cache.tag_dirty();
+  mesh->runtime->edge_to_face_offset_cache.tag_dirty();
+  mesh->runtime->edge_to_face_map_cache.tag_dirty();
   mesh->runtime->vert_normals_cache.tag_dirty();
   mesh->runtime->face_normals_cache.tag_dirty();
   mesh->runtime->corner_normals_cache.tag_dirty();
@@ -346,6 +369,8 @@ void Mesh::tag_edges_split()
   this->runtime->vert_to_face_offset_cache.tag_dirty();
   this->runtime->vert_to_face_map_cache.tag_dirty();
   this->runtime->vert_to_corner_map_cache.tag_dirty();
+  this->runtime->edge_to_face_offset_cache.tag_dirty();
+  this->runtime->edge_to_face_map_cache.tag_dirty();
   if (this->runtime->loose_edges_cache.is_cached() &&
       this->runtime->loose_edges_cache.data().count != 0)
   {
@@ -1001,6 +1001,10 @@ static void scene_foreach_cache(ID *id,
     /* Preserve VSE thumbnail cache across global undo steps. */
     key.identifier = offsetof(Editing, runtime.thumbnail_cache);
     function_callback(id, &key, (void **)&scene->ed->runtime.thumbnail_cache, 0, user_data);
+    /* Keep recording render timings across global undo steps, the editors that display them
+     * don't register again. */
+    key.identifier = offsetof(Editing, runtime.render_timings);
+    function_callback(id, &key, (void **)&scene->ed->runtime.render_timings, 0, user_data);
   }
 }
 
@@ -1305,6 +1309,7 @@ static void scene_blend_read_data(BlendDataReader *reader, ID *id)
     ed->runtime.sequence_lookup = nullptr;
     ed->runtime.media_presence = nullptr;
     ed->runtime.thumbnail_cache = nullptr;
+    ed->runtime.render_timings = nullptr;
 
     /* recursive link sequences, lb will be correctly initialized */
     link_recurs_seq(reader, &ed->seqbase);
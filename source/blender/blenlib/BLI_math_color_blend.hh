@@ -0,0 +1,64 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Blending of whole spans of RGBA pixels. The result of each pixel is identical to calling the
+ * matching `blend_color_*_float` / `blend_color_*_byte` function from `BLI_math_color_blend.h`
+ * with the alpha of `src2` multiplied by the blend factor, but the common modes are processed
+ * with SIMD instructions instead of one channel at a time.
+ */
+
+#include <cstdint>
+
+#include "BLI_sys_types.h"
+
+namespace blender::math {
+
+enum class ColorBlendMode : int8_t {
+  Add,
+  Sub,
+  Mul,
+  Lighten,
+  Darken,
+  Overlay,
+  HardLight,
+  ColorBurn,
+  LinearBurn,
+  Dodge,
+  Screen,
+  SoftLight,
+  PinLight,
+  LinearLight,
+  VividLight,
+  Difference,
+  Exclusion,
+  Color,
+  Hue,
+  Saturation,
+  Luminosity,
+};
+
+/**
+ * Blend `size` RGBA pixels of `src2` over `src1` into `dst`. The alpha of `src2` is scaled by
+ * `fac`, pixels where it becomes zero are copied from `src1`. The alpha of `dst` is always the
+ * alpha of `src1`. `dst` may be the same buffer as `src1`.
+ */
+void blend_color_float(ColorBlendMode mode,
+                       float fac,
+                       const float *src1,
+                       const float *src2,
+                       float *dst,
+                       int64_t size);
+void blend_color_byte(ColorBlendMode mode,
+                      float fac,
+                      const uchar *src1,
+                      const uchar *src2,
+                      uchar *dst,
+                      int64_t size);
+
+}  // namespace blender::math
@@ -0,0 +1,684 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <cstring>
+
+#include "BLI_math_color_blend.h"
+#include "BLI_math_color_blend.hh"
+#include "BLI_simd.hh"
+
+#include "BLI_strict_flags.h" /* Keep last. */
+
+namespace blender::math {
+
+/* -------------------------------------------------------------------- */
+/** \name Scalar Fallback
+ * \{ */
+
+/* `blend_function` has to be: `void (T *dst, const T *src1, const T *src2)`. */
+template<typename T, typename Func>
+static void blend_span_scalar(
+    const float fac, const T *src1, const T *src2, T *dst, const int64_t size, Func blend_function)
+{
+  for (int64_t i = 0; i < size; i++) {
+    const T src2_pixel[4] = {src2[0], src2[1], src2[2], T(src2[3] * fac)};
+    blend_function(dst, src1, src2_pixel);
+    dst[3] = src1[3];
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+
+static void blend_float_scalar(const ColorBlendMode mode,
+                               const float fac,
+                               const float *src1,
+                               const float *src2,
+                               float *dst,
+                               const int64_t size)
+{
+  switch (mode) {
+    case ColorBlendMode::Add:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_add_float);
+      break;
+    case ColorBlendMode::Sub:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_sub_float);
+      break;
+    case ColorBlendMode::Mul:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_mul_float);
+      break;
+    case ColorBlendMode::Lighten:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_lighten_float);
+      break;
+    case ColorBlendMode::Darken:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_darken_float);
+      break;
+    case ColorBlendMode::Overlay:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_overlay_float);
+      break;
+    case ColorBlendMode::HardLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_hardlight_float);
+      break;
+    case ColorBlendMode::ColorBurn:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_burn_float);
+      break;
+    case ColorBlendMode::LinearBurn:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_linearburn_float);
+      break;
+    case ColorBlendMode::Dodge:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_dodge_float);
+      break;
+    case ColorBlendMode::Screen:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_screen_float);
+      break;
+    case ColorBlendMode::SoftLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_softlight_float);
+      break;
+    case ColorBlendMode::PinLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_pinlight_float);
+      break;
+    case ColorBlendMode::LinearLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_linearlight_float);
+      break;
+    case ColorBlendMode::VividLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_vividlight_float);
+      break;
+    case ColorBlendMode::Difference:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_difference_float);
+      break;
+    case ColorBlendMode::Exclusion:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_exclusion_float);
+      break;
+    case ColorBlendMode::Color:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_color_float);
+      break;
+    case ColorBlendMode::Hue:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_hue_float);
+      break;
+    case ColorBlendMode::Saturation:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_saturation_float);
+      break;
+    case ColorBlendMode::Luminosity:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_luminosity_float);
+      break;
+  }
+}
+
+static void blend_byte_scalar(const ColorBlendMode mode,
+                              const float fac,
+                              const uchar *src1,
+                              const uchar *src2,
+                              uchar *dst,
+                              const int64_t size)
+{
+  switch (mode) {
+    case ColorBlendMode::Add:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_add_byte);
+      break;
+    case ColorBlendMode::Sub:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_sub_byte);
+      break;
+    case ColorBlendMode::Mul:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_mul_byte);
+      break;
+    case ColorBlendMode::Lighten:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_lighten_byte);
+      break;
+    case ColorBlendMode::Darken:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_darken_byte);
+      break;
+    case ColorBlendMode::Overlay:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_overlay_byte);
+      break;
+    case ColorBlendMode::HardLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_hardlight_byte);
+      break;
+    case ColorBlendMode::ColorBurn:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_burn_byte);
+      break;
+    case ColorBlendMode::LinearBurn:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_linearburn_byte);
+      break;
+    case ColorBlendMode::Dodge:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_dodge_byte);
+      break;
+    case ColorBlendMode::Screen:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_screen_byte);
+      break;
+    case ColorBlendMode::SoftLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_softlight_byte);
+      break;
+    case ColorBlendMode::PinLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_pinlight_byte);
+      break;
+    case ColorBlendMode::LinearLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_linearlight_byte);
+      break;
+    case ColorBlendMode::VividLight:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_vividlight_byte);
+      break;
+    case ColorBlendMode::Difference:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_difference_byte);
+      break;
+    case ColorBlendMode::Exclusion:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_exclusion_byte);
+      break;
+    case ColorBlendMode::Color:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_color_byte);
+      break;
+    case ColorBlendMode::Hue:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_hue_byte);
+      break;
+    case ColorBlendMode::Saturation:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_saturation_byte);
+      break;
+    case ColorBlendMode::Luminosity:
+      blend_span_scalar(fac, src1, src2, dst, size, blend_color_luminosity_byte);
+      break;
+  }
+}
+
+/** \} */
+
+#if BLI_HAVE_SSE2
+
+/* -------------------------------------------------------------------- */
+/** \name SIMD Float Blending
+ *
+ * One RGBA pixel per register. Each operator mirrors the arithmetic of the scalar
+ * `blend_color_*_float` function exactly (same operations in the same order, no fused
+ * multiply-add), branches are replaced by computing both sides and selecting per channel.
+ * \{ */
+
+static inline __m128 select_ps(const __m128 mask, const __m128 a, const __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 splat_alpha(const __m128 a)
+{
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* `temp * t + a * (1 - t)`, the final mix of most separable modes. */
+static inline __m128 mix_ps(const __m128 temp, const __m128 a, const __m128 t, const __m128 mt)
+{
+  return _mm_add_ps(_mm_mul_ps(temp, t), _mm_mul_ps(a, mt));
+}
+
+struct BlendAddFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 /*t*/, const __m128 /*mt*/) const
+  {
+    return _mm_add_ps(a, _mm_mul_ps(b, splat_alpha(a)));
+  }
+};
+
+struct BlendSubFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 /*t*/, const __m128 /*mt*/) const
+  {
+    return _mm_max_ps(_mm_sub_ps(a, _mm_mul_ps(b, splat_alpha(a))), _mm_setzero_ps());
+  }
+};
+
+struct BlendMulFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 /*t*/, const __m128 mt) const
+  {
+    return _mm_add_ps(_mm_mul_ps(mt, a), _mm_mul_ps(_mm_mul_ps(a, b), splat_alpha(a)));
+  }
+};
+
+struct BlendLightenFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 map_alpha = _mm_div_ps(splat_alpha(a), t);
+    return _mm_add_ps(_mm_mul_ps(mt, a), _mm_mul_ps(t, _mm_max_ps(a, _mm_mul_ps(b, map_alpha))));
+  }
+};
+
+struct BlendDarkenFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 map_alpha = _mm_div_ps(splat_alpha(a), t);
+    return _mm_add_ps(_mm_mul_ps(mt, a), _mm_mul_ps(t, _mm_min_ps(a, _mm_mul_ps(b, map_alpha))));
+  }
+};
+
+struct BlendOverlayFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 inv = _mm_sub_ps(one, _mm_mul_ps(two, _mm_sub_ps(a, half)));
+    const __m128 hi = _mm_sub_ps(one, _mm_mul_ps(inv, _mm_sub_ps(one, b)));
+    const __m128 lo = _mm_mul_ps(_mm_mul_ps(two, a), b);
+    const __m128 temp = select_ps(_mm_cmpgt_ps(a, half), hi, lo);
+    return _mm_min_ps(mix_ps(temp, a, t, mt), one);
+  }
+};
+
+struct BlendHardLightFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 inv = _mm_sub_ps(one, _mm_mul_ps(two, _mm_sub_ps(b, half)));
+    const __m128 hi = _mm_sub_ps(one, _mm_mul_ps(inv, _mm_sub_ps(one, a)));
+    const __m128 lo = _mm_mul_ps(_mm_mul_ps(two, b), a);
+    const __m128 temp = select_ps(_mm_cmpgt_ps(b, half), hi, lo);
+    return _mm_min_ps(mix_ps(temp, a, t, mt), one);
+  }
+};
+
+struct BlendColorBurnFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 burn = _mm_max_ps(_mm_sub_ps(one, _mm_div_ps(_mm_sub_ps(one, a), b)), zero);
+    const __m128 temp = select_ps(_mm_cmpeq_ps(b, zero), zero, burn);
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendLinearBurnFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 temp = _mm_max_ps(_mm_sub_ps(_mm_add_ps(a, b), one), _mm_setzero_ps());
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendDodgeFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 dodge = _mm_min_ps(_mm_div_ps(a, _mm_sub_ps(one, b)), one);
+    const __m128 temp = select_ps(_mm_cmpge_ps(b, one), one, dodge);
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendScreenFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 temp = _mm_max_ps(
+        _mm_sub_ps(one, _mm_mul_ps(_mm_sub_ps(one, a), _mm_sub_ps(one, b))), _mm_setzero_ps());
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendSoftLightFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 inv_a = _mm_sub_ps(one, a);
+    const __m128 screen = _mm_sub_ps(one, _mm_mul_ps(inv_a, _mm_sub_ps(one, b)));
+    const __m128 soft_light = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(inv_a, b), screen), a);
+    return _mm_add_ps(_mm_mul_ps(a, mt), _mm_mul_ps(soft_light, t));
+  }
+};
+
+struct BlendPinLightFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 hi = _mm_max_ps(_mm_mul_ps(two, _mm_sub_ps(b, half)), a);
+    const __m128 lo = _mm_min_ps(_mm_mul_ps(two, b), a);
+    const __m128 temp = select_ps(_mm_cmpgt_ps(b, half), hi, lo);
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendLinearLightFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 hi = _mm_min_ps(_mm_add_ps(a, _mm_mul_ps(two, _mm_sub_ps(b, half))), one);
+    const __m128 lo = _mm_max_ps(_mm_sub_ps(_mm_add_ps(a, _mm_mul_ps(two, b)), one),
+                                 _mm_setzero_ps());
+    const __m128 temp = select_ps(_mm_cmpgt_ps(b, half), hi, lo);
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendVividLightFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 b_one = select_ps(_mm_cmpeq_ps(a, zero), half, one);
+    const __m128 b_zero = select_ps(_mm_cmpeq_ps(a, one), half, zero);
+    const __m128 hi = _mm_min_ps(_mm_div_ps(a, _mm_mul_ps(two, _mm_sub_ps(one, b))), one);
+    const __m128 lo = _mm_max_ps(
+        _mm_sub_ps(one, _mm_div_ps(_mm_sub_ps(one, a), _mm_mul_ps(two, b))), zero);
+    __m128 temp = select_ps(_mm_cmpgt_ps(b, half), hi, lo);
+    temp = select_ps(_mm_cmpeq_ps(b, zero), b_zero, temp);
+    temp = select_ps(_mm_cmpeq_ps(b, one), b_one, temp);
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendDifferenceFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 temp = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(a, b));
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+struct BlendExclusionFloat {
+  __m128 operator()(const __m128 a, const __m128 b, const __m128 t, const __m128 mt) const
+  {
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 temp = _mm_sub_ps(
+        half, _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(a, half)), _mm_sub_ps(b, half)));
+    return mix_ps(temp, a, t, mt);
+  }
+};
+
+template<typename Op>
+static void blend_span_float_simd(
+    const float fac, const float *src1, const float *src2, float *dst, const int64_t size)
+{
+  const Op op;
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 alpha_mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+  for (int64_t i = 0; i < size; i++) {
+    const __m128 a = _mm_loadu_ps(src1);
+    const float alpha = src2[3] * fac;
+    if (alpha == 0.0f) {
+      _mm_storeu_ps(dst, a);
+    }
+    else {
+      const __m128 b = _mm_loadu_ps(src2);
+      const __m128 t = _mm_set1_ps(alpha);
+      const __m128 mt = _mm_sub_ps(one, t);
+      /* Alpha is always taken from the first input. */
+      _mm_storeu_ps(dst, select_ps(alpha_mask, a, op(a, b, t, mt)));
+    }
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+
+/** \} */
+
+#endif /* BLI_HAVE_SSE2 */
+
+#if BLI_HAVE_SSE4
+
+/* -------------------------------------------------------------------- */
+/** \name SIMD Byte Blending
+ *
+ * One RGBA pixel per register, widened to 32 bit integer lanes. Divisions by 255 are done in
+ * floating point followed by truncation, which is exact for the value ranges involved here.
+ * \{ */
+
+static inline __m128i load_pixel_byte(const uchar *src)
+{
+  int32_t pixel;
+  memcpy(&pixel, src, sizeof(pixel));
+  return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel));
+}
+
+static inline void store_pixel_byte(const __m128i value, uchar *dst)
+{
+  const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(value, value), value);
+  const int32_t pixel = _mm_cvtsi128_si32(packed);
+  memcpy(dst, &pixel, sizeof(pixel));
+}
+
+/* Truncating `x / divisor` for `0 <= x < 2^24`, exact as long as the quotient is small. */
+static inline __m128i divide_trunc_i(const __m128i x, const float divisor)
+{
+  return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(divisor)));
+}
+
+/* Same as `divide_round_i(x, 255)` for `x >= 0`. */
+static inline __m128i divide_round_255(const __m128i x)
+{
+  return divide_trunc_i(_mm_add_epi32(x, _mm_set1_epi32(127)), 255.0f);
+}
+
+/* `(temp * t + a * (255 - t)) / 255`, the final mix of the separable byte modes. */
+static inline __m128i mix_epi32(const __m128i temp,
+                                const __m128i a,
+                                const __m128i t,
+                                const __m128i mt)
+{
+  return divide_trunc_i(_mm_add_epi32(_mm_mullo_epi32(temp, t), _mm_mullo_epi32(a, mt)),
+                        255.0f);
+}
+
+struct BlendAddByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i /*mt*/) const
+  {
+    const __m128i tmp = _mm_add_epi32(_mm_mullo_epi32(a, _mm_set1_epi32(255)),
+                                      _mm_mullo_epi32(b, t));
+    return _mm_min_epi32(divide_round_255(tmp), _mm_set1_epi32(255));
+  }
+};
+
+struct BlendSubByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i /*mt*/) const
+  {
+    /* Negative values round towards zero and are clamped anyway. */
+    const __m128i tmp = _mm_sub_epi32(_mm_mullo_epi32(a, _mm_set1_epi32(255)),
+                                      _mm_mullo_epi32(b, t));
+    return divide_round_255(_mm_max_epi32(tmp, _mm_setzero_si128()));
+  }
+};
+
+struct BlendMulByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    const __m128i tmp = _mm_add_epi32(_mm_mullo_epi32(_mm_mullo_epi32(mt, a), _mm_set1_epi32(255)),
+                                      _mm_mullo_epi32(_mm_mullo_epi32(t, a), b));
+    /* Same as `divide_round_i(tmp, 255 * 255)`. */
+    return divide_trunc_i(_mm_add_epi32(tmp, _mm_set1_epi32(32512)), 65025.0f);
+  }
+};
+
+struct BlendLightenByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    return divide_round_255(
+        _mm_add_epi32(_mm_mullo_epi32(mt, a), _mm_mullo_epi32(t, _mm_max_epi32(a, b))));
+  }
+};
+
+struct BlendDarkenByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    return divide_round_255(
+        _mm_add_epi32(_mm_mullo_epi32(mt, a), _mm_mullo_epi32(t, _mm_min_epi32(a, b))));
+  }
+};
+
+struct BlendLinearBurnByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    const __m128i temp = _mm_max_epi32(_mm_sub_epi32(_mm_add_epi32(a, b), _mm_set1_epi32(255)),
+                                       _mm_setzero_si128());
+    return mix_epi32(temp, a, t, mt);
+  }
+};
+
+struct BlendScreenByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    const __m128i full = _mm_set1_epi32(255);
+    const __m128i product = _mm_mullo_epi32(_mm_sub_epi32(full, a), _mm_sub_epi32(full, b));
+    const __m128i temp = _mm_sub_epi32(full, divide_trunc_i(product, 255.0f));
+    return mix_epi32(temp, a, t, mt);
+  }
+};
+
+struct BlendDifferenceByte {
+  __m128i operator()(const __m128i a, const __m128i b, const __m128i t, const __m128i mt) const
+  {
+    return mix_epi32(_mm_abs_epi32(_mm_sub_epi32(a, b)), a, t, mt);
+  }
+};
+
+template<typename Op>
+static void blend_span_byte_simd(
+    const float fac, const uchar *src1, const uchar *src2, uchar *dst, const int64_t size)
+{
+  const Op op;
+  const __m128i full = _mm_set1_epi32(255);
+  for (int64_t i = 0; i < size; i++) {
+    const uchar alpha = uchar(src2[3] * fac);
+    if (alpha == 0) {
+      memcpy(dst, src1, sizeof(uchar[4]));
+    }
+    else {
+      const __m128i a = load_pixel_byte(src1);
+      const __m128i b = load_pixel_byte(src2);
+      const __m128i t = _mm_set1_epi32(alpha);
+      const __m128i mt = _mm_sub_epi32(full, t);
+      /* Alpha is always taken from the first input. */
+      store_pixel_byte(_mm_blend_epi16(op(a, b, t, mt), a, 0xC0), dst);
+    }
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+
+/** \} */
+
+#endif /* BLI_HAVE_SSE4 */
+
+/* -------------------------------------------------------------------- */
+/** \name Public API
+ * \{ */
+
+void blend_color_float(const ColorBlendMode mode,
+                       const float fac,
+                       const float *src1,
+                       const float *src2,
+                       float *dst,
+                       const int64_t size)
+{
+#if BLI_HAVE_SSE2
+  switch (mode) {
+    case ColorBlendMode::Add:
+      blend_span_float_simd<BlendAddFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Sub:
+      blend_span_float_simd<BlendSubFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Mul:
+      blend_span_float_simd<BlendMulFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Lighten:
+      blend_span_float_simd<BlendLightenFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Darken:
+      blend_span_float_simd<BlendDarkenFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Overlay:
+      blend_span_float_simd<BlendOverlayFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::HardLight:
+      blend_span_float_simd<BlendHardLightFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::ColorBurn:
+      blend_span_float_simd<BlendColorBurnFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::LinearBurn:
+      blend_span_float_simd<BlendLinearBurnFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Dodge:
+      blend_span_float_simd<BlendDodgeFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Screen:
+      blend_span_float_simd<BlendScreenFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::SoftLight:
+      blend_span_float_simd<BlendSoftLightFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::PinLight:
+      blend_span_float_simd<BlendPinLightFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::LinearLight:
+      blend_span_float_simd<BlendLinearLightFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::VividLight:
+      blend_span_float_simd<BlendVividLightFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Difference:
+      blend_span_float_simd<BlendDifferenceFloat>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Exclusion:
+      blend_span_float_simd<BlendExclusionFloat>(fac, src1, src2, dst, size);
+      return;
+    default:
+      /* HSV based modes are not separable per channel. */
+      break;
+  }
+#endif
+  blend_float_scalar(mode, fac, src1, src2, dst, size);
+}
+
+void blend_color_byte(const ColorBlendMode mode,
+                      const float fac,
+                      const uchar *src1,
+                      const uchar *src2,
+                      uchar *dst,
+                      const int64_t size)
+{
+#if BLI_HAVE_SSE4
+  switch (mode) {
+    case ColorBlendMode::Add:
+      blend_span_byte_simd<BlendAddByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Sub:
+      blend_span_byte_simd<BlendSubByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Mul:
+      blend_span_byte_simd<BlendMulByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Lighten:
+      blend_span_byte_simd<BlendLightenByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Darken:
+      blend_span_byte_simd<BlendDarkenByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::LinearBurn:
+      blend_span_byte_simd<BlendLinearBurnByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Screen:
+      blend_span_byte_simd<BlendScreenByte>(fac, src1, src2, dst, size);
+      return;
+    case ColorBlendMode::Difference:
+      blend_span_byte_simd<BlendDifferenceByte>(fac, src1, src2, dst, size);
+      return;
+    default:
+      /* Modes with per channel divisions or HSV conversion. */
+      break;
+  }
+#endif
+  blend_byte_scalar(mode, fac, src1, src2, dst, size);
+}
+
+/** \} */
+
+}  // namespace blender::math
@@ -0,0 +1,216 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_color_blend.h"
+#include "BLI_math_color_blend.hh"
+#include "BLI_rand.hh"
+
+namespace blender::math::tests {
+
+static constexpr int64_t pixels_num = 4096;
+
+static const ColorBlendMode all_modes[] = {
+    ColorBlendMode::Add,        ColorBlendMode::Sub,         ColorBlendMode::Mul,
+    ColorBlendMode::Lighten,    ColorBlendMode::Darken,      ColorBlendMode::Overlay,
+    ColorBlendMode::HardLight,  ColorBlendMode::ColorBurn,   ColorBlendMode::LinearBurn,
+    ColorBlendMode::Dodge,      ColorBlendMode::Screen,      ColorBlendMode::SoftLight,
+    ColorBlendMode::PinLight,   ColorBlendMode::LinearLight, ColorBlendMode::VividLight,
+    ColorBlendMode::Difference, ColorBlendMode::Exclusion,   ColorBlendMode::Color,
+    ColorBlendMode::Hue,        ColorBlendMode::Saturation,  ColorBlendMode::Luminosity,
+};
+
+template<typename T> using BlendFunction = void (*)(T dst[4], const T src1[4], const T src2[4]);
+
+static BlendFunction<float> get_blend_function_float(const ColorBlendMode mode)
+{
+  switch (mode) {
+    case ColorBlendMode::Add:
+      return blend_color_add_float;
+    case ColorBlendMode::Sub:
+      return blend_color_sub_float;
+    case ColorBlendMode::Mul:
+      return blend_color_mul_float;
+    case ColorBlendMode::Lighten:
+      return blend_color_lighten_float;
+    case ColorBlendMode::Darken:
+      return blend_color_darken_float;
+    case ColorBlendMode::Overlay:
+      return blend_color_overlay_float;
+    case ColorBlendMode::HardLight:
+      return blend_color_hardlight_float;
+    case ColorBlendMode::ColorBurn:
+      return blend_color_burn_float;
+    case ColorBlendMode::LinearBurn:
+      return blend_color_linearburn_float;
+    case ColorBlendMode::Dodge:
+      return blend_color_dodge_float;
+    case ColorBlendMode::Screen:
+      return blend_color_screen_float;
+    case ColorBlendMode::SoftLight:
+      return blend_color_softlight_float;
+    case ColorBlendMode::PinLight:
+      return blend_color_pinlight_float;
+    case ColorBlendMode::LinearLight:
+      return blend_color_linearlight_float;
+    case ColorBlendMode::VividLight:
+      return blend_color_vividlight_float;
+    case ColorBlendMode::Difference:
+      return blend_color_difference_float;
+    case ColorBlendMode::Exclusion:
+      return blend_color_exclusion_float;
+    case ColorBlendMode::Color:
+      return blend_color_color_float;
+    case ColorBlendMode::Hue:
+      return blend_color_hue_float;
+    case ColorBlendMode::Saturation:
+      return blend_color_saturation_float;
+    case ColorBlendMode::Luminosity:
+      return blend_color_luminosity_float;
+  }
+  return nullptr;
+}
+
+static BlendFunction<uchar> get_blend_function_byte(const ColorBlendMode mode)
+{
+  switch (mode) {
+    case ColorBlendMode::Add:
+      return blend_color_add_byte;
+    case ColorBlendMode::Sub:
+      return blend_color_sub_byte;
+    case ColorBlendMode::Mul:
+      return blend_color_mul_byte;
+    case ColorBlendMode::Lighten:
+      return blend_color_lighten_byte;
+    case ColorBlendMode::Darken:
+      return blend_color_darken_byte;
+    case ColorBlendMode::Overlay:
+      return blend_color_overlay_byte;
+    case ColorBlendMode::HardLight:
+      return blend_color_hardlight_byte;
+    case ColorBlendMode::ColorBurn:
+      return blend_color_burn_byte;
+    case ColorBlendMode::LinearBurn:
+      return blend_color_linearburn_byte;
+    case ColorBlendMode::Dodge:
+      return blend_color_dodge_byte;
+    case ColorBlendMode::Screen:
+      return blend_color_screen_byte;
+    case ColorBlendMode::SoftLight:
+      return blend_color_softlight_byte;
+    case ColorBlendMode::PinLight:
+      return blend_color_pinlight_byte;
+    case ColorBlendMode::LinearLight:
+      return blend_color_linearlight_byte;
+    case ColorBlendMode::VividLight:
+      return blend_color_vividlight_byte;
+    case ColorBlendMode::Difference:
+      return blend_color_difference_byte;
+    case ColorBlendMode::Exclusion:
+      return blend_color_exclusion_byte;
+    case ColorBlendMode::Color:
+      return blend_color_color_byte;
+    case ColorBlendMode::Hue:
+      return blend_color_hue_byte;
+    case ColorBlendMode::Saturation:
+      return blend_color_saturation_byte;
+    case ColorBlendMode::Luminosity:
+      return blend_color_luminosity_byte;
+  }
+  return nullptr;
+}
+
+/* Per pixel reference, matching how blend modes are applied by the sequencer. */
+template<typename T>
+static void blend_reference(BlendFunction<T> blend_function,
+                            const float fac,
+                            const T *src1,
+                            const T *src2,
+                            T *dst,
+                            const int64_t size)
+{
+  for (int64_t i = 0; i < size * 4; i += 4) {
+    const T src2_pixel[4] = {src2[i], src2[i + 1], src2[i + 2], T(src2[i + 3] * fac)};
+    blend_function(dst + i, src1 + i, src2_pixel);
+    dst[i + 3] = src1[i + 3];
+  }
+}
+
+/* Random values, with the exact values that select special cases in some modes mixed in. */
+static float random_channel_float(RandomNumberGenerator &rng)
+{
+  const float special[] = {0.0f, 0.5f, 1.0f};
+  if (rng.get_int32(8) == 0) {
+    return special[rng.get_int32(3)];
+  }
+  return rng.get_float();
+}
+
+TEST(math_color_blend, BlendFloatMatchesPerPixel)
+{
+  RandomNumberGenerator rng(42);
+  Array<float> src1(pixels_num * 4), src2(pixels_num * 4);
+  for (const int64_t i : src1.index_range()) {
+    src1[i] = random_channel_float(rng);
+    src2[i] = random_channel_float(rng);
+  }
+
+  Array<float> expected(pixels_num * 4), result(pixels_num * 4);
+  for (const ColorBlendMode mode : all_modes) {
+    for (const float fac : {0.0f, 0.3f, 1.0f}) {
+      blend_reference(get_blend_function_float(mode),
+                      fac,
+                      src1.data(),
+                      src2.data(),
+                      expected.data(),
+                      pixels_num);
+      blend_color_float(mode, fac, src1.data(), src2.data(), result.data(), pixels_num);
+      for (const int64_t i : expected.index_range()) {
+        EXPECT_NEAR(expected[i], result[i], 1e-6f) << "mode " << int(mode) << ", index " << i;
+      }
+    }
+  }
+}
+
+TEST(math_color_blend, BlendByteMatchesPerPixel)
+{
+  RandomNumberGenerator rng(42);
+  Array<uchar> src1(pixels_num * 4), src2(pixels_num * 4);
+  for (const int64_t i : src1.index_range()) {
+    src1[i] = uchar(rng.get_int32(256));
+    src2[i] = uchar(rng.get_int32(256));
+  }
+
+  Array<uchar> expected(pixels_num * 4), result(pixels_num * 4);
+  for (const ColorBlendMode mode : all_modes) {
+    for (const float fac : {0.0f, 0.3f, 1.0f}) {
+      blend_reference(get_blend_function_byte(mode),
+                      fac,
+                      src1.data(),
+                      src2.data(),
+                      expected.data(),
+                      pixels_num);
+      blend_color_byte(mode, fac, src1.data(), src2.data(), result.data(), pixels_num);
+      for (const int64_t i : expected.index_range()) {
+        EXPECT_EQ(expected[i], result[i]) << "mode " << int(mode) << ", index " << i;
+      }
+    }
+  }
+}
+
+TEST(math_color_blend, BlendInPlace)
+{
+  const float src2[8] = {0.2f, 0.4f, 0.6f, 1.0f, 0.9f, 0.1f, 0.5f, 0.0f};
+  float pixels[8] = {0.5f, 0.5f, 0.5f, 1.0f, 0.3f, 0.2f, 0.1f, 0.8f};
+  float expected[8];
+  blend_reference<float>(blend_color_mul_float, 1.0f, pixels, src2, expected, 2);
+  blend_color_float(ColorBlendMode::Mul, 1.0f, pixels, src2, pixels, 2);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_NEAR(pixels[i], expected[i], 1e-6f);
+  }
+}
+
+}  // namespace blender::math::tests
@@ -10,6 +10,8 @@
 
 #include "COM_domain.hh"
 #include "COM_node_operation.hh"
+#include "COM_operation.hh"
+#include "COM_operation_task_graph.hh"
 #include "COM_pixel_operation.hh"
 #include "COM_scheduler.hh"
 
@@ -107,6 +109,10 @@ class CompileState {
  private:
   /* A reference to the node execution schedule that is being compiled. */
   const Schedule &schedule_;
+  /* The task graph that evaluates the compiled operations concurrently, or null if operations are
+   * evaluated as soon as they are compiled. If not null, the domains of results are only known
+   * after waiting for the operations that compute them to be evaluated. */
+  OperationTaskGraph *task_graph_;
   /* Those two maps associate each node with the operation it was compiled into. Each node is
    * either compiled into a node operation and added to node_operations, or compiled into a pixel
    * operation and added to pixel_operations. Those maps are used to retrieve the results of
@@ -122,8 +128,9 @@ class CompileState {
   Domain pixel_compile_unit_domain_ = Domain::identity();
 
  public:
-  /* Construct a compile state from the node execution schedule being compiled. */
-  CompileState(const Schedule &schedule);
+  /* Construct a compile state from the node execution schedule being compiled and the task graph
+   * that evaluates the compiled operations, if any. */
+  CompileState(const Schedule &schedule, OperationTaskGraph *task_graph);
 
   /* Get a reference to the node execution schedule being compiled. */
   const Schedule &get_schedule();
@@ -140,6 +147,9 @@ class CompileState {
    * given output's node was compiled to. */
   Result &get_result_from_output_socket(DOutputSocket output);
 
+  /* Returns the operation that the given output's node was compiled to. */
+  Operation &get_operation_from_output_socket(DOutputSocket output);
+
   /* Add the given node to the compile unit. And if the domain of the compile unit is not yet
    * determined or was determined to be an identity domain, update it to the computed domain for
    * the give node. */
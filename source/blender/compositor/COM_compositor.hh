@@ -55,6 +55,21 @@ void COM_execute(Render *render,
                  blender::compositor::RenderContext *render_context,
                  blender::compositor::Profiler *profiler);
 
+/**
+ * \brief Whether traces of compositor evaluations should be written, which is the case when a
+ * trace file is given through the `--debug-compositor-trace` command line argument.
+ */
+bool COM_is_trace_requested();
+
+/**
+ * \brief Write the operation profiles collected by the given profiler to the trace file given
+ * through the `--debug-compositor-trace` command line argument, see
+ * #blender::compositor::Profiler::write_chrome_trace.
+ *
+ * \param frame: The frame that was composited, which replaces the `#` characters in the path.
+ */
+void COM_write_trace(const blender::compositor::Profiler &profiler, int frame);
+
 /**
  * \brief Deinitialize the compositor caches and allocated memory.
  * Use COM_clear_caches to only free the caches.
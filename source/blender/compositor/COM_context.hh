@@ -14,6 +14,7 @@
 #include "GPU_shader.hh"
 #include "GPU_texture.hh"
 
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_domain.hh"
 #include "COM_meta_data.hh"
 #include "COM_profiler.hh"
@@ -32,12 +33,15 @@ namespace blender::compositor {
  * providing input data like render passes and the active scene, as well as references to the data
  * where the output of the evaluator will be written. The class also provides a reference to the
  * texture pool which should be implemented by the caller and provided during construction.
- * Finally, the class have an instance of a static resource manager for acquiring cached resources
- * efficiently. */
+ * Finally, the class have an instance of a CPU buffer pool for allocating CPU results and an
+ * instance of a static resource manager for acquiring cached resources efficiently. */
 class Context {
  private:
   /* A texture pool that can be used to allocate textures for the compositor efficiently. */
   TexturePool &texture_pool_;
+  /* A buffer pool that can be used to allocate CPU results for the compositor efficiently. It
+   * persists as long as the context, so buffers are reused across evaluations. */
+  CPUBufferPool cpu_buffer_pool_;
   /* A static cache manager that can be used to acquire cached resources for the compositor
    * efficiently. */
   StaticCacheManager cache_manager_;
@@ -140,6 +144,12 @@ class Context {
    * executing as soon as possible. */
   virtual bool is_canceled() const;
 
+  /* Returns true if the inputs of the frame that will be evaluated after the current one, see
+   * get_next_frame_number, should be read ahead of time in the background while the current frame
+   * is evaluated. This is the case when rendering animations, where frames are evaluated in
+   * sequence. Defaults to false. */
+  virtual bool should_read_ahead() const;
+
   /* Resets the context's internal structures like texture pool and cache manager. This should be
    * called before every evaluation. */
   void reset();
@@ -159,6 +169,10 @@ class Context {
   /* Get the current frame number of the active scene. */
   int get_frame_number() const;
 
+  /* Get the frame number of the active scene that will be evaluated after the current one when
+   * rendering animations, taking the frame step into account. */
+  int get_next_frame_number() const;
+
   /* Get the current time in seconds of the active scene. */
   float get_time() const;
 
@@ -177,6 +191,9 @@ class Context {
   /* Get a reference to the texture pool of this context. */
   TexturePool &texture_pool();
 
+  /* Get a reference to the CPU buffer pool of this context. */
+  CPUBufferPool &cpu_buffer_pool();
+
   /* Get a reference to the static cache manager of this context. */
   StaticCacheManager &cache_manager();
 };
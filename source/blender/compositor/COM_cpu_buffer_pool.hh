@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_vector.hh"
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * CPU Buffer Pool Key
+ *
+ * A key used to identify a buffer specification in a CPU buffer pool. Defines a hash and an
+ * equality operator for use in a hash map. Buffers store elements of 4 bytes, that is, floats,
+ * integers, or pairs of half floats, so the element type is not part of the key. */
+class CPUBufferPoolKey {
+ public:
+  int2 size;
+  int channels_count;
+
+  /* Construct a key from the given buffer size and channels count. */
+  CPUBufferPoolKey(int2 size, int channels_count);
+
+  /* Returns the size of a buffer with this specification in bytes. */
+  int64_t size_in_bytes() const;
+
+  uint64_t hash() const;
+};
+
+bool operator==(const CPUBufferPoolKey &a, const CPUBufferPoolKey &b);
+
+/* ------------------------------------------------------------------------------------------------
+ * CPU Buffer Pool
+ *
+ * The CPU counterpart of the texture pool. A CPU buffer pool allows the allocation and reuse of
+ * the buffers that store the pixels of results throughout the execution of the compositor and
+ * across evaluations, to avoid the cost of allocating and page-faulting large buffers for every
+ * intermediate result of every evaluation.
+ *
+ * Released buffers are kept for reuse until they were not needed for a whole evaluation or until
+ * the memory they occupy exceeds the memory budget of the pool, in which case the buffers that
+ * were released the longest time ago are freed first. The pool is thread safe. */
+class CPUBufferPool {
+ private:
+  struct AvailableBuffer {
+    void *data;
+    /* The evaluation in which the buffer was last released. */
+    int64_t evaluation;
+    /* Increases with every release, used to free the least recently used buffers first. */
+    int64_t release_time;
+  };
+
+  std::mutex mutex_;
+  /* The set of buffers in the pool that are available to acquire for each distinct buffer
+   * specification. */
+  Map<CPUBufferPoolKey, Vector<AvailableBuffer>> available_buffers_;
+  /* The specification of every buffer that was acquired from the pool and not yet released. */
+  Map<const void *, CPUBufferPoolKey> acquired_buffers_;
+  /* The total size of the available buffers in bytes. */
+  int64_t available_size_ = 0;
+  /* The total size of the acquired buffers in bytes and its maximum since the last reset. */
+  int64_t acquired_size_ = 0;
+  int64_t peak_acquired_size_ = 0;
+  /* The maximum total size of the available buffers in bytes. */
+  int64_t memory_budget_;
+  int64_t evaluation_ = 0;
+  int64_t release_time_ = 0;
+
+ public:
+  CPUBufferPool();
+  ~CPUBufferPool();
+
+  /* Check if there is an available buffer with the given specification in the pool, if such
+   * buffer exists, return it, otherwise, return a newly allocated buffer. Expect the buffer to be
+   * uncleared and possibly contains garbage data. The buffer stores channels_count elements of 4
+   * bytes for every pixel. */
+  void *acquire(int2 size, int channels_count);
+
+  /* Put the buffer back into the pool, potentially to be acquired later by another user. Expects
+   * the buffer to be one that was acquired using the same pool. */
+  void release(void *buffer);
+
+  /* Free the available buffers that were not released during the last evaluation, since they are
+   * likely no longer needed. This should be called before the compositor starts evaluating. */
+  void reset();
+
+  /* Returns the maximum total size in bytes of the buffers that were acquired at the same time
+   * since the last reset, that is, the peak memory usage of the current evaluation. */
+  int64_t peak_acquired_size();
+
+ private:
+  /* Add the given buffer to the acquired buffers and update the acquired sizes. Expects the mutex
+   * to be locked. */
+  void add_acquired_buffer(void *buffer, const CPUBufferPoolKey &key);
+
+  /* Free the least recently released available buffers until their total size is within the
+   * memory budget. Expects the mutex to be locked. */
+  void trim_to_budget();
+};
+
+}  // namespace blender::compositor
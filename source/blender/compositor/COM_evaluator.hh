@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
@@ -16,6 +17,8 @@
 #include "COM_context.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_operation_task_graph.hh"
+#include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
 
 namespace blender::compositor {
@@ -45,6 +48,11 @@ using namespace nodes::derived_node_tree_types;
  * the evaluated results of previously compiled operations to compile the operations that follow
  * them in an optimized manner.
  *
+ * On the CPU, operations are not evaluated immediately after they are compiled, but are instead
+ * added to an OperationTaskGraph, which evaluates them concurrently as soon as the operations they
+ * depend on are evaluated. The compiler only waits for the evaluation of operations whose results
+ * it needs to compile the operations that follow, see the CompileState class.
+ *
  * Compilation starts by computing an optimized node execution schedule by calling the
  * compute_schedule function, see the discussion in COM_scheduler.hh for more details. For the node
  * tree shown below, the execution schedule is denoted by the node numbers. The compiler then goes
@@ -108,6 +116,10 @@ class Evaluator {
    * tree is compiled and reset when the evaluator is reset, so it gets reconstructed every time
    * the node tree changes. */
   std::unique_ptr<DerivedNodeTree> derived_node_tree_;
+  /* The node execution schedule of the derived node tree. This is computed when the node tree is
+   * compiled and kept alive until the evaluator is reset, since pixel operations reference it to
+   * compute the regions of their outputs that are needed, which they do in every evaluation. */
+  Schedule schedule_;
   /* The compiled operations stream. This contains ordered pointers to the operations that were
    * compiled. This is initialized when the node tree is compiled and freed when the evaluator
    * resets. The is_compiled_ member indicates whether the operation stream can be used or needs to
@@ -117,6 +129,10 @@ class Evaluator {
   /* True if the node tree is already compiled into an operations stream that can be evaluated
    * directly. False if the node tree is not compiled yet and needs to be compiled. */
   bool is_compiled_ = false;
+  /* The task graph that evaluates the operations concurrently while the node tree is compiled.
+   * This only exists during compilation on the CPU, GPU operations and operations of compiled
+   * node trees are evaluated in the order of the operations stream. */
+  std::unique_ptr<OperationTaskGraph> task_graph_;
 
  public:
   /* Construct an evaluator from a context. */
@@ -169,6 +185,10 @@ class Evaluator {
   void map_pixel_operation_inputs_to_their_results(PixelOperation *operation,
                                                    CompileState &compile_state);
 
+  /* Evaluate the given operation if there is no task graph, otherwise, add it to the task graph
+   * to be evaluated once the given operations that compute its inputs are evaluated. */
+  void evaluate_operation(Operation &operation, Span<Operation *> dependencies);
+
   /* Cancels the evaluation by informing the static cache manager of the cancellation and freeing
    * the results of the operations that were already evaluated, that's because later operations
    * that use the already allocated results will not be evaluated, so they consequently will not
@@ -6,7 +6,9 @@
 
 #include <memory>
 
+#include "BLI_index_mask.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
@@ -64,10 +66,21 @@ class MultiFunctionProcedureOperation : public PixelOperation {
                                   const Schedule &schedule);
 
   /* Calls the multi-function procedure executor on the domain of the operator passing in the
-   * inputs and outputs as parameters. */
+   * inputs and outputs as parameters. Only the pixels of the outputs that are needed by the rest
+   * of the node tree are computed, see compute_needed_region in COM_region_of_interest.hh. */
   void execute() override;
 
  private:
+  /* Computes a mask of the pixels of the domain of the given size that are needed by any of the
+   * outputs of the operation. */
+  IndexMask compute_needed_pixels_mask(int2 size, IndexMaskMemory &memory);
+
+  /* Calls the multi-function procedure executor on contiguous chunks of the pixels of the given
+   * mask, where the inputs and outputs that are stored in half precision are converted to and from
+   * temporary full precision buffers for each chunk, since the procedure only operates on full
+   * precision data. Expects the outputs to be already allocated. */
+  void execute_with_half_storage(const IndexMask &mask);
+
   /* Builds the procedure by going over the nodes in the compile unit, calling their
    * multi-functions and creating any necessary inputs or outputs to the operation/procedure. */
   void build_procedure();
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "BLI_string_ref.hh"
 
 #include "DNA_node_types.h"
@@ -62,7 +64,29 @@ class NodeOperation : public Operation {
    * computed, otherwise returns false. */
   bool should_compute_output(StringRef identifier);
 
+  /* Returns true if the outputs of the operation should be cached across evaluations, such that
+   * the operation need not be executed again if neither its node properties nor its inputs
+   * changed. Since caching involves hashing the inputs and copying the outputs, this should only
+   * be overridden to return true by operations that are expensive to execute, like blurs and
+   * denoising. Operations whose outputs depend on data other than their inputs and node
+   * properties, like scene data, should also override compute_cache_parameters_hash. Defaults to
+   * false. */
+  virtual bool should_cache_outputs();
+
+  /* Returns a hash of the data other than the inputs and node properties that the outputs of the
+   * operation depend on. See should_cache_outputs. Defaults to zero. */
+  virtual uint64_t compute_cache_parameters_hash();
+
  private:
+  /* Reuses the outputs cached in a previous evaluation if the operation caches its outputs and
+   * neither its node properties nor its inputs changed, otherwise, executes the operation and
+   * caches its outputs if needed. See should_cache_outputs. Caching is only done on the CPU. */
+  void compute_results() override;
+
+  /* Computes a hash of the node properties, the contents of the inputs, and the identifiers of the
+   * needed outputs, which identifies the cached outputs along with the node instance key. */
+  uint64_t compute_outputs_cache_hash();
+
   /* Get the result which will be previewed in the node, this is chosen as the first linked output
    * of the node, if no outputs exist, then the first allocated input will be chosen. Nullptr is
    * guaranteed not to be returned, since the node will always either have a linked output or an
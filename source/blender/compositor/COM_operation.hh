@@ -4,16 +4,21 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "BLI_map.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_timeit.hh"
 #include "BLI_vector.hh"
 
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_texture_pool.hh"
 
@@ -83,6 +88,9 @@ class Operation {
   /* True if the input processors were already added and can be evaluated directly. False if the
    * input processors are not yet added and needs to be added. */
   bool input_processors_added_ = false;
+  /* The number of pixels that were actually computed for each of the image results of the
+   * operation, if it only computed some of their pixels. See set_computed_pixels_count. */
+  std::optional<int64_t> computed_pixels_count_;
 
  public:
   Operation(Context &context);
@@ -92,7 +100,7 @@ class Operation {
   /* Evaluate the operation by:
    * 1. Evaluating the input processors.
    * 2. Resetting the results of the operation.
-   * 3. Calling the execute method of the operation.
+   * 3. Computing the results of the operation, typically by calling its execute method.
    * 4. Releasing the results mapped to the inputs. */
   virtual void evaluate();
 
@@ -135,6 +143,11 @@ class Operation {
    * output results. */
   virtual void execute() = 0;
 
+  /* Compute the results of the operation. This method defaults to calling the execute method, but
+   * can be overridden to compute the results differently, for instance, by reusing results that
+   * were computed in previous evaluations. See NodeOperation::compute_results. */
+  virtual void compute_results();
+
   /* Compute and set a preview of the operation if needed. This method defaults to an empty
    * implementation and should be implemented by operations which can have previews. */
   virtual void compute_preview();
@@ -164,6 +177,18 @@ class Operation {
    * operation. */
   virtual void release_inputs();
 
+  /* Calls the evaluate method of the Operation class, and if the context has a profiler, adds a
+   * profile of the evaluation with the given name to it, recording the given nodes as the nodes
+   * that the operation evaluates. Returns the duration of the evaluation. This is meant to be
+   * called by overrides of the evaluate method. See OperationProfile. */
+  timeit::Nanoseconds evaluate_and_profile(StringRef name, Span<nodes::DNode> nodes);
+
+  /* Declares that only the given number of pixels were computed for each of the image results of
+   * the operation, for instance, because only a region of them is needed. This is only used for
+   * profiling and should be called in the execute method. Otherwise, all pixels of the image
+   * results are assumed to be computed. */
+  void set_computed_pixels_count(int64_t pixels_count);
+
   /* Returns a reference to the compositor context. */
   Context &context() const;
 
@@ -184,6 +209,13 @@ class Operation {
    * see the description of Result::allocate_texture() for more information. This is called after
    * the evaluation of the operation. */
   void release_unneeded_results();
+
+  /* Returns a profile of the evaluation of the operation that started and ended at the given
+   * times, where the pixels count and allocated size are computed from the results of the
+   * operation, so this should be called after the operation is evaluated. The name and nodes of
+   * the profile are left for the caller to set. */
+  OperationProfile compute_profile(timeit::TimePoint start_time,
+                                   timeit::TimePoint end_time) const;
 };
 
 }  // namespace blender::compositor
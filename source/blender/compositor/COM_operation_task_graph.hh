@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "BLI_function_ref.hh"
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_utility_mixins.hh"
+#include "BLI_vector.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+
+struct TaskPool;
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Operation Task Graph
+ *
+ * A graph of operations that evaluates each operation on a worker thread as soon as the operations
+ * that compute its inputs are evaluated, such that independent branches of the node tree are
+ * evaluated concurrently. This is used by the evaluator on the CPU, where operations are
+ * otherwise evaluated one after the other and only parallelize over their pixels, which leaves
+ * most threads idle for small images or operations that are serial in nature.
+ *
+ * Operations are added in the order of the schedule as they get compiled, so the graph might
+ * already be evaluating operations while others are still being added. The compiler can wait for
+ * the evaluation of a specific operation if it needs information that is only known after
+ * evaluation, like the domains of the results of the operation. Waiting threads evaluate ready
+ * operations themselves while they wait, so evaluation progresses even if no worker threads are
+ * available.
+ *
+ * Since operations only release their inputs after they are evaluated, and the operations that use
+ * a result only get evaluated after the operation that computes it, the lifetimes of results are
+ * the same as in serial evaluation, though more results might be alive at the same time. */
+class OperationTaskGraph : NonCopyable, NonMovable {
+ private:
+  struct Task {
+    Operation *operation;
+    /* The number of operations that this operation depends on that were not yet evaluated. */
+    int remaining_dependencies_count = 0;
+    /* The tasks of the operations that depend on this operation. */
+    Vector<Task *> dependents;
+    bool is_evaluated = false;
+  };
+
+  /* A reference to the compositor context. */
+  Context &context_;
+  TaskPool *task_pool_;
+  /* Protects all of the members below. */
+  std::mutex mutex_;
+  /* Notified every time an operation finishes evaluating. */
+  std::condition_variable evaluated_condition_;
+  /* The tasks of all operations that were added to the graph. */
+  Map<const Operation *, std::unique_ptr<Task>> tasks_;
+  /* The tasks whose dependencies were evaluated but were not yet started. */
+  Vector<Task *> ready_tasks_;
+  /* The number of tasks that were not yet evaluated. */
+  int unevaluated_tasks_count_ = 0;
+
+ public:
+  OperationTaskGraph(Context &context);
+
+  /* Waits for all operations to be evaluated. */
+  ~OperationTaskGraph();
+
+  /* Adds the given operation to the graph, such that it gets evaluated once all of the given
+   * dependencies are evaluated. Dependencies that were not added to the graph are assumed to be
+   * already evaluated. */
+  void add_operation(Operation &operation, Span<Operation *> dependencies);
+
+  /* Blocks until the given operation is evaluated, evaluating other ready operations in the
+   * meantime. Returns immediately if the operation was not added to the graph. */
+  void wait_for_operation(const Operation &operation);
+
+  /* Blocks until all operations that were added to the graph are evaluated, evaluating ready
+   * operations in the meantime. */
+  void wait();
+
+ private:
+  /* Evaluates the operation of the given task, unless the evaluation was canceled, and marks the
+   * dependents that become ready as a result as such. Expects the mutex to be unlocked. */
+  void evaluate_task(Task &task);
+
+  /* Pushes the given number of worker tasks to the task pool, each of which evaluates one of the
+   * ready tasks if any still exist by the time it runs. */
+  void push_worker_tasks(int count);
+
+  /* Blocks until the given condition is true, evaluating ready tasks in the meantime. Expects the
+   * given lock to lock the mutex. */
+  void wait_until(std::unique_lock<std::mutex> &lock, FunctionRef<bool()> condition);
+
+  /* The function executed by worker tasks, which evaluates one of the ready tasks if any exist. */
+  static void evaluate_ready_task(TaskPool *__restrict pool, void *task_data);
+};
+
+}  // namespace blender::compositor
@@ -105,6 +105,10 @@ class PixelOperation : public Operation {
    * number returned by this method. */
   static int maximum_number_of_outputs(Context &context);
 
+  /* Calls the evaluate method of the operation, but also profiles the evaluation if the context
+   * has a profiler, recording all nodes of the compile unit in the profile. */
+  void evaluate() override;
+
   /* Compute a node preview for all nodes in the pixel operations if the node requires a preview.
    *
    * Previews are computed from results that are populated for outputs that are used to compute
@@ -4,8 +4,15 @@
 
 #pragma once
 
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include "BLI_map.hh"
+#include "BLI_span.hh"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
 
@@ -15,6 +22,36 @@ namespace blender::compositor {
 
 class Context;
 
+/* -------------------------------------------------------------------------------------------------
+ * Operation Profile
+ *
+ * Profiling information about a single evaluation of an operation. Pixel operations evaluate
+ * multiple pixel-wise nodes at once, so the profile stores all nodes that the operation evaluates,
+ * while node operations store their node only. */
+struct OperationProfile {
+  /* A human readable name for the operation, which is the name of the node for node operations. */
+  std::string name;
+  /* The instance keys and names of the nodes evaluated by the operation. */
+  Vector<bNodeInstanceKey> node_instance_keys;
+  Vector<std::string> node_names;
+  /* The times at which the evaluation of the operation started and ended. */
+  timeit::TimePoint start_time;
+  timeit::TimePoint end_time;
+  /* The index of the thread that evaluated the operation. Threads are indexed in the order in
+   * which they first evaluated an operation, see Profiler::add_operation_profile. */
+  int thread_index = 0;
+  /* The total number of pixels computed for the outputs of the operation, where single values
+   * count as a single pixel. */
+  int64_t pixels_count = 0;
+  /* The total size in bytes of the images allocated for the outputs of the operation. */
+  int64_t allocated_size = 0;
+
+  timeit::Nanoseconds duration() const;
+
+  /* Returns the number of computed pixels per second. */
+  double throughput() const;
+};
+
 /* -------------------------------------------------------------------------------------------------
  * Profiler
  *
@@ -25,8 +62,18 @@ class Profiler {
   /* Stores the evaluation time of each node instance keyed by its instance key. Note that
    * pixel-wise nodes like Math nodes will not be measured, that's because they are compiled
    * together with other pixel-wise operations in a single operation, so we can't measure the
-   * evaluation time of each individual node. */
+   * evaluation time of each individual node. Their evaluation is profiled as a whole in the
+   * operation profiles instead. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> nodes_evaluation_times_;
+  /* The profiles of all operations evaluated so far in the order in which they finished. */
+  Vector<OperationProfile> operation_profiles_;
+  /* The identifiers of the threads that evaluated an operation, where the index of a thread is its
+   * index in the vector. The number of threads is small, so a linear search is fast enough. */
+  Vector<std::thread::id> threads_;
+  /* The maximum total size in bytes of the CPU buffers that were in use at the same time. */
+  int64_t peak_memory_usage_ = 0;
+  /* Protects the members above, since operations might be evaluated concurrently. */
+  mutable std::mutex mutex_;
 
  public:
   /* Returns a reference to the nodes evaluation times. */
@@ -35,6 +82,27 @@ class Profiler {
   /* Set the evaluation time of the node identified by the given node instance key. */
   void set_node_evaluation_time(bNodeInstanceKey node_instance_key, timeit::Nanoseconds time);
 
+  /* Returns the profiles of all operations evaluated so far. This should be called after
+   * evaluation. */
+  Span<OperationProfile> get_operation_profiles() const;
+
+  /* Adds the given profile of an operation that was evaluated on the calling thread, setting its
+   * thread index. */
+  void add_operation_profile(OperationProfile profile);
+
+  /* Returns the maximum total size in bytes of the CPU buffers that were in use at the same time
+   * in any of the profiled evaluations. */
+  int64_t get_peak_memory_usage() const;
+
+  /* Updates the peak memory usage given the peak memory usage of an evaluation. */
+  void add_peak_memory_usage(int64_t peak_memory_usage);
+
+  /* Writes the operation profiles to the given file in the Trace Event Format, which can be
+   * viewed in Chrome's about://tracing or in Perfetto. Every operation is a complete event on the
+   * track of its thread whose arguments include the evaluated nodes, the pixels count, the
+   * allocated size, and the throughput. Returns false if the file could not be written. */
+  bool write_chrome_trace(const char *filepath) const;
+
   /* Finalize profiling by computing node group times. This should be called after evaluation. */
   void finalize(const bNodeTree &node_tree);
 
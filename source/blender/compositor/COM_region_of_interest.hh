@@ -0,0 +1,66 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <optional>
+
+#include "BLI_bounds_types.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_scheduler.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* A region of the pixels of a result, where the lower bound is inclusive and the upper bound is
+ * exclusive. No region means that none of the pixels are needed. */
+using Region = std::optional<Bounds<int2>>;
+
+/* ------------------------------------------------------------------------------------------------
+ * Input Region Params
+ *
+ * The parameters of the get_compositor_input_region callback of node types. The callback computes
+ * the region of the input that is needed to compute the needed regions of the outputs of the
+ * node, for instance, a blur node needs the region of its outputs padded by the blur radius, while
+ * a crop node only needs the part of the region of its outputs that is inside the cropping bounds.
+ * The callback is only called for the input that defines the domain of the node, other inputs are
+ * assumed to be entirely needed. */
+class InputRegionParams {
+ private:
+  FunctionRef<Region(int2 output_size)> compute_output_region_;
+
+ public:
+  /* The input whose needed region should be computed. */
+  DInputSocket input;
+  /* The size of the result that the input will receive. */
+  int2 input_size;
+  /* The needed region of the input. This is initialized to the entire input, and callbacks should
+   * set it to a smaller region if possible. */
+  Region input_region;
+
+  InputRegionParams(DInputSocket input,
+                    int2 input_size,
+                    FunctionRef<Region(int2 output_size)> compute_output_region);
+
+  /* Returns the union of the needed regions of all outputs of the node, assuming the outputs have
+   * the given size. */
+  Region compute_output_region(int2 output_size) const;
+};
+
+/* Computes the region of the result of the given output that is needed to compute the final
+ * output of the node tree, assuming the result has the given size. This is the union of the
+ * regions needed by all nodes in the schedule that are linked to the output, where the regions
+ * needed by each node are computed recursively from the needed regions of the outputs of the
+ * node. Nodes are assumed to need the entirety of their inputs unless they are pixel nodes, in
+ * which case, they need the same region of the input that defines their domain as the region of
+ * their outputs, or they define a get_compositor_input_region callback. The returned region is
+ * within the bounds of the result. */
+Region compute_needed_region(const Schedule &schedule, DOutputSocket output, int2 size);
+
+}  // namespace blender::compositor
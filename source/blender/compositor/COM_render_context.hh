@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_task.h"
 
 #include "DNA_scene_types.h"
 
@@ -77,8 +80,52 @@ class FileOutput {
   void add_meta_data(std::string key, std::string value);
 
   /* Save the file to the path along with its meta data, reporting any reports to the standard
-   * output. */
+   * output. This is equivalent to calling add_stamp_meta_data followed by write. */
   void save(Scene *scene);
+
+  /* Add the scene stamp data as well as the added meta data to the internal render result. */
+  void add_stamp_meta_data(Scene *scene);
+
+  /* Write the file to the path, reporting any reports to the standard output. The meta data is
+   * expected to be added already using the add_stamp_meta_data method. */
+  void write(const Scene *scene);
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * File Output Writer
+ *
+ * Writes file outputs asynchronously in a background task pool, such that writing the file outputs
+ * of a frame overlaps with the evaluation of the following frames when rendering animations. The
+ * render pipeline creates a writer for the duration of the animation render and gives it to the
+ * save_file_outputs method of the render context.
+ *
+ * Since the scene changes as the following frames are evaluated, the stamp data is added to the
+ * file outputs when they are scheduled, and a shallow copy of the scene is written along with
+ * every file output, much like what is done for the asynchronous writes of viewport renders. The
+ * number of file outputs that are scheduled and not yet written is limited to bound the memory
+ * they occupy, so scheduling blocks until a file output is written if the limit is reached. */
+class FileOutputWriter {
+ private:
+  TaskPool *task_pool_;
+  /* The number of file outputs that were scheduled and not yet written. */
+  int scheduled_file_outputs_count_ = 0;
+  /* Protects the scheduled file outputs count and notifies when it decreases. */
+  std::mutex mutex_;
+  std::condition_variable condition_;
+
+ public:
+  FileOutputWriter();
+
+  /* Waits for all scheduled file outputs to be written. */
+  ~FileOutputWriter();
+
+  /* Adds the stamp data of the given scene to the given file output and schedules it to be
+   * written in the background, taking ownership of it. */
+  void schedule(std::unique_ptr<FileOutput> file_output, Scene *scene);
+
+ private:
+  /* The task that writes a scheduled file output, see schedule. */
+  static void write_task(TaskPool *__restrict pool, void *task_data);
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -95,6 +142,8 @@ class RenderContext {
    * get_file_output method and saved in the save_file_outputs method. See those methods for more
    * information. */
   Map<std::string, std::unique_ptr<FileOutput>> file_outputs_;
+  /* Protects the file outputs map, since File Output nodes might be evaluated concurrently. */
+  std::mutex file_outputs_mutex_;
 
  public:
   /* Check if there is an available file output with the given path in the context, if one exists,
@@ -115,8 +164,9 @@ class RenderContext {
 
   /* Write the file outputs that were added to the context. The render pipeline code should call
    * this method after all views were evaluated to write the file outputs. See the get_file_output
-   * method for more information. */
-  void save_file_outputs(Scene *scene);
+   * method for more information. If a writer is given, the file outputs are scheduled to be
+   * written asynchronously by the writer instead of being written immediately. */
+  void save_file_outputs(Scene *scene, FileOutputWriter *writer = nullptr);
 };
 
 }  // namespace blender::compositor
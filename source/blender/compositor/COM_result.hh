@@ -8,6 +8,7 @@
 
 #include "BLI_assert.h"
 #include "BLI_math_base.hh"
+#include "BLI_math_half.hh"
 #include "BLI_math_interp.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector.h"
@@ -45,7 +46,8 @@ enum class ResultType : uint8_t {
   Int2,
 };
 
-/* The precision of the data. CPU data is always stored using full precision at the moment. */
+/* The precision of the data. On the CPU, only color images are stored using half precision, while
+ * other data is always stored using full precision, see ResultStorageType::HalfCPU. */
 enum class ResultPrecision : uint8_t {
   Full,
   Half,
@@ -59,6 +61,12 @@ enum class ResultStorageType : uint8_t {
   FloatCPU,
   /* Stored as a contiguous integer buffer the CPU. */
   IntegerCPU,
+  /* Stored as a contiguous half float buffer on the CPU. Used for color images of half precision
+   * that are allocated from the CPU buffer pool, see Result::should_use_half_storage. Pixels are
+   * converted to and from full precision as they are loaded and stored, so operations still
+   * compute in full precision, while the memory and bandwidth needed by intermediate images is
+   * halved. */
+  HalfCPU,
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -119,13 +127,15 @@ class Result {
     GPUTexture *gpu_texture_ = nullptr;
     float *float_texture_;
     int *integer_texture_;
+    uint16_t *half_texture_;
   };
   /* The number of operations that currently needs this result. At the time when the result is
    * computed, this member will have a value that matches initial_reference_count_. Once each
    * operation that needs the result no longer needs it, the release method is called and the
    * reference count is decremented, until it reaches zero, where the result's texture is then
    * released. If this result have a master result, then this reference count is irrelevant and
-   * shadowed by the reference count of the master result. */
+   * shadowed by the reference count of the master result. Operations that use the same result
+   * might be evaluated concurrently, so the reference count is modified atomically. */
   int reference_count_ = 1;
   /* The number of operations that reference and use this result at the time when it was initially
    * computed. Since reference_count_ is decremented and always becomes zero at the end of the
@@ -159,9 +169,9 @@ class Result {
    * result. This is set up by a call to the wrap_external method. In that case, when the reference
    * count eventually reach zero, the texture will not be freed. */
   bool is_external_ = false;
-  /* If true, the GPU texture that holds the data was allocated from the texture pool of the
-   * context and should be released back into the pool instead of being freed. For CPU storage,
-   * this is irrelevant. */
+  /* If true, the GPU texture or CPU buffer that holds the data was allocated from the texture pool
+   * or CPU buffer pool of the context and should be released back into the pool instead of being
+   * freed. */
   bool is_from_pool_ = false;
 
  public:
@@ -205,11 +215,11 @@ class Result {
   /* Declare the result to be a texture result, allocate a texture of an appropriate type with
    * the size of the given domain, and set the domain of the result to the given domain.
    *
-   * If from_pool is true, the texture will be allocated from the texture pool of the context,
-   * otherwise, a new texture will be allocated. Pooling should not be used for persistent
-   * results that might span more than one evaluation, like cached resources. While pooling should
-   * be used for most other cases where the result will be allocated then later released in the
-   * same evaluation.
+   * If from_pool is true, the texture will be allocated from the texture pool or the CPU buffer
+   * pool of the context, otherwise, a new texture will be allocated. Pooling should not be used
+   * for persistent results that might span more than one evaluation, like cached resources. While
+   * pooling should be used for most other cases where the result will be allocated then later
+   * released in the same evaluation.
    *
    * If the context of the result uses GPU, then GPU allocation will be done, otherwise, CPU
    * allocation will be done.
@@ -354,20 +364,33 @@ class Result {
    * reference count of the master result is returned instead. */
   int reference_count() const;
 
+  /* Returns the type of storage used to hold the data of the result. */
+  ResultStorageType storage_type() const;
+
   /* Returns a reference to the domain of the result. See the Domain class. */
   const Domain &domain() const;
 
   /* Computes the number of channels of the result based on its type. */
   int64_t channels_count() const;
 
+  /* Returns the size in bytes of the image data allocated for the result, which is zero for single
+   * values, unallocated results, as well as external and proxy results, since they do not own
+   * their data. For GPU textures, the size is estimated from the channels count and precision,
+   * since the driver might pad the actual storage. */
+  int64_t allocated_size_in_bytes() const;
+
   /* Returns a reference to the allocate float data. */
   float *float_texture() const;
 
   /* Returns a reference to the allocate integer data. */
   int *integer_texture() const;
 
+  /* Returns a reference to the allocated half float data. Each element is the bit pattern of a
+   * half float, see BLI_math_half.hh for conversion functions. */
+  uint16_t *half_texture() const;
+
   /* Returns a reference to the allocated CPU data. The returned data is untyped, use the
-   * float_texture() or the integer_texture() methods for typed data. */
+   * float_texture(), integer_texture(), or half_texture() methods for typed data. */
   void *data() const;
 
   /* Gets the single value stored in the result. Assumes the result stores a value of the given
@@ -459,6 +482,11 @@ class Result {
   /* Return true if the provided template type is supported by the class. */
   template<typename T> static constexpr bool is_supported_type();
 
+  /* Returns true if the CPU data of the result should be stored in half precision, see
+   * ResultStorageType::HalfCPU. See the allocate_texture method for information about the
+   * from_pool argument. */
+  bool should_use_half_storage(bool from_pool) const;
+
   /* Allocates the texture data for the given size, either on the GPU or CPU based on the result's
    * context. See the allocate_texture method for information about the from_pool argument. */
   void allocate_data(int2 size, bool from_pool);
@@ -482,6 +510,27 @@ class Result {
   /* Get a pointer to the integer pixel at the given texel position. */
   int *get_integer_pixel(const int2 &texel) const;
 
+  /* Loads the half float pixel at the given texel position and converts it to full precision.
+   * Assumes the result is stored in half precision. */
+  float4 load_half_pixel(const int2 &texel) const;
+
+  /* Converts the given pixel value to half precision and stores it in the pixel at the given
+   * texel position. Assumes the result is stored in half precision. */
+  void store_half_pixel(const int2 &texel, const float4 &pixel_value);
+
+  /* Fallbacks of the sampling methods for results stored in half precision, since the BLI
+   * interpolation functions only support float buffers. The coordinates are in texel space, and
+   * the wrap modes and interpolation weights match those of the BLI interpolation functions. */
+  float4 sample_half_nearest(const float2 &texel_coordinates,
+                             math::InterpWrapMode wrap_x,
+                             math::InterpWrapMode wrap_y) const;
+  float4 sample_half_bilinear(const float2 &texel_coordinates,
+                              math::InterpWrapMode wrap_x,
+                              math::InterpWrapMode wrap_y) const;
+  float4 sample_half_cubic_bspline(const float2 &texel_coordinates,
+                                   math::InterpWrapMode wrap_x,
+                                   math::InterpWrapMode wrap_y) const;
+
   /* Copy the float pixel from the source pointer to the target pointer, assuming the given
    * channels count. */
   static void copy_pixel(float *target, const float *source, const int channels_count);
@@ -533,6 +582,12 @@ inline int *Result::integer_texture() const
   return integer_texture_;
 }
 
+inline uint16_t *Result::half_texture() const
+{
+  BLI_assert(storage_type_ == ResultStorageType::HalfCPU);
+  return half_texture_;
+}
+
 inline void *Result::data() const
 {
   switch (storage_type_) {
@@ -540,6 +595,8 @@ inline void *Result::data() const
       return this->float_texture();
     case ResultStorageType::IntegerCPU:
       return this->integer_texture();
+    case ResultStorageType::HalfCPU:
+      return this->half_texture();
     case ResultStorageType::GPU:
       break;
   }
@@ -660,6 +717,10 @@ template<typename T> inline void Result::set_single_value(const T &value)
         }
       }
       break;
+    case ResultStorageType::HalfCPU:
+      /* Single values are always stored using full precision. */
+      BLI_assert_unreachable();
+      break;
   }
 }
 
@@ -674,6 +735,12 @@ template<typename T, bool CouldBeSingleValue> inline T Result::load_pixel(const
     BLI_assert(!this->is_single_value());
   }
 
+  if constexpr (std::is_same_v<T, float4>) {
+    if (storage_type_ == ResultStorageType::HalfCPU) {
+      return this->load_half_pixel(texel);
+    }
+  }
+
   if constexpr (std::is_scalar_v<T>) {
     return *this->get_pixel<T>(texel);
   }
@@ -695,6 +762,12 @@ inline T Result::load_pixel_extended(const int2 &texel) const
   }
 
   const int2 clamped_texel = math::clamp(texel, int2(0), domain_.size - int2(1));
+  if constexpr (std::is_same_v<T, float4>) {
+    if (storage_type_ == ResultStorageType::HalfCPU) {
+      return this->load_half_pixel(clamped_texel);
+    }
+  }
+
   if constexpr (std::is_scalar_v<T>) {
     return *this->get_pixel<T>(clamped_texel);
   }
@@ -719,6 +792,12 @@ inline T Result::load_pixel_fallback(const int2 &texel, const T &fallback) const
     return fallback;
   }
 
+  if constexpr (std::is_same_v<T, float4>) {
+    if (storage_type_ == ResultStorageType::HalfCPU) {
+      return this->load_half_pixel(texel);
+    }
+  }
+
   if constexpr (std::is_scalar_v<T>) {
     return *this->get_pixel<T>(texel);
   }
@@ -739,6 +818,9 @@ inline float4 Result::load_pixel_generic_type(const int2 &texel) const
   if (is_single_value_) {
     this->copy_pixel(pixel_value, float_texture_);
   }
+  else if (storage_type_ == ResultStorageType::HalfCPU) {
+    pixel_value = this->load_half_pixel(texel);
+  }
   else {
     this->copy_pixel(pixel_value, this->get_float_pixel(texel));
   }
@@ -747,6 +829,13 @@ inline float4 Result::load_pixel_generic_type(const int2 &texel) const
 
 template<typename T> inline void Result::store_pixel(const int2 &texel, const T &pixel_value)
 {
+  if constexpr (std::is_same_v<T, float4>) {
+    if (storage_type_ == ResultStorageType::HalfCPU) {
+      this->store_half_pixel(texel, pixel_value);
+      return;
+    }
+  }
+
   if constexpr (std::is_scalar_v<T>) {
     *this->get_pixel<T>(texel) = pixel_value;
   }
@@ -758,6 +847,11 @@ template<typename T> inline void Result::store_pixel(const int2 &texel, const T
 
 inline void Result::store_pixel_generic_type(const int2 &texel, const float4 &pixel_value)
 {
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    this->store_half_pixel(texel, pixel_value);
+    return;
+  }
+
   this->copy_pixel(this->get_float_pixel(texel), pixel_value);
 }
 
@@ -772,6 +866,10 @@ inline float4 Result::sample_nearest_zero(const float2 &coordinates) const
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->load_pixel_zero<float4>(int2(texel_coordinates));
+  }
+
   math::interpolate_nearest_border_fl(this->float_texture(),
                                       pixel_value,
                                       size.x,
@@ -795,6 +893,13 @@ inline float4 Result::sample_nearest_wrap(const float2 &coordinates,
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->sample_half_nearest(
+        texel_coordinates,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   math::interpolate_nearest_wrapmode_fl(
       this->float_texture(),
       pixel_value,
@@ -821,6 +926,13 @@ inline float4 Result::sample_bilinear_wrap(const float2 &coordinates,
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->sample_half_bilinear(
+        texel_coordinates,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   math::interpolate_bilinear_wrapmode_fl(
       this->float_texture(),
       pixel_value,
@@ -845,6 +957,13 @@ inline float4 Result::sample_cubic_wrap(const float2 &coordinates, bool wrap_x,
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->sample_half_cubic_bspline(
+        texel_coordinates,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   math::interpolate_cubic_bspline_wrapmode_fl(
       this->float_texture(),
       pixel_value,
@@ -869,6 +988,11 @@ inline float4 Result::sample_bilinear_zero(const float2 &coordinates) const
   const int2 size = domain_.size;
   const float2 texel_coordinates = (coordinates * float2(size)) - 0.5f;
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->sample_half_bilinear(
+        texel_coordinates, math::InterpWrapMode::Border, math::InterpWrapMode::Border);
+  }
+
   math::interpolate_bilinear_border_fl(this->float_texture(),
                                        pixel_value,
                                        size.x,
@@ -890,6 +1014,10 @@ inline float4 Result::sample_nearest_extended(const float2 &coordinates) const
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->load_pixel_extended<float4>(int2(texel_coordinates));
+  }
+
   math::interpolate_nearest_fl(this->float_texture(),
                                pixel_value,
                                size.x,
@@ -911,6 +1039,11 @@ inline float4 Result::sample_bilinear_extended(const float2 &coordinates) const
   const int2 size = domain_.size;
   const float2 texel_coordinates = (coordinates * float2(size)) - 0.5f;
 
+  if (storage_type_ == ResultStorageType::HalfCPU) {
+    return this->sample_half_bilinear(
+        texel_coordinates, math::InterpWrapMode::Extend, math::InterpWrapMode::Extend);
+  }
+
   math::interpolate_bilinear_fl(this->float_texture(),
                                 pixel_value,
                                 size.x,
@@ -1065,6 +1198,20 @@ inline int *Result::get_integer_pixel(const int2 &texel) const
   return integer_texture_ + this->get_pixel_index(texel);
 }
 
+inline float4 Result::load_half_pixel(const int2 &texel) const
+{
+  BLI_assert(storage_type_ == ResultStorageType::HalfCPU);
+  float4 pixel_value;
+  math::half_to_float_array(half_texture_ + this->get_pixel_index<float4>(texel), pixel_value, 4);
+  return pixel_value;
+}
+
+inline void Result::store_half_pixel(const int2 &texel, const float4 &pixel_value)
+{
+  BLI_assert(storage_type_ == ResultStorageType::HalfCPU);
+  math::float_to_half_array(pixel_value, half_texture_ + this->get_pixel_index<float4>(texel), 4);
+}
+
 inline void Result::copy_pixel(float *target, const float *source, const int channels_count)
 {
   switch (channels_count) {
@@ -7,8 +7,10 @@
 #include "COM_bokeh_kernel.hh"
 #include "COM_cached_image.hh"
 #include "COM_cached_mask.hh"
+#include "COM_cached_node_outputs.hh"
 #include "COM_cached_shader.hh"
 #include "COM_cached_texture.hh"
+#include "COM_convolution_kernel_spectrum.hh"
 #include "COM_deriche_gaussian_coefficients.hh"
 #include "COM_distortion_grid.hh"
 #include "COM_fog_glow_kernel.hh"
@@ -63,6 +65,8 @@ class StaticCacheManager {
   DericheGaussianCoefficientsContainer deriche_gaussian_coefficients;
   VanVlietGaussianCoefficientsContainer van_vliet_gaussian_coefficients;
   FogGlowKernelContainer fog_glow_kernels;
+  ConvolutionKernelSpectrumContainer convolution_kernel_spectra;
+  CachedNodeOutputsContainer cached_node_outputs;
 
  private:
   /* The cache manager should skip the next reset. See the skip_next_reset() method for more
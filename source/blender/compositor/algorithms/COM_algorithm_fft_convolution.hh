@@ -0,0 +1,39 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_math_vector_types.hh"
+
+#include "COM_context.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+/* Returns true if convolving an image with a kernel of the given size is expected to be faster
+ * using the fft_convolution function than using a direct convolution. The cost of direct
+ * convolution is quadratic in the kernel radius, while the cost of FFT convolution is nearly
+ * independent of it, so this is true for large kernels. Always returns false if the compositor was
+ * built without FFTW or if the context uses the GPU. */
+bool should_use_fft_convolution(const Context &context, int2 kernel_size);
+
+/* Convolves the given color input with the given color kernel on the CPU in the frequency domain,
+ * writing the result to the given output, which will be allocated internally and is thus expected
+ * not to be previously allocated. The kernel size is expected to be odd, and each output pixel is
+ * the sum of the input pixels around it weighted by the kernel pixels at the same offset from the
+ * center of the kernel, normalized by the sum of the kernel, which is what the direct
+ * convolutions in the compositor compute. The frequency domain representation of the kernel is
+ * cached across evaluations.
+ *
+ * If extend_bounds is true, the output will have an extra kernel radius amount of pixels on the
+ * boundary of the image, where convolution can take place assuming a fully transparent out of
+ * bound values. Otherwise, out of bound values are assumed to be equal to the closest boundary
+ * pixel. */
+void fft_convolution(Context &context,
+                     const Result &input,
+                     const Result &kernel,
+                     Result &output,
+                     bool extend_bounds = false);
+
+}  // namespace blender::compositor
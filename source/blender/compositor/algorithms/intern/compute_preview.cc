@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <mutex>
+
 #include "BLI_index_range.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector.hh"
@@ -123,17 +125,24 @@ static int2 compute_preview_size(int2 size)
 
 void compute_preview(Context &context, const DNode &node, const Result &input_result)
 {
-  /* Initialize node tree previews if not already initialized. */
-  bNodeTree *root_tree = const_cast<bNodeTree *>(
-      &node.context()->derived_tree().root_context().btree());
-  if (!root_tree->previews) {
-    root_tree->previews = bke::node_instance_hash_new("node previews");
-  }
-
   const int2 preview_size = compute_preview_size(input_result.domain().size);
 
-  bNodePreview *preview = bke::node_preview_verify(
-      root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+  bNodePreview *preview;
+  {
+    /* The previews of nodes that are evaluated concurrently are stored in the same hash. */
+    static std::mutex mutex;
+    std::scoped_lock lock(mutex);
+
+    /* Initialize node tree previews if not already initialized. */
+    bNodeTree *root_tree = const_cast<bNodeTree *>(
+        &node.context()->derived_tree().root_context().btree());
+    if (!root_tree->previews) {
+      root_tree->previews = bke::node_instance_hash_new("node previews");
+    }
+
+    preview = bke::node_preview_verify(
+        root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+  }
 
   if (context.use_gpu()) {
     compute_preview_gpu(context, input_result, preview);
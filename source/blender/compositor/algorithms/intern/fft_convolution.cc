@@ -0,0 +1,223 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <complex>
+#include <cstdint>
+
+#if defined(WITH_FFTW3)
+#  include <fftw3.h>
+#endif
+
+#include "BLI_array.hh"
+#include "BLI_assert.h"
+#include "BLI_fftw.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "COM_context.hh"
+#include "COM_result.hh"
+#include "COM_utilities.hh"
+
+#include "COM_algorithm_fft_convolution.hh"
+
+#include "COM_convolution_kernel_spectrum.hh"
+
+namespace blender::compositor {
+
+/* The smallest kernel radius for which FFT convolution is used. Direct convolution does a multiply
+ * add for every kernel pixel for every image pixel, while FFT convolution does a roughly constant
+ * amount of work per image pixel that is much larger than a single multiply add, so only kernels
+ * with thousands of pixels benefit from it. */
+static constexpr int fft_convolution_minimum_radius = 16;
+
+bool should_use_fft_convolution(const Context &context, int2 kernel_size)
+{
+#if defined(WITH_FFTW3)
+  return !context.use_gpu() && math::reduce_min(kernel_size / 2) >= fft_convolution_minimum_radius;
+#else
+  UNUSED_VARS(context, kernel_size);
+  return false;
+#endif
+}
+
+/* Computes the size of the transforms used to convolve the tiles of the image. Tiles are
+ * transformed along with the kernel size minus one pixels of their neighborhood, so a transform
+ * of twice the kernel size wastes at most half of the transform on the neighborhood, which is a
+ * good compromise between the number of tiles and the memory needed to transform them. But there
+ * is no need for transforms that are larger than the image with its neighborhood. */
+[[maybe_unused]] static int2 compute_transform_size(const int2 kernel_size, const int2 image_size)
+{
+  const int2 needed_size = math::min(kernel_size * 2, image_size + kernel_size - 1);
+  return fftw::optimal_size_for_real_transform(needed_size);
+}
+
+void fft_convolution(Context &context,
+                     const Result &input,
+                     const Result &kernel,
+                     Result &output,
+                     const bool extend_bounds)
+{
+  BLI_assert(!context.use_gpu());
+
+  const int2 kernel_size = kernel.domain().size;
+  const int2 kernel_radius = kernel_size / 2;
+
+  Domain domain = input.domain();
+  if (extend_bounds) {
+    /* Add a radius amount of pixels in both sides of the image, hence the multiply by 2. */
+    domain.size += kernel_radius * 2;
+  }
+  output.allocate_texture(domain);
+
+#if defined(WITH_FFTW3)
+  fftw::initialize_float();
+
+  /* The image is convolved in tiles using the overlap-save method, where each tile is transformed
+   * along with the neighborhood of pixels that the kernel reaches, and only the pixels of the tile
+   * are kept after the inverse transform, since the circular convolution only wraps around into
+   * the neighborhood. Unlike the overlap-add method, the output tiles do not overlap, so they can
+   * be convolved in parallel without synchronization, and out of bound pixels are handled while
+   * loading the neighborhood. */
+  const int2 transform_size = compute_transform_size(kernel_size, domain.size);
+  const int2 tile_size = transform_size - kernel_size + 1;
+  const int2 tiles_count = math::divide_ceil(domain.size, tile_size);
+
+  /* The FFTW real to complex transforms utilizes the hermitian symmetry of real transforms and
+   * stores only half the output since the other half is redundant, so we only allocate half of
+   * the first dimension. See Section 4.3.4 Real-data DFT Array Format in the FFTW manual for
+   * more information. */
+  const int2 frequency_size = int2(transform_size.x / 2 + 1, transform_size.y);
+  const int64_t spatial_pixels_count = int64_t(transform_size.x) * transform_size.y;
+  const int64_t frequency_pixels_count = int64_t(frequency_size.x) * frequency_size.y;
+
+  /* Load the kernel into a full precision buffer, since it might be stored in half precision. */
+  Array<float4> kernel_weights(int64_t(kernel_size.x) * kernel_size.y);
+  parallel_for(kernel_size, [&](const int2 texel) {
+    kernel_weights[int64_t(texel.y) * kernel_size.x + texel.x] = kernel.load_pixel<float4>(texel);
+  });
+
+  const ConvolutionKernelSpectrum &kernel_spectrum =
+      context.cache_manager().convolution_kernel_spectra.get(
+          kernel_weights, kernel_size, transform_size);
+
+  /* The FFT is not normalized, meaning the result of the FFT followed by an inverse FFT will
+   * result in an image that is scaled by a factor of the product of the width and height, so we
+   * take that into account by dividing by that scale along with the sum of the kernel. See Section
+   * 4.8.6 Multi-dimensional Transforms of the FFTW manual for more information. */
+  const float4 normalization_scale = math::safe_divide(
+      float4(1.0f), kernel_spectrum.normalization_factor() * float(spatial_pixels_count));
+
+  /* Create the plans once and execute them on the buffers of every tile, which is allowed since
+   * buffers allocated by FFTW all have the same alignment. */
+  float *plan_spatial_domain = fftwf_alloc_real(spatial_pixels_count);
+  fftwf_complex *plan_frequency_domain = fftwf_alloc_complex(frequency_pixels_count);
+  fftwf_plan forward_plan = fftwf_plan_dft_r2c_2d(transform_size.y,
+                                                  transform_size.x,
+                                                  plan_spatial_domain,
+                                                  plan_frequency_domain,
+                                                  FFTW_ESTIMATE);
+  fftwf_plan backward_plan = fftwf_plan_dft_c2r_2d(transform_size.y,
+                                                   transform_size.x,
+                                                   plan_frequency_domain,
+                                                   plan_spatial_domain,
+                                                   FFTW_ESTIMATE);
+
+  /* Loads the input color of the pixel at the given texel. If bounds are extended, then the input
+   * is treated as padded by a kernel radius amount of pixels of zero color, and the given texel is
+   * assumed to be in the space of the image after padding. */
+  auto load_input = [&](const int2 texel) {
+    if (extend_bounds) {
+      return input.load_pixel_zero<float4>(texel - kernel_radius);
+    }
+    return input.load_pixel_extended<float4>(texel);
+  };
+
+  const int channels_count = 4;
+
+  threading::parallel_for(
+      IndexRange(int64_t(tiles_count.x) * tiles_count.y), 1, [&](const IndexRange sub_range) {
+        /* Tiles are transformed one channel at a time to limit the memory used by each thread. */
+        float *spatial_domain = fftwf_alloc_real(spatial_pixels_count);
+        std::complex<float> *frequency_domain = reinterpret_cast<std::complex<float> *>(
+            fftwf_alloc_complex(frequency_pixels_count));
+
+        for (const int64_t tile_index : sub_range) {
+          const int2 tile = int2(tile_index % tiles_count.x, tile_index / tiles_count.x);
+          const int2 tile_lower_bound = tile * tile_size;
+          const int2 tile_upper_bound = math::min(tile_lower_bound + tile_size, domain.size);
+          const int2 tile_neighborhood_size = tile_upper_bound - tile_lower_bound +
+                                              kernel_size - 1;
+
+          for (const int channel : IndexRange(channels_count)) {
+            /* Load the tile and its neighborhood and zero pad it to the transform size. */
+            for (const int64_t y : IndexRange(transform_size.y)) {
+              for (const int64_t x : IndexRange(transform_size.x)) {
+                const bool is_inside_neighborhood = x < tile_neighborhood_size.x &&
+                                                    y < tile_neighborhood_size.y;
+                const int2 texel = tile_lower_bound - kernel_radius + int2(x, y);
+                spatial_domain[y * transform_size.x + x] =
+                    is_inside_neighborhood ? load_input(texel)[channel] : 0.0f;
+              }
+            }
+
+            fftwf_execute_dft_r2c(forward_plan,
+                                  spatial_domain,
+                                  reinterpret_cast<fftwf_complex *>(frequency_domain));
+
+            /* Multiply the kernel and the tile in the frequency domain to perform the
+             * convolution. */
+            const std::complex<float> *kernel_frequencies = kernel_spectrum.frequencies(channel);
+            for (const int64_t i : IndexRange(frequency_pixels_count)) {
+              frequency_domain[i] *= kernel_frequencies[i] * normalization_scale[channel];
+            }
+
+            fftwf_execute_dft_c2r(backward_plan,
+                                  reinterpret_cast<fftwf_complex *>(frequency_domain),
+                                  spatial_domain);
+
+            /* Write the channel of the pixels of the tile, skipping the neighborhood. The pixels
+             * are loaded and stored as a whole, since the output might be stored in half
+             * precision. */
+            for (const int64_t y :
+                 IndexRange::from_begin_end(tile_lower_bound.y, tile_upper_bound.y))
+            {
+              for (const int64_t x :
+                   IndexRange::from_begin_end(tile_lower_bound.x, tile_upper_bound.x))
+              {
+                const int2 texel = int2(x, y);
+                const int2 tile_texel = texel - tile_lower_bound + kernel_radius;
+                float4 pixel = channel == 0 ? float4(0.0f) : output.load_pixel<float4>(texel);
+                pixel[channel] =
+                    spatial_domain[int64_t(tile_texel.y) * transform_size.x + tile_texel.x];
+                output.store_pixel(texel, pixel);
+              }
+            }
+          }
+        }
+
+        fftwf_free(spatial_domain);
+        fftwf_free(frequency_domain);
+      });
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_destroy_plan(backward_plan);
+  fftwf_free(plan_spatial_domain);
+  fftwf_free(plan_frequency_domain);
+#else
+  /* Unreachable since should_use_fft_convolution returns false, but pass the input through to
+   * produce a valid output nonetheless. */
+  BLI_assert_unreachable();
+  UNUSED_VARS(kernel);
+  parallel_for(domain.size, [&](const int2 texel) {
+    output.store_pixel(texel, input.load_pixel_extended<float4>(texel));
+  });
+#endif
+}
+
+}  // namespace blender::compositor
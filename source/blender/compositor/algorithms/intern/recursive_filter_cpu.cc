@@ -0,0 +1,62 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+
+#include "COM_result.hh"
+
+#include "recursive_filter_cpu.hh"
+
+namespace blender::compositor {
+
+void recursive_filter_blur_pass_cpu(
+    const Result &input,
+    Result &output,
+    FunctionRef<void(Span<float4> block_input, int rows_count, MutableSpan<float4> block_output)>
+        filter_block_fn)
+{
+  constexpr int block_size = recursive_filter_rows_block_size;
+
+  const int2 size = input.domain().size;
+  output.allocate_texture(int2(size.y, size.x));
+
+  const int blocks_count = (size.y + block_size - 1) / block_size;
+  threading::parallel_for(IndexRange(blocks_count), 1, [&](const IndexRange sub_range) {
+    Array<float4> block_input(int64_t(size.x) * block_size);
+    Array<float4> block_output(int64_t(size.x) * block_size);
+
+    for (const int64_t block : sub_range) {
+      const int block_start = block * block_size;
+      const int rows_count = math::min(block_size, size.y - block_start);
+
+      /* Load the rows of the block once, such that the pixels are loaded and converted once as
+       * opposed to once per filter. */
+      for (const int r : IndexRange(rows_count)) {
+        for (const int x : IndexRange(size.x)) {
+          block_input[int64_t(x) * block_size + r] = input.load_pixel<float4>(
+              int2(x, block_start + r));
+        }
+      }
+
+      block_output.fill(float4(0.0f));
+      filter_block_fn(block_input, rows_count, block_output);
+
+      /* Write the colors using the transposed texels, where the pixels of the rows of the block
+       * at the same column are contiguous in both the interleaved buffer and the output. */
+      for (const int x : IndexRange(size.x)) {
+        for (const int r : IndexRange(rows_count)) {
+          output.store_pixel(int2(block_start + r, x), block_output[int64_t(x) * block_size + r]);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+#include "COM_result.hh"
+
+/* CPU implementation details that are shared by the recursive Gaussian blurs, that is, the
+ * Deriche and Van Vliet filters. */
+
+namespace blender::compositor {
+
+/* The number of rows that are filtered together on the CPU, see recursive_filter_blur_pass_cpu. */
+inline constexpr int recursive_filter_rows_block_size = 16;
+
+/* Applies the causal or non causal filter of the given order with the given coefficients to the
+ * rows of the given block and adds the filter outputs to the given block output. The pixels of
+ * the rows of the block are interleaved, that is, the pixel at column x of row r is stored at
+ * index x * recursive_filter_rows_block_size + r, such that all rows advance together through
+ * contiguous memory. The recurrence of each row is inherently serial, but the recurrences of the
+ * different rows are independent, so interleaving them allows the processor to overlap their
+ * computations, while the four channels of each pixel are computed together using SIMD
+ * instructions. */
+template<int Order, bool IsCausal>
+inline void recursive_filter_block(const Span<float4> block_input,
+                                   const int rows_count,
+                                   const int width,
+                                   const VecBase<float, Order> &feedforward_coefficients,
+                                   const VecBase<float, Order> &feedback_coefficients,
+                                   const float boundary_coefficient,
+                                   MutableSpan<float4> block_output)
+{
+  constexpr int block_size = recursive_filter_rows_block_size;
+
+  /* Arrays that hold the last Order inputs and outputs of every row along with the current ones,
+   * where the current ones are at index 0 and the oldest ones are at index Order. We assume
+   * Neumann boundary condition, so we initialize all inputs by the boundary pixel and all outputs
+   * by the boundary pixel multiplied by the boundary coefficient. See the
+   * DericheGaussianCoefficients and VanVlietGaussianCoefficients classes for more information on
+   * the boundary handing. */
+  float4 inputs[block_size][Order + 1];
+  float4 outputs[block_size][Order + 1];
+  const int64_t boundary_x = IsCausal ? 0 : width - 1;
+  for (const int r : IndexRange(rows_count)) {
+    const float4 input_boundary = block_input[boundary_x * block_size + r];
+    const float4 output_boundary = input_boundary * boundary_coefficient;
+    for (const int i : IndexRange(Order + 1)) {
+      inputs[r][i] = input_boundary;
+      outputs[r][i] = output_boundary;
+    }
+  }
+
+  for (const int i : IndexRange(width)) {
+    /* Run forward across rows for the causal filter and backward for the non causal filter. */
+    const int64_t x = IsCausal ? i : width - 1 - i;
+    const float4 *column_input = block_input.data() + x * block_size;
+    float4 *column_output = block_output.data() + x * block_size;
+
+    for (const int r : IndexRange(rows_count)) {
+      inputs[r][0] = column_input[r];
+
+      /* Compute Equation (28) for the causal filter or Equation (29) for the non causal filter
+       * in Deriche's paper, which the second order filters of Van Vliet's design follow as well.
+       * The only difference is that the non causal filter ignores the current value and starts
+       * from the previous input, as can be seen in the subscript of the first input term in both
+       * equations. So add one while indexing the non causal inputs. */
+      outputs[r][0] = float4(0.0f);
+      const int first_input_index = IsCausal ? 0 : 1;
+      for (int j = 0; j < Order; j++) {
+        outputs[r][0] += feedforward_coefficients[j] * inputs[r][first_input_index + j];
+        outputs[r][0] -= feedback_coefficients[j] * outputs[r][j + 1];
+      }
+
+      /* The filters are parallel interconnection filters, meaning their output is the sum of all
+       * of their causal and non causal filters. */
+      column_output[r] += outputs[r][0];
+
+      /* Shift the inputs and outputs temporally by one. The oldest ones are discarded, while the
+       * current ones will retain their values but will be overwritten with the new current values
+       * in the next iteration. */
+      for (int j = Order; j >= 1; j--) {
+        inputs[r][j] = inputs[r][j - 1];
+        outputs[r][j] = outputs[r][j - 1];
+      }
+    }
+  }
+}
+
+/* Blurs the input horizontally by calling the given function on blocks of
+ * recursive_filter_rows_block_size rows, which are loaded into an interleaved buffer, see
+ * recursive_filter_block. The function is expected to add the outputs of all of the causal and
+ * non causal filters to the zero initialized block output. The output is allocated and written
+ * transposed, that is, with a height equivalent to the width of the input and vice versa, which
+ * writes runs of contiguous pixels to each row of the output. */
+void recursive_filter_blur_pass_cpu(
+    const Result &input,
+    Result &output,
+    FunctionRef<void(Span<float4> block_input, int rows_count, MutableSpan<float4> block_output)>
+        filter_block_fn);
+
+}  // namespace blender::compositor
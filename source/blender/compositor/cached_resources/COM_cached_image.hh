@@ -9,6 +9,7 @@
 #include <string>
 
 #include "BLI_map.hh"
+#include "BLI_task.h"
 
 #include "GPU_texture.hh"
 
@@ -19,6 +20,8 @@
 #include "COM_cached_resource.hh"
 #include "COM_result.hh"
 
+struct ImBuf;
+
 namespace blender::compositor {
 
 class Context;
@@ -53,7 +56,14 @@ class CachedImage : public CachedResource {
   GPUTexture *texture_ = nullptr;
 
  public:
-  CachedImage(Context &context, Image *image, ImageUser *image_user, const char *pass_name);
+  /* Computes the result from the given image buffer if it is not null, which is the case for
+   * images that were read ahead, see CachedImageContainer. Otherwise, the image buffer is acquired
+   * from the image. */
+  CachedImage(Context &context,
+              Image *image,
+              ImageUser *image_user,
+              const char *pass_name,
+              ImBuf *image_buffer = nullptr);
 
   ~CachedImage();
 
@@ -64,12 +74,43 @@ class CachedImage : public CachedResource {
 
 /* ------------------------------------------------------------------------------------------------
  * Cached Image Container.
- */
+ *
+ * If the context should read ahead, see Context::should_read_ahead, the image buffers of image
+ * sequences are read for the next frame in a background task pool as soon as they are retrieved
+ * for the current frame, such that reading and decoding the files of the next frame overlaps with
+ * the evaluation of the current frame. Read ahead image buffers are then used to create the cached
+ * images of the next evaluation. Multi-layer and multi-view images are not read ahead, since all
+ * their frames share the render result of the image, which is replaced when reading a frame. */
 class CachedImageContainer : CachedResourceContainer {
  private:
+  /* An image buffer that was read ahead for the given frame number. The image buffer is null while
+   * it is being read and if reading failed. Read ahead image buffers that were not used by the
+   * time a later frame is evaluated are stale and are freed. The generation identifies the task
+   * that reads the image buffer, see read_ahead_generation_. */
+  struct ReadAheadImageBuffer {
+    ImBuf *image_buffer;
+    int frame_number;
+    uint64_t generation;
+  };
+
   Map<std::string, Map<CachedImageKey, std::unique_ptr<CachedImage>>> map_;
+  /* The read ahead image buffers keyed in the same way as the cached images. */
+  Map<std::string, Map<CachedImageKey, ReadAheadImageBuffer>> read_ahead_image_buffers_;
+  /* The background task pool in which images are read ahead, created on first use. */
+  TaskPool *read_ahead_task_pool_ = nullptr;
+  /* Incremented for every scheduled read ahead task. A read ahead image buffer might be removed
+   * while its task is still running, for instance, if the image changed, and a new one might then
+   * be added for the same key and scheduled in another task. So a task only stores its image
+   * buffer if the generation of the read ahead image buffer is that of the task, otherwise, it
+   * frees it. */
+  uint64_t read_ahead_generation_ = 0;
 
  public:
+  /* Waits for the images that are being read ahead and frees the read ahead image buffers. */
+  ~CachedImageContainer();
+
+  /* Waits for the images that are being read ahead, such that they can be used in the evaluation
+   * that follows the reset, then deletes the cached images that are no longer needed. */
   void reset() override;
 
   /* Check if the given image ID has changed since the last time it was retrieved through its
@@ -77,8 +118,26 @@ class CachedImageContainer : CachedResourceContainer {
    * recalculate flag to ready it to track the next change. Then, check if there is an available
    * CachedImage cached resource with the given image user and pass_name in the container, if one
    * exists, return it, otherwise, return a newly created one and add it to the container. In both
-   * cases, tag the cached resource as needed to keep it cached for the next evaluation. */
+   * cases, tag the cached resource as needed to keep it cached for the next evaluation. Finally,
+   * schedule the image of the next frame to be read ahead if needed. */
   Result get(Context &context, Image *image, const ImageUser *image_user, const char *pass_name);
+
+ private:
+  /* Schedules the image buffer of the given image with the given image user to be read in the
+   * background task pool for the given frame number, unless it is already cached or read ahead.
+   * Expects the mutex to be locked. */
+  void read_ahead(Image *image,
+                  const ImageUser &image_user,
+                  const char *pass_name,
+                  const std::string &id_key,
+                  int frame_number);
+
+  /* Frees the read ahead image buffers that were read for frames before the given frame number.
+   * Expects the mutex to be locked. */
+  void free_stale_read_ahead_image_buffers(int frame_number);
+
+  /* The task that reads an image ahead, see read_ahead. */
+  static void read_ahead_task(TaskPool *__restrict pool, void *task_data);
 };
 
 }  // namespace blender::compositor
@@ -0,0 +1,109 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BLI_map.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_node_types.h"
+
+#include "COM_cached_resource.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+class Context;
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Outputs Key.
+ *
+ * Node outputs are identified by the instance key of the node as well as a hash of everything the
+ * outputs depend on, that is, the properties of the node, the contents of its inputs, and the
+ * identifiers of the outputs that are needed. See NodeOperation::compute_outputs_cache_hash. */
+class CachedNodeOutputsKey {
+ public:
+  bNodeInstanceKey node_instance_key;
+  uint64_t outputs_hash;
+
+  CachedNodeOutputsKey(bNodeInstanceKey node_instance_key, uint64_t outputs_hash);
+
+  uint64_t hash() const;
+};
+
+bool operator==(const CachedNodeOutputsKey &a, const CachedNodeOutputsKey &b);
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Outputs.
+ *
+ * A cached resource that stores persistent copies of the output results computed by a node
+ * operation, such that the operation need not be executed again if neither its properties nor its
+ * inputs changed in later evaluations. Only CPU image results are supported. */
+class CachedNodeOutputs : public CachedResource {
+ private:
+  Context &context_;
+  Map<std::string, Result> results_;
+  /* The number of the last evaluation in which the outputs were used, which is used to evict the
+   * least recently used outputs first. See CachedNodeOutputsContainer. */
+  int64_t last_used_evaluation_ = 0;
+
+  friend class CachedNodeOutputsContainer;
+
+ public:
+  CachedNodeOutputs(Context &context);
+
+  ~CachedNodeOutputs();
+
+  /* Adds a copy of the given result as the cached output with the given identifier. The result is
+   * expected to be an allocated CPU image. */
+  void add_output(StringRef identifier, const Result &result);
+
+  /* Returns the cached output with the given identifier or nullptr if no such output exists. */
+  const Result *get_output(StringRef identifier) const;
+
+  /* Returns the total size in bytes of the cached outputs. */
+  int64_t size_in_bytes() const;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Outputs Container.
+ *
+ * Unlike other cached resources, cached node outputs are not deleted as soon as they are not
+ * needed in an evaluation, since outputs computed with previous node properties are likely to be
+ * needed again, for instance, when the user is tweaking a node and then reverts the change.
+ * Instead, the cached outputs are retained as long as their total size is below a memory budget,
+ * and the least recently used outputs are evicted to make space for new ones. Outputs that are
+ * used in the current evaluation are never evicted, since they are still referenced by the
+ * results of the evaluation. */
+class CachedNodeOutputsContainer : CachedResourceContainer {
+ private:
+  Map<CachedNodeOutputsKey, std::unique_ptr<CachedNodeOutputs>> map_;
+  /* The number of the current evaluation, which is incremented every reset. */
+  int64_t evaluation_ = 0;
+  /* The total size in bytes of all cached outputs in the container. */
+  int64_t size_in_bytes_ = 0;
+
+ public:
+  void reset() override;
+
+  /* Check if there are cached outputs with the given key in the container, if they exist, tag
+   * them as needed and return them, otherwise, return nullptr. */
+  const CachedNodeOutputs *get(const CachedNodeOutputsKey &key);
+
+  /* Adds the given outputs to the container identified by the given key and tag them as needed,
+   * evicting the least recently used outputs that are not needed if the memory budget is exceeded.
+   * The outputs are discarded if they are larger than the memory budget on their own. */
+  void add(const CachedNodeOutputsKey &key, std::unique_ptr<CachedNodeOutputs> outputs);
+
+ private:
+  /* Evicts the least recently used outputs that are not needed until the total size of the cached
+   * outputs is below the memory budget or no more outputs can be evicted. */
+  void evict_least_recently_used();
+};
+
+}  // namespace blender::compositor
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 namespace blender::compositor {
 
 /* -------------------------------------------------------------------------------------------------
@@ -37,10 +39,15 @@ class CachedResource {
  * The cached resources are typically stored in a map identified by a key type. The reset method
  * should be implemented as described in StaticCacheManager::reset. An appropriate getter method
  * should be provided that properly sets the CachedResource::needed flag as described in the
- * description of the StaticCacheManager class.
+ * description of the StaticCacheManager class. The getter should lock the mutex of the container,
+ * since operations might be evaluated concurrently on the CPU.
  *
  * See the existing cached resources for reference. */
 class CachedResourceContainer {
+ protected:
+  /* Protects the cached resources of the container from concurrent access. */
+  std::mutex mutex_;
+
  public:
   /* Reset the container by deleting the cached resources that are no longer needed because they
    * weren't used in the last evaluation and prepare the remaining cached resources to track their
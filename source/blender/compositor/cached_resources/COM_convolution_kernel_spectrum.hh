@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+#include "COM_cached_resource.hh"
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Convolution Kernel Spectrum Key.
+ *
+ * Kernels are identified by their weights, since they are typically computed from arbitrary
+ * images like the bokeh input of the Bokeh Blur node. The hash of the weights is computed once at
+ * construction, while the equality operator compares the weights themselves. */
+class ConvolutionKernelSpectrumKey {
+ private:
+  uint64_t hash_;
+
+ public:
+  Array<float4> kernel;
+  int2 kernel_size;
+  int2 transform_size;
+
+  ConvolutionKernelSpectrumKey(Span<float4> kernel, int2 kernel_size, int2 transform_size);
+
+  uint64_t hash() const;
+};
+
+bool operator==(const ConvolutionKernelSpectrumKey &a, const ConvolutionKernelSpectrumKey &b);
+
+/* -------------------------------------------------------------------------------------------------
+ * Convolution Kernel Spectrum.
+ *
+ * A cached resource that computes and caches the frequency domain representation of a 4-channel
+ * convolution kernel using FFTW's real to complex transform, such that it can be reused by every
+ * tile of an FFT convolution as well as across evaluations. The kernel is zero padded to the given
+ * transform size and flipped around its center, such that multiplying its spectrum with the
+ * spectrum of an image computes the weighted sum of the image pixels around each pixel, which is
+ * what the direct convolutions in the compositor compute. The channels are stored in planar
+ * format. */
+class ConvolutionKernelSpectrum : public CachedResource {
+ private:
+  /* The sum of the weights of the kernel for each channel. See the implementation for more
+   * information. */
+  float4 normalization_factor_ = float4(1.0f);
+
+  /* The number of frequencies in each channel of the spectrum. */
+  int64_t frequencies_per_channel_ = 0;
+
+  /* The kernel in the frequency domain. See the implementation for more information. */
+  std::complex<float> *frequencies_ = nullptr;
+
+ public:
+  ConvolutionKernelSpectrum(Span<float4> kernel, int2 kernel_size, int2 transform_size);
+
+  ~ConvolutionKernelSpectrum();
+
+  /* Returns the frequencies of the given channel of the kernel. */
+  const std::complex<float> *frequencies(int channel) const;
+
+  float4 normalization_factor() const;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Convolution Kernel Spectrum Container.
+ */
+class ConvolutionKernelSpectrumContainer : CachedResourceContainer {
+ private:
+  Map<ConvolutionKernelSpectrumKey, std::unique_ptr<ConvolutionKernelSpectrum>> map_;
+
+ public:
+  void reset() override;
+
+  /* Check if there is an available ConvolutionKernelSpectrum cached resource with the given
+   * parameters in the container, if one exists, return it, otherwise, return a newly created one
+   * and add it to the container. In both cases, tag the cached resource as needed to keep it
+   * cached for the next evaluation. The kernel weights are stored row by row and the kernel size
+   * is expected to be odd. */
+  ConvolutionKernelSpectrum &get(Span<float4> kernel, int2 kernel_size, int2 transform_size);
+};
+
+}  // namespace blender::compositor
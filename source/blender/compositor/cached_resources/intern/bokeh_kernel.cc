@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_hash.hh"
 #include "BLI_math_base.hh"
@@ -297,6 +298,8 @@ Result &BokehKernelContainer::get(Context &context,
                                   float catadioptric,
                                   float lens_shift)
 {
+  std::scoped_lock lock(mutex_);
+
   const BokehKernelKey key(size, sides, rotation, roundness, catadioptric, lens_shift);
 
   auto &bokeh_kernel = *map_.lookup_or_add_cb(key, [&]() {
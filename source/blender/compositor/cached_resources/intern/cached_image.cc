@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_array.hh"
@@ -11,6 +12,9 @@
 #include "BLI_hash.hh"
 #include "BLI_listbase.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.h"
+
+#include "MEM_guardedalloc.h"
 
 #include "RE_pipeline.h"
 
@@ -206,32 +210,40 @@ static ImBuf *compute_linear_buffer(ImBuf *image_buffer)
 CachedImage::CachedImage(Context &context,
                          Image *image,
                          ImageUser *image_user,
-                         const char *pass_name)
+                         const char *pass_name,
+                         ImBuf *read_ahead_image_buffer)
     : result(context)
 {
-  /* We can't retrieve the needed image buffer yet, because we still need to assign the pass index
-   * to the image user in order to acquire the image buffer corresponding to the given pass name.
-   * However, in order to compute the pass index, we need the render result structure of the image
-   * to be initialized. So we first acquire a dummy image buffer since it initializes the image
-   * render result as a side effect. We also use that as a mean of validation, since we can early
-   * exit if the returned image buffer is nullptr. This image buffer can be immediately released.
-   * Since it carries no important information. */
-  ImBuf *initial_image_buffer = BKE_image_acquire_ibuf(image, image_user, nullptr);
-  BKE_image_release_ibuf(image, initial_image_buffer, nullptr);
-  if (!initial_image_buffer) {
-    return;
-  }
+  ImBuf *image_buffer = read_ahead_image_buffer;
+
+  /* Read ahead images are neither multi-layer nor multi-view, so they do not have a render result
+   * and the image buffer need not be acquired. */
+  if (!image_buffer) {
+    /* We can't retrieve the needed image buffer yet, because we still need to assign the pass
+     * index to the image user in order to acquire the image buffer corresponding to the given pass
+     * name. However, in order to compute the pass index, we need the render result structure of
+     * the image to be initialized. So we first acquire a dummy image buffer since it initializes
+     * the image render result as a side effect. We also use that as a mean of validation, since we
+     * can early exit if the returned image buffer is nullptr. This image buffer can be immediately
+     * released. Since it carries no important information. */
+    ImBuf *initial_image_buffer = BKE_image_acquire_ibuf(image, image_user, nullptr);
+    BKE_image_release_ibuf(image, initial_image_buffer, nullptr);
+    if (!initial_image_buffer) {
+      return;
+    }
 
-  RenderResult *render_result = BKE_image_acquire_renderresult(nullptr, image);
+    RenderResult *render_result = BKE_image_acquire_renderresult(nullptr, image);
 
-  ImageUser image_user_for_pass = compute_image_user_for_pass(
-      context, image, render_result, image_user, pass_name);
+    ImageUser image_user_for_pass = compute_image_user_for_pass(
+        context, image, render_result, image_user, pass_name);
 
-  this->populate_meta_data(render_result, image_user_for_pass);
+    this->populate_meta_data(render_result, image_user_for_pass);
 
-  BKE_image_release_renderresult(nullptr, image, render_result);
+    BKE_image_release_renderresult(nullptr, image, render_result);
+
+    image_buffer = BKE_image_acquire_ibuf(image, &image_user_for_pass, nullptr);
+  }
 
-  ImBuf *image_buffer = BKE_image_acquire_ibuf(image, &image_user_for_pass, nullptr);
   ImBuf *linear_image_buffer = compute_linear_buffer(image_buffer);
 
   const bool use_half_float = linear_image_buffer->flags & IB_halffloat;
@@ -262,7 +274,9 @@ CachedImage::CachedImage(Context &context,
   }
 
   IMB_freeImBuf(linear_image_buffer);
-  BKE_image_release_ibuf(image, image_buffer, nullptr);
+  if (!read_ahead_image_buffer) {
+    BKE_image_release_ibuf(image, image_buffer, nullptr);
+  }
 }
 
 void CachedImage::populate_meta_data(const RenderResult *render_result,
@@ -338,8 +352,92 @@ CachedImage::~CachedImage()
  * Cached Image Container.
  */
 
+/* Only image sequences are read ahead, since other images are identical across frames or are
+ * movies, which are read ahead by the movie reader. Multi-layer and multi-view images are not
+ * read ahead, see the class description for more information. */
+static bool should_read_ahead(Image *image)
+{
+  return image->source == IMA_SRC_SEQUENCE && !BKE_image_is_multilayer(image) &&
+         !BKE_image_is_multiview(image);
+}
+
+struct ReadAheadTaskData {
+  Image *image;
+  ImageUser image_user;
+  std::string id_key;
+  CachedImageKey key;
+  uint64_t generation;
+};
+
+void CachedImageContainer::read_ahead_task(TaskPool *__restrict pool, void *task_data)
+{
+  CachedImageContainer &container = *static_cast<CachedImageContainer *>(
+      BLI_task_pool_user_data(pool));
+  const ReadAheadTaskData &data = *static_cast<const ReadAheadTaskData *>(task_data);
+
+  /* Read ahead images are neither multi-layer nor multi-view, so this is what the image user for
+   * the pass is computed as for such images, see compute_image_user_for_pass. */
+  ImageUser image_user = data.image_user;
+  image_user.view = 0;
+  BKE_image_multiview_index(data.image, &image_user);
+
+  /* Keep a reference to the image buffer, since the image might free its cached buffers of other
+   * frames before the next evaluation, see BKE_image_all_free_anim_ibufs. */
+  ImBuf *image_buffer = BKE_image_acquire_ibuf(data.image, &image_user, nullptr);
+  if (image_buffer) {
+    IMB_refImBuf(image_buffer);
+  }
+  BKE_image_release_ibuf(data.image, image_buffer, nullptr);
+
+  /* The read ahead image buffer might have been removed while it was being read, for instance, if
+   * the image changed, in which case, the image buffer is no longer needed. It might also have
+   * been replaced by a read ahead image buffer with the same key that is read by another task,
+   * which is identified by its generation, in which case, that task will store its image buffer
+   * and this one is no longer needed as well. */
+  std::scoped_lock lock(container.mutex_);
+  auto *read_ahead_image_buffers_for_id = container.read_ahead_image_buffers_.lookup_ptr(
+      data.id_key);
+  ReadAheadImageBuffer *read_ahead_image_buffer =
+      read_ahead_image_buffers_for_id ? read_ahead_image_buffers_for_id->lookup_ptr(data.key) :
+                                        nullptr;
+  if (read_ahead_image_buffer && read_ahead_image_buffer->generation == data.generation) {
+    BLI_assert(read_ahead_image_buffer->image_buffer == nullptr);
+    read_ahead_image_buffer->image_buffer = image_buffer;
+  }
+  else {
+    IMB_freeImBuf(image_buffer);
+  }
+}
+
+static void read_ahead_task_data_free(TaskPool *__restrict /*pool*/, void *task_data)
+{
+  MEM_delete(static_cast<ReadAheadTaskData *>(task_data));
+}
+
+CachedImageContainer::~CachedImageContainer()
+{
+  if (read_ahead_task_pool_) {
+    BLI_task_pool_work_and_wait(read_ahead_task_pool_);
+    BLI_task_pool_free(read_ahead_task_pool_);
+  }
+
+  for (auto &read_ahead_image_buffers_for_id : read_ahead_image_buffers_.values()) {
+    for (const ReadAheadImageBuffer &read_ahead_image_buffer :
+         read_ahead_image_buffers_for_id.values())
+    {
+      IMB_freeImBuf(read_ahead_image_buffer.image_buffer);
+    }
+  }
+}
+
 void CachedImageContainer::reset()
 {
+  /* Wait for the images that are being read ahead, since they might be needed in the evaluation
+   * that follows the reset. */
+  if (read_ahead_task_pool_) {
+    BLI_task_pool_work_and_wait(read_ahead_task_pool_);
+  }
+
   /* First, delete all cached images that are no longer needed. */
   for (auto &cached_images_for_id : map_.values()) {
     cached_images_for_id.remove_if([](auto item) { return !item.value->needed; });
@@ -360,6 +458,8 @@ Result CachedImageContainer::get(Context &context,
                                  const ImageUser *image_user,
                                  const char *pass_name)
 {
+  std::scoped_lock lock(mutex_);
+
   if (!image || !image_user) {
     return Result(context);
   }
@@ -377,14 +477,86 @@ Result CachedImageContainer::get(Context &context,
   /* Invalidate the cache for that image ID if it was changed and reset the recalculate flag. */
   if (context.query_id_recalc_flag(reinterpret_cast<ID *>(image)) & ID_RECALC_ALL) {
     cached_images_for_id.clear();
+    auto *read_ahead_image_buffers_for_id = read_ahead_image_buffers_.lookup_ptr(id_key);
+    if (read_ahead_image_buffers_for_id) {
+      for (const ReadAheadImageBuffer &read_ahead_image_buffer :
+           read_ahead_image_buffers_for_id->values())
+      {
+        IMB_freeImBuf(read_ahead_image_buffer.image_buffer);
+      }
+      read_ahead_image_buffers_.remove(id_key);
+    }
   }
 
+  this->free_stale_read_ahead_image_buffers(context.get_frame_number());
+
   auto &cached_image = *cached_images_for_id.lookup_or_add_cb(key, [&]() {
-    return std::make_unique<CachedImage>(context, image, &image_user_for_frame, pass_name);
+    /* Use the image buffer if it was read ahead, the reference that was kept while reading it
+     * ahead is then no longer needed. */
+    ImBuf *read_ahead_image_buffer = nullptr;
+    auto *read_ahead_image_buffers_for_id = read_ahead_image_buffers_.lookup_ptr(id_key);
+    if (read_ahead_image_buffers_for_id) {
+      read_ahead_image_buffer = read_ahead_image_buffers_for_id->pop_default(key, {}).image_buffer;
+    }
+    auto cached_image = std::make_unique<CachedImage>(
+        context, image, &image_user_for_frame, pass_name, read_ahead_image_buffer);
+    IMB_freeImBuf(read_ahead_image_buffer);
+    return cached_image;
   });
 
   cached_image.needed = true;
+
+  if (context.should_read_ahead() && should_read_ahead(image)) {
+    const int next_frame_number = context.get_next_frame_number();
+    ImageUser image_user_for_next_frame = *image_user;
+    BKE_image_user_frame_calc(image, &image_user_for_next_frame, next_frame_number);
+    this->read_ahead(image, image_user_for_next_frame, pass_name, id_key, next_frame_number);
+  }
+
   return cached_image.result;
 }
 
+void CachedImageContainer::free_stale_read_ahead_image_buffers(const int frame_number)
+{
+  for (auto &read_ahead_image_buffers_for_id : read_ahead_image_buffers_.values()) {
+    read_ahead_image_buffers_for_id.remove_if([&](auto item) {
+      if (item.value.frame_number >= frame_number) {
+        return false;
+      }
+      IMB_freeImBuf(item.value.image_buffer);
+      return true;
+    });
+  }
+  read_ahead_image_buffers_.remove_if([](auto item) { return item.value.is_empty(); });
+}
+
+void CachedImageContainer::read_ahead(Image *image,
+                                      const ImageUser &image_user,
+                                      const char *pass_name,
+                                      const std::string &id_key,
+                                      const int frame_number)
+{
+  const CachedImageKey key(image_user, pass_name);
+  if (map_.lookup(id_key).contains(key)) {
+    return;
+  }
+
+  const uint64_t generation = read_ahead_generation_ + 1;
+  const ReadAheadImageBuffer read_ahead_image_buffer = {nullptr, frame_number, generation};
+  auto &read_ahead_image_buffers_for_id = read_ahead_image_buffers_.lookup_or_add_default(id_key);
+  if (!read_ahead_image_buffers_for_id.add(key, read_ahead_image_buffer)) {
+    return;
+  }
+  read_ahead_generation_ = generation;
+
+  if (!read_ahead_task_pool_) {
+    read_ahead_task_pool_ = BLI_task_pool_create_background(this, TASK_PRIORITY_LOW);
+  }
+
+  ReadAheadTaskData *task_data = MEM_new<ReadAheadTaskData>(
+      __func__, ReadAheadTaskData{image, image_user, id_key, key, generation});
+  BLI_task_pool_push(
+      read_ahead_task_pool_, read_ahead_task, task_data, false, read_ahead_task_data_free);
+}
+
 }  // namespace blender::compositor
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -181,6 +182,8 @@ Result &CachedMaskContainer::get(Context &context,
                                  int motion_blur_samples,
                                  float motion_blur_shutter)
 {
+  std::scoped_lock lock(mutex_);
+
   const CachedMaskKey key(
       size, aspect_ratio, use_feather, motion_blur_samples, motion_blur_shutter);
 
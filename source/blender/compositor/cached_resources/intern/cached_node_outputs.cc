@@ -0,0 +1,182 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "BLI_assert.h"
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_node_types.h"
+
+#include "COM_cached_node_outputs.hh"
+#include "COM_context.hh"
+#include "COM_result.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+/* The maximum total size in bytes of the cached node outputs, beyond which the least recently used
+ * outputs are evicted. This is enough for a handful of 4K color images. */
+static constexpr int64_t cached_node_outputs_memory_budget = int64_t(1) << 30;
+
+/* --------------------------------------------------------------------
+ * Cached Node Outputs Key.
+ */
+
+CachedNodeOutputsKey::CachedNodeOutputsKey(bNodeInstanceKey node_instance_key,
+                                           uint64_t outputs_hash)
+    : node_instance_key(node_instance_key), outputs_hash(outputs_hash)
+{
+}
+
+uint64_t CachedNodeOutputsKey::hash() const
+{
+  return get_default_hash(node_instance_key.value, outputs_hash);
+}
+
+bool operator==(const CachedNodeOutputsKey &a, const CachedNodeOutputsKey &b)
+{
+  return a.node_instance_key == b.node_instance_key && a.outputs_hash == b.outputs_hash;
+}
+
+/* --------------------------------------------------------------------
+ * Cached Node Outputs.
+ */
+
+/* Returns the size in bytes of the data of the given CPU image result. */
+static int64_t get_result_size_in_bytes(const Result &result)
+{
+  const int2 size = result.domain().size;
+  return int64_t(size.x) * size.y * result.channels_count() * sizeof(float);
+}
+
+CachedNodeOutputs::CachedNodeOutputs(Context &context) : context_(context) {}
+
+CachedNodeOutputs::~CachedNodeOutputs()
+{
+  for (Result &result : results_.values()) {
+    result.free();
+  }
+}
+
+void CachedNodeOutputs::add_output(StringRef identifier, const Result &result)
+{
+  BLI_assert(result.is_allocated() && !result.is_single_value());
+  BLI_assert(result.storage_type() != ResultStorageType::GPU);
+
+  /* Allocate outside of the pool, since the copy persists across evaluations, which also means the
+   * copy is never stored in half precision, see Result::should_use_half_storage. */
+  Result copy = context_.create_result(result.type(), result.precision());
+  copy.allocate_texture(result.domain(), false);
+  copy.meta_data = result.meta_data;
+
+  if (result.storage_type() == ResultStorageType::HalfCPU) {
+    parallel_for(result.domain().size, [&](const int2 texel) {
+      copy.store_pixel_generic_type(texel, result.load_pixel_generic_type(texel));
+    });
+  }
+  else {
+    std::memcpy(copy.data(), result.data(), get_result_size_in_bytes(result));
+  }
+
+  results_.add_new(identifier, copy);
+}
+
+const Result *CachedNodeOutputs::get_output(StringRef identifier) const
+{
+  return results_.lookup_ptr_as(identifier);
+}
+
+int64_t CachedNodeOutputs::size_in_bytes() const
+{
+  int64_t size_in_bytes = 0;
+  for (const Result &result : results_.values()) {
+    size_in_bytes += get_result_size_in_bytes(result);
+  }
+  return size_in_bytes;
+}
+
+/* --------------------------------------------------------------------
+ * Cached Node Outputs Container.
+ */
+
+void CachedNodeOutputsContainer::reset()
+{
+  /* Cached outputs are not deleted when they are not needed, they are only evicted when the memory
+   * budget is exceeded, see the class description for more information. So just reset the needed
+   * status of all outputs to false to ready them to track their needed status for the next
+   * evaluation, which also makes them eligible for eviction. */
+  for (auto &value : map_.values()) {
+    value->needed = false;
+  }
+
+  evaluation_++;
+}
+
+const CachedNodeOutputs *CachedNodeOutputsContainer::get(const CachedNodeOutputsKey &key)
+{
+  std::scoped_lock lock(mutex_);
+
+  std::unique_ptr<CachedNodeOutputs> *outputs = map_.lookup_ptr(key);
+  if (!outputs) {
+    return nullptr;
+  }
+
+  (*outputs)->needed = true;
+  (*outputs)->last_used_evaluation_ = evaluation_;
+  return outputs->get();
+}
+
+void CachedNodeOutputsContainer::add(const CachedNodeOutputsKey &key,
+                                     std::unique_ptr<CachedNodeOutputs> outputs)
+{
+  std::scoped_lock lock(mutex_);
+
+  const int64_t outputs_size_in_bytes = outputs->size_in_bytes();
+  if (outputs_size_in_bytes > cached_node_outputs_memory_budget) {
+    return;
+  }
+
+  outputs->needed = true;
+  outputs->last_used_evaluation_ = evaluation_;
+  map_.add_new(key, std::move(outputs));
+  size_in_bytes_ += outputs_size_in_bytes;
+
+  this->evict_least_recently_used();
+}
+
+void CachedNodeOutputsContainer::evict_least_recently_used()
+{
+  while (size_in_bytes_ > cached_node_outputs_memory_budget) {
+    const CachedNodeOutputsKey *least_recently_used_key = nullptr;
+    int64_t least_recently_used_evaluation = evaluation_ + 1;
+    for (auto item : map_.items()) {
+      if (item.value->needed) {
+        continue;
+      }
+      if (item.value->last_used_evaluation_ < least_recently_used_evaluation) {
+        least_recently_used_key = &item.key;
+        least_recently_used_evaluation = item.value->last_used_evaluation_;
+      }
+    }
+
+    /* All remaining outputs are needed by the current evaluation. */
+    if (!least_recently_used_key) {
+      return;
+    }
+
+    const CachedNodeOutputsKey key = *least_recently_used_key;
+    size_in_bytes_ -= map_.lookup(key)->size_in_bytes();
+    map_.remove(key);
+  }
+}
+
+}  // namespace blender::compositor
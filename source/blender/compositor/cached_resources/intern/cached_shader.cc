@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_hash.hh"
@@ -89,6 +90,8 @@ void CachedShaderContainer::reset()
 
 GPUShader *CachedShaderContainer::get(const char *info_name, ResultPrecision precision)
 {
+  std::scoped_lock lock(mutex_);
+
   const CachedShaderKey key(info_name, precision);
 
   auto &cached_shader = *map_.lookup_or_add_cb(
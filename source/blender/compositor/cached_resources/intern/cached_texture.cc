@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -144,6 +145,8 @@ CachedTexture &CachedTextureContainer::get(Context &context,
                                            float3 offset,
                                            float3 scale)
 {
+  std::scoped_lock lock(mutex_);
+
   const CachedTextureKey key(size, offset, scale);
 
   const std::string library_key = texture->id.lib ? texture->id.lib->id.name : "";
@@ -0,0 +1,184 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#if defined(WITH_FFTW3)
+#  include <fftw3.h>
+#endif
+
+#include "BLI_array.hh"
+#include "BLI_fftw.hh"
+#include "BLI_hash.hh"
+#include "BLI_hash_mm2a.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "COM_convolution_kernel_spectrum.hh"
+
+namespace blender::compositor {
+
+/* --------------------------------------------------------------------
+ * Convolution Kernel Spectrum Key.
+ */
+
+ConvolutionKernelSpectrumKey::ConvolutionKernelSpectrumKey(Span<float4> kernel,
+                                                           int2 kernel_size,
+                                                           int2 transform_size)
+    : kernel(kernel), kernel_size(kernel_size), transform_size(transform_size)
+{
+  const uint32_t kernel_hash = BLI_hash_mm2(
+      reinterpret_cast<const unsigned char *>(kernel.data()), kernel.size_in_bytes(), 0);
+  hash_ = get_default_hash(kernel_hash, kernel_size, transform_size);
+}
+
+uint64_t ConvolutionKernelSpectrumKey::hash() const
+{
+  return hash_;
+}
+
+bool operator==(const ConvolutionKernelSpectrumKey &a, const ConvolutionKernelSpectrumKey &b)
+{
+  return a.hash() == b.hash() && a.kernel_size == b.kernel_size &&
+         a.transform_size == b.transform_size && a.kernel.as_span() == b.kernel.as_span();
+}
+
+/* --------------------------------------------------------------------
+ * Convolution Kernel Spectrum.
+ */
+
+ConvolutionKernelSpectrum::ConvolutionKernelSpectrum(Span<float4> kernel,
+                                                     int2 kernel_size,
+                                                     int2 transform_size)
+{
+#if defined(WITH_FFTW3)
+  fftw::initialize_float();
+
+  /* The FFTW real to complex transforms utilizes the hermitian symmetry of real transforms and
+   * stores only half the output since the other half is redundant, so we only allocate half of
+   * the first dimension. See Section 4.3.4 Real-data DFT Array Format in the FFTW manual for
+   * more information. */
+  const int2 frequency_size = int2(transform_size.x / 2 + 1, transform_size.y);
+  const int64_t spatial_pixels_per_channel = int64_t(transform_size.x) * transform_size.y;
+  frequencies_per_channel_ = int64_t(frequency_size.x) * frequency_size.y;
+
+  const int channels_count = 4;
+  float *kernel_spatial_domain = fftwf_alloc_real(spatial_pixels_per_channel * channels_count);
+  frequencies_ = reinterpret_cast<std::complex<float> *>(
+      fftwf_alloc_complex(frequencies_per_channel_ * channels_count));
+
+  /* Create a real to complex plan to transform the kernel to the frequency domain. */
+  fftwf_plan forward_plan = fftwf_plan_dft_r2c_2d(transform_size.y,
+                                                  transform_size.x,
+                                                  kernel_spatial_domain,
+                                                  reinterpret_cast<fftwf_complex *>(frequencies_),
+                                                  FFTW_ESTIMATE);
+
+  /* Zero pad the kernel to the transform size while flipping it around its center with wrap
+   * around, such that the center of the kernel is at the zero point. The flipping turns the
+   * circular convolution in the frequency domain into a weighted sum of the pixels around each
+   * pixel, where the kernel is not flipped, matching the direct convolutions in the compositor.
+   * The channels are stored in planar format for better cache locality, that is,
+   * RRRR...GGGG...BBBB...AAAA. */
+  const int2 kernel_center = kernel_size / 2;
+  threading::parallel_for(IndexRange(transform_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(transform_size.x)) {
+        const int2 kernel_texel = kernel_size - 1 -
+                                  int2(mod_i(int(x) + kernel_center.x, transform_size.x),
+                                       mod_i(int(y) + kernel_center.y, transform_size.y));
+        const bool is_inside_kernel = kernel_texel.x >= 0 && kernel_texel.y >= 0;
+        const int64_t kernel_index = int64_t(kernel_texel.y) * kernel_size.x + kernel_texel.x;
+        const float4 weight = is_inside_kernel ? kernel[kernel_index] : float4(0.0f);
+        for (const int64_t channel : IndexRange(channels_count)) {
+          const int64_t base_index = y * transform_size.x + x;
+          kernel_spatial_domain[base_index + spatial_pixels_per_channel * channel] =
+              weight[channel];
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(channels_count), 1, [&](const IndexRange sub_range) {
+    for (const int64_t channel : sub_range) {
+      fftwf_execute_dft_r2c(forward_plan,
+                            kernel_spatial_domain + spatial_pixels_per_channel * channel,
+                            reinterpret_cast<fftwf_complex *>(frequencies_) +
+                                frequencies_per_channel_ * channel);
+    }
+  });
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_free(kernel_spatial_domain);
+
+  /* The kernel is not normalized, but instead of normalizing it, we normalize the result of the
+   * convolution, which is equivalent since the Fourier transform is linear. Use a double to sum
+   * the kernel since floats are not stable for large sums. */
+  double4 sum = double4(0.0);
+  for (const float4 &weight : kernel) {
+    sum += double4(weight);
+  }
+  normalization_factor_ = float4(sum);
+#else
+  UNUSED_VARS(kernel, kernel_size, transform_size);
+#endif
+}
+
+ConvolutionKernelSpectrum::~ConvolutionKernelSpectrum()
+{
+#if defined(WITH_FFTW3)
+  fftwf_free(frequencies_);
+#endif
+}
+
+const std::complex<float> *ConvolutionKernelSpectrum::frequencies(int channel) const
+{
+  return frequencies_ + frequencies_per_channel_ * channel;
+}
+
+float4 ConvolutionKernelSpectrum::normalization_factor() const
+{
+  return normalization_factor_;
+}
+
+/* --------------------------------------------------------------------
+ * Convolution Kernel Spectrum Container.
+ */
+
+void ConvolutionKernelSpectrumContainer::reset()
+{
+  /* First, delete all resources that are no longer needed. */
+  map_.remove_if([](auto item) { return !item.value->needed; });
+
+  /* Second, reset the needed status of the remaining resources to false to ready them to track
+   * their needed status for the next evaluation. */
+  for (auto &value : map_.values()) {
+    value->needed = false;
+  }
+}
+
+ConvolutionKernelSpectrum &ConvolutionKernelSpectrumContainer::get(Span<float4> kernel,
+                                                                   int2 kernel_size,
+                                                                   int2 transform_size)
+{
+  std::scoped_lock lock(mutex_);
+
+  const ConvolutionKernelSpectrumKey key(kernel, kernel_size, transform_size);
+
+  auto &spectrum = *map_.lookup_or_add_cb(key, [&]() {
+    return std::make_unique<ConvolutionKernelSpectrum>(kernel, kernel_size, transform_size);
+  });
+
+  spectrum.needed = true;
+  return spectrum;
+}
+
+}  // namespace blender::compositor
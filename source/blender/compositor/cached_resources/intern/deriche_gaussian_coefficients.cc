@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_hash.hh"
 #include "BLI_math_base.hh"
@@ -315,6 +316,8 @@ void DericheGaussianCoefficientsContainer::reset()
 DericheGaussianCoefficients &DericheGaussianCoefficientsContainer::get(Context &context,
                                                                        float sigma)
 {
+  std::scoped_lock lock(mutex_);
+
   const DericheGaussianCoefficientsKey key(sigma);
 
   auto &deriche_gaussian_coefficients = *map_.lookup_or_add_cb(
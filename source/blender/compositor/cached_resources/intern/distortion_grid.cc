@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -152,6 +153,8 @@ static int2 get_movie_clip_size(MovieClip *movie_clip, int frame_number)
 Result &DistortionGridContainer::get(
     Context &context, MovieClip *movie_clip, int2 size, DistortionType type, int frame_number)
 {
+  std::scoped_lock lock(mutex_);
+
   const int2 calibration_size = get_movie_clip_size(movie_clip, frame_number);
 
   const DistortionGridKey key(movie_clip->tracking.camera, size, type, calibration_size);
@@ -5,6 +5,7 @@
 #include <complex>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <numeric>
 
 #if defined(WITH_FFTW3)
@@ -168,6 +169,8 @@ void FogGlowKernelContainer::reset()
 
 FogGlowKernel &FogGlowKernelContainer::get(int kernel_size, int2 spatial_size)
 {
+  std::scoped_lock lock(mutex_);
+
   const FogGlowKernelKey key(kernel_size, spatial_size);
 
   auto &kernel = *map_.lookup_or_add_cb(
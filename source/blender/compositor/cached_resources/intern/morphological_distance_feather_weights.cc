@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -169,6 +170,8 @@ void MorphologicalDistanceFeatherWeightsContainer::reset()
 MorphologicalDistanceFeatherWeights &MorphologicalDistanceFeatherWeightsContainer::get(
     Context &context, int type, int radius)
 {
+  std::scoped_lock lock(mutex_);
+
   const MorphologicalDistanceFeatherWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(key, [&]() {
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_assert.h"
@@ -545,6 +546,8 @@ OCIOColorSpaceConversionShader &OCIOColorSpaceConversionShaderContainer::get(Con
                                                                              std::string source,
                                                                              std::string target)
 {
+  std::scoped_lock lock(mutex_);
+
 #if defined(WITH_OCIO)
   /* Use the config cache ID in the cache key in case the configuration changed at runtime. */
   std::string config_cache_id = OCIO::GetCurrentConfig()->getCacheID();
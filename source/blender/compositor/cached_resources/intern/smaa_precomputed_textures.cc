@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <memory>
+#include <mutex>
 
 #include "BLI_smaa_textures.h"
 
@@ -126,6 +127,8 @@ void SMAAPrecomputedTexturesContainer::reset()
 
 SMAAPrecomputedTextures &SMAAPrecomputedTexturesContainer::get(Context &context)
 {
+  std::scoped_lock lock(mutex_);
+
   if (!textures_) {
     textures_ = std::make_unique<SMAAPrecomputedTextures>(context);
   }
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -133,6 +134,8 @@ void SymmetricBlurWeightsContainer::reset()
 
 Result &SymmetricBlurWeightsContainer::get(Context &context, int type, float2 radius)
 {
+  std::scoped_lock lock(mutex_);
+
   const SymmetricBlurWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(
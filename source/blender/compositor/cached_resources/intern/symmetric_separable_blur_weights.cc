@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_array.hh"
 #include "BLI_hash.hh"
@@ -112,6 +113,8 @@ void SymmetricSeparableBlurWeightsContainer::reset()
 
 Result &SymmetricSeparableBlurWeightsContainer::get(Context &context, int type, float radius)
 {
+  std::scoped_lock lock(mutex_);
+
   const SymmetricSeparableBlurWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(key, [&]() {
@@ -29,6 +29,7 @@
 #include <complex>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "BLI_assert.h"
 #include "BLI_hash.hh"
@@ -544,6 +545,8 @@ void VanVlietGaussianCoefficientsContainer::reset()
 VanVlietGaussianCoefficients &VanVlietGaussianCoefficientsContainer::get(Context &context,
                                                                          float sigma)
 {
+  std::scoped_lock lock(mutex_);
+
   const VanVlietGaussianCoefficientsKey key(sigma);
 
   auto &deriche_gaussian_coefficients = *map_.lookup_or_add_cb(
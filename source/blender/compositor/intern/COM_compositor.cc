@@ -2,18 +2,26 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
 #include "BLI_threads.h"
 
 #include "BLT_translation.hh"
 
+#include "BKE_global.hh"
 #include "BKE_node.hh"
 #include "BKE_node_runtime.hh"
 #include "BKE_scene.hh"
 
+#include "CLG_log.h"
+
 #include "COM_compositor.hh"
+#include "COM_profiler.hh"
 
 #include "RE_compositor.hh"
 
+static CLG_LogRef LOG = {"compositor"};
+
 static constexpr float COM_PREVIEW_SIZE = 140.0f;
 
 static struct {
@@ -83,6 +91,33 @@ void COM_execute(Render *render,
   BLI_mutex_unlock(&g_compositor.mutex);
 }
 
+bool COM_is_trace_requested()
+{
+  return G.compositor_trace_filepath[0] != '\0';
+}
+
+void COM_write_trace(const blender::compositor::Profiler &profiler, const int frame)
+{
+  if (!COM_is_trace_requested()) {
+    return;
+  }
+
+  char filepath[FILE_MAX];
+  STRNCPY(filepath, G.compositor_trace_filepath);
+  BLI_path_frame(filepath, sizeof(filepath), frame, 0);
+
+  if (profiler.write_chrome_trace(filepath)) {
+    CLOG_INFO(&LOG,
+              0,
+              "Trace of %d operations written to \"%s\"",
+              int(profiler.get_operation_profiles().size()),
+              filepath);
+  }
+  else {
+    CLOG_ERROR(&LOG, "Could not write trace to \"%s\"", filepath);
+  }
+}
+
 void COM_deinitialize()
 {
   if (g_compositor.is_initialized) {
@@ -14,6 +14,8 @@
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_node_operation.hh"
+#include "COM_operation.hh"
+#include "COM_operation_task_graph.hh"
 #include "COM_pixel_operation.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
@@ -23,7 +25,10 @@ namespace blender::compositor {
 
 using namespace nodes::derived_node_tree_types;
 
-CompileState::CompileState(const Schedule &schedule) : schedule_(schedule) {}
+CompileState::CompileState(const Schedule &schedule, OperationTaskGraph *task_graph)
+    : schedule_(schedule), task_graph_(task_graph)
+{
+}
 
 const Schedule &CompileState::get_schedule()
 {
@@ -56,6 +61,15 @@ Result &CompileState::get_result_from_output_socket(DOutputSocket output)
   return operation->get_result(operation->get_output_identifier_from_output_socket(output));
 }
 
+Operation &CompileState::get_operation_from_output_socket(DOutputSocket output)
+{
+  if (node_operations_.contains(output.node())) {
+    return *node_operations_.lookup(output.node());
+  }
+
+  return *pixel_operations_.lookup(output.node());
+}
+
 void CompileState::add_node_to_pixel_compile_unit(DNode node)
 {
   pixel_compile_unit_.add_new(node);
@@ -170,6 +184,11 @@ Domain CompileState::compute_pixel_node_domain(DNode node)
       continue;
     }
 
+    /* The domain of the result is only known once the operation that computes it is evaluated. */
+    if (task_graph_) {
+      task_graph_->wait_for_operation(get_operation_from_output_socket(output));
+    }
+
     const Result &result = get_result_from_output_socket(output);
 
     /* A single value input can't be a domain input. */
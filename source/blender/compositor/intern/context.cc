@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_rect.h"
 
@@ -13,6 +14,7 @@
 #include "BKE_node_runtime.hh"
 
 #include "COM_context.hh"
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_profiler.hh"
 #include "COM_render_context.hh"
 #include "COM_static_cache_manager.hh"
@@ -49,9 +51,15 @@ bool Context::is_canceled() const
   return this->get_node_tree().runtime->test_break(get_node_tree().runtime->tbh);
 }
 
+bool Context::should_read_ahead() const
+{
+  return false;
+}
+
 void Context::reset()
 {
   texture_pool_.reset();
+  cpu_buffer_pool_.reset();
   cache_manager_.reset();
 }
 
@@ -81,6 +89,11 @@ int Context::get_frame_number() const
   return get_render_data().cfra;
 }
 
+int Context::get_next_frame_number() const
+{
+  return get_frame_number() + math::max(1, get_render_data().frame_step);
+}
+
 float Context::get_time() const
 {
   const float frame_number = float(get_frame_number());
@@ -114,6 +127,11 @@ TexturePool &Context::texture_pool()
   return texture_pool_;
 }
 
+CPUBufferPool &Context::cpu_buffer_pool()
+{
+  return cpu_buffer_pool_;
+}
+
 StaticCacheManager &Context::cache_manager()
 {
   return cache_manager_;
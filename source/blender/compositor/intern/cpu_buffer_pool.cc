@@ -0,0 +1,176 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_system.h"
+#include "BLI_vector.hh"
+
+#include "COM_cpu_buffer_pool.hh"
+
+namespace blender::compositor {
+
+/* -------------------------------------------------------------------- */
+/** \name CPU Buffer Pool Key
+ * \{ */
+
+CPUBufferPoolKey::CPUBufferPoolKey(int2 size, int channels_count)
+    : size(size), channels_count(channels_count)
+{
+}
+
+int64_t CPUBufferPoolKey::size_in_bytes() const
+{
+  return int64_t(size.x) * int64_t(size.y) * channels_count * 4;
+}
+
+uint64_t CPUBufferPoolKey::hash() const
+{
+  return get_default_hash(size.x, size.y, channels_count);
+}
+
+bool operator==(const CPUBufferPoolKey &a, const CPUBufferPoolKey &b)
+{
+  return a.size == b.size && a.channels_count == b.channels_count;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name CPU Buffer Pool
+ * \{ */
+
+static_assert(sizeof(float) == 4 && sizeof(int) == 4,
+              "CPU buffer pool stores floats and integers in the same buffers.");
+
+CPUBufferPool::CPUBufferPool()
+{
+  /* Retain at most a quarter of the system memory in buffers that are not in use. */
+  memory_budget_ = int64_t(BLI_system_memory_max_in_megabytes()) * 1024 * 1024 / 4;
+}
+
+CPUBufferPool::~CPUBufferPool()
+{
+  for (Vector<AvailableBuffer> &available_buffers : available_buffers_.values()) {
+    for (AvailableBuffer &buffer : available_buffers) {
+      MEM_freeN(buffer.data);
+    }
+  }
+
+  /* Buffers that are still acquired belong to results that outlive their context, which should
+   * not happen, but free them anyway to not leak them. */
+  for (const void *buffer : acquired_buffers_.keys()) {
+    MEM_freeN(const_cast<void *>(buffer));
+  }
+}
+
+void *CPUBufferPool::acquire(int2 size, int channels_count)
+{
+  const CPUBufferPoolKey key = CPUBufferPoolKey(size, channels_count);
+
+  {
+    std::scoped_lock lock(mutex_);
+    /* Check if there is an available buffer with the required specification, and if one exists,
+     * return the most recently released one, since it is the most likely to still be in cache. */
+    Vector<AvailableBuffer> *available_buffers = available_buffers_.lookup_ptr(key);
+    if (available_buffers && !available_buffers->is_empty()) {
+      void *buffer = available_buffers->pop_last().data;
+      available_size_ -= key.size_in_bytes();
+      this->add_acquired_buffer(buffer, key);
+      return buffer;
+    }
+  }
+
+  /* Otherwise, allocate a new buffer outside of the lock, since it can take a while. */
+  void *buffer = MEM_malloc_arrayN(
+      int64_t(size.x) * int64_t(size.y), size_t(channels_count) * 4, __func__);
+
+  std::scoped_lock lock(mutex_);
+  this->add_acquired_buffer(buffer, key);
+  return buffer;
+}
+
+void CPUBufferPool::release(void *buffer)
+{
+  std::scoped_lock lock(mutex_);
+  const CPUBufferPoolKey key = acquired_buffers_.pop(buffer);
+  available_buffers_.lookup_or_add_default(key).append({buffer, evaluation_, release_time_++});
+  available_size_ += key.size_in_bytes();
+  acquired_size_ -= key.size_in_bytes();
+  this->trim_to_budget();
+}
+
+void CPUBufferPool::reset()
+{
+  std::scoped_lock lock(mutex_);
+  for (auto item : available_buffers_.items()) {
+    const int64_t buffer_size = item.key.size_in_bytes();
+    item.value.remove_if([&](const AvailableBuffer &buffer) {
+      if (buffer.evaluation == evaluation_) {
+        return false;
+      }
+      MEM_freeN(buffer.data);
+      available_size_ -= buffer_size;
+      return true;
+    });
+  }
+  available_buffers_.remove_if([](auto item) { return item.value.is_empty(); });
+
+  peak_acquired_size_ = acquired_size_;
+  evaluation_++;
+}
+
+int64_t CPUBufferPool::peak_acquired_size()
+{
+  std::scoped_lock lock(mutex_);
+  return peak_acquired_size_;
+}
+
+void CPUBufferPool::add_acquired_buffer(void *buffer, const CPUBufferPoolKey &key)
+{
+  acquired_buffers_.add_new(buffer, key);
+  acquired_size_ += key.size_in_bytes();
+  peak_acquired_size_ = std::max(peak_acquired_size_, acquired_size_);
+}
+
+void CPUBufferPool::trim_to_budget()
+{
+  while (available_size_ > memory_budget_) {
+    /* Find the least recently released buffer. The number of distinct buffer specifications is
+     * small, and buffers are appended in release order, so only the first buffer of every
+     * specification needs to be checked. */
+    Vector<AvailableBuffer> *oldest_buffers = nullptr;
+    int64_t oldest_buffer_size = 0;
+    for (auto item : available_buffers_.items()) {
+      if (item.value.is_empty()) {
+        continue;
+      }
+      if (!oldest_buffers ||
+          item.value.first().release_time < oldest_buffers->first().release_time)
+      {
+        oldest_buffers = &item.value;
+        oldest_buffer_size = item.key.size_in_bytes();
+      }
+    }
+
+    if (!oldest_buffers) {
+      break;
+    }
+
+    MEM_freeN(oldest_buffers->first().data);
+    oldest_buffers->remove(0);
+    available_size_ -= oldest_buffer_size;
+  }
+}
+
+/** \} */
+
+}  // namespace blender::compositor
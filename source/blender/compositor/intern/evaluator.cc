@@ -2,8 +2,12 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <memory>
 #include <string>
 
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
 #include "DNA_node_types.h"
 
 #include "NOD_derived_node_tree.hh"
@@ -14,6 +18,8 @@
 #include "COM_input_single_value_operation.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_operation_task_graph.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
@@ -43,13 +49,16 @@ void Evaluator::evaluate()
   }
 
   if (context_.profiler()) {
+    context_.profiler()->add_peak_memory_usage(context_.cpu_buffer_pool().peak_acquired_size());
     context_.profiler()->finalize(context_.get_node_tree());
   }
 }
 
 void Evaluator::reset()
 {
+  task_graph_.reset();
   operations_stream_.clear();
+  schedule_.clear();
   derived_node_tree_.reset();
 
   is_compiled_ = false;
@@ -84,11 +93,15 @@ void Evaluator::compile_and_evaluate()
     return;
   }
 
-  const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
+  schedule_ = compute_schedule(context_, *derived_node_tree_);
+
+  if (!context_.use_gpu()) {
+    task_graph_ = std::make_unique<OperationTaskGraph>(context_);
+  }
 
-  CompileState compile_state(schedule);
+  CompileState compile_state(schedule_, task_graph_.get());
 
-  for (const DNode &node : schedule) {
+  for (const DNode &node : schedule_) {
     if (context_.is_canceled()) {
       this->cancel_evaluation();
       reset();
@@ -107,6 +120,9 @@ void Evaluator::compile_and_evaluate()
     }
   }
 
+  /* Wait for the remaining operations, which also frees the task graph. */
+  task_graph_.reset();
+
   is_compiled_ = true;
 }
 
@@ -125,7 +141,15 @@ void Evaluator::compile_and_evaluate_node(DNode node, CompileState &compile_stat
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
-  operation->evaluate();
+  Vector<Operation *> dependencies;
+  for (const bNodeSocket *input : node->input_sockets()) {
+    const DOutputSocket output = get_output_linked_to_input(DInputSocket(node.context(), input));
+    if (output) {
+      dependencies.append(&compile_state.get_operation_from_output_socket(output));
+    }
+  }
+
+  this->evaluate_operation(*operation, dependencies);
 }
 
 void Evaluator::map_node_operation_inputs_to_their_results(DNode node,
@@ -212,7 +236,12 @@ void Evaluator::compile_and_evaluate_pixel_compile_unit(CompileState &compile_st
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
-  operation->evaluate();
+  Vector<Operation *> dependencies;
+  for (const DOutputSocket &output : operation->get_inputs_to_linked_outputs_map().values()) {
+    dependencies.append(&compile_state.get_operation_from_output_socket(output));
+  }
+
+  this->evaluate_operation(*operation, dependencies);
 
   compile_state.reset_pixel_compile_unit();
 }
@@ -226,8 +255,23 @@ void Evaluator::map_pixel_operation_inputs_to_their_results(PixelOperation *oper
   }
 }
 
+void Evaluator::evaluate_operation(Operation &operation, Span<Operation *> dependencies)
+{
+  if (task_graph_) {
+    task_graph_->add_operation(operation, dependencies);
+  }
+  else {
+    operation.evaluate();
+  }
+}
+
 void Evaluator::cancel_evaluation()
 {
+  /* Operations that are being evaluated might still use the results. */
+  if (task_graph_) {
+    task_graph_->wait();
+  }
+
   context_.cache_manager().skip_next_reset();
   for (const std::unique_ptr<Operation> &operation : operations_stream_) {
     operation->free_results();
@@ -5,14 +5,18 @@
 #include <memory>
 #include <string>
 
+#include "BLI_array.hh"
 #include "BLI_assert.h"
+#include "BLI_bounds.hh"
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_span.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.hh"
+#include "BLI_math_half.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "FN_multi_function.hh"
@@ -35,6 +39,7 @@
 #include "COM_input_descriptor.hh"
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -104,11 +109,33 @@ void MultiFunctionProcedureOperation::execute()
 {
   const Domain domain = compute_domain();
   const int64_t size = int64_t(domain.size.x) * domain.size.y;
-  const IndexMask mask = IndexMask(size);
+  IndexMaskMemory memory;
+  const IndexMask mask = this->compute_needed_pixels_mask(domain.size, memory);
+  this->set_computed_pixels_count(mask.size());
+
+  /* Allocate the outputs and check if any of the inputs or outputs are stored in half precision,
+   * since those can't be passed to the procedure directly. */
+  bool has_half_storage = false;
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
+      const Result &input = get_input(parameter_identifiers_[i]);
+      has_half_storage |= input.storage_type() == ResultStorageType::HalfCPU;
+    }
+    else {
+      Result &result = get_result(parameter_identifiers_[i]);
+      result.allocate_texture(domain);
+      has_half_storage |= result.storage_type() == ResultStorageType::HalfCPU;
+    }
+  }
+
+  if (has_half_storage) {
+    this->execute_with_half_storage(mask);
+    return;
+  }
+
   mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
 
-  /* For each of the parameters, either add an input or an output depending on its interface type,
-   * allocating the outputs when needed. */
+  /* For each of the parameters, either add an input or an output depending on its type. */
   for (int i = 0; i < procedure_.params().size(); i++) {
     if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
       Result &input = get_input(parameter_identifiers_[i]);
@@ -122,7 +149,6 @@ void MultiFunctionProcedureOperation::execute()
     }
     else {
       Result &result = get_result(parameter_identifiers_[i]);
-      result.allocate_texture(domain);
       const GMutableSpan span{get_cpp_type(result.type()), result.data(), size};
       parameter_builder.add_uninitialized_single_output(span);
     }
@@ -132,6 +158,132 @@ void MultiFunctionProcedureOperation::execute()
   procedure_executor_->call_auto(mask, parameter_builder, context_builder);
 }
 
+/* The maximum number of pixels in the chunks that are computed at once if some of the inputs or
+ * outputs are stored in half precision. Small enough for the temporary full precision buffers of
+ * the chunk to stay in cache. */
+static constexpr int64_t half_storage_chunk_size = 4096;
+
+/* Splits the pixels of the given mask into contiguous chunks of at most half_storage_chunk_size
+ * pixels, such that the temporary buffers of a chunk only hold the pixels that are computed. For
+ * instance, the mask of a cropped region consists of a range of pixels for each row. */
+static Vector<IndexRange> split_mask_into_contiguous_chunks(const IndexMask &mask)
+{
+  Vector<IndexRange> chunks;
+  mask.foreach_range([&](const IndexRange range) {
+    for (int64_t start = range.first(); start < range.one_after_last();
+         start += half_storage_chunk_size)
+    {
+      chunks.append(IndexRange::from_begin_end(
+          start, math::min(start + half_storage_chunk_size, range.one_after_last())));
+    }
+  });
+  return chunks;
+}
+
+void MultiFunctionProcedureOperation::execute_with_half_storage(const IndexMask &mask)
+{
+  const Vector<IndexRange> chunks = split_mask_into_contiguous_chunks(mask);
+  const int parameters_count = procedure_.params().size();
+  threading::parallel_for(
+      chunks.index_range(),
+      half_storage_chunk_size,
+      [&](const IndexRange sub_range) {
+        /* The full precision buffers of the parameters that are stored in half precision, which
+         * are reused by all chunks of the task. */
+        Array<Array<float4>> buffers(parameters_count);
+
+        for (const IndexRange pixels : chunks.as_span().slice(sub_range)) {
+          /* The parameters only cover the pixels of the chunk, so the procedure is called on all
+           * of them starting from zero. */
+          const IndexMask chunk_mask(pixels.size());
+          mf::ParamsBuilder parameter_builder{*procedure_executor_, &chunk_mask};
+
+          for (const int i : IndexRange(parameters_count)) {
+            const bool is_input = procedure_.params()[i].type ==
+                                  mf::ParamType::InterfaceType::Input;
+            Result &result = is_input ? get_input(parameter_identifiers_[i]) :
+                                        get_result(parameter_identifiers_[i]);
+
+            if (is_input && result.is_single_value()) {
+              add_single_value_parameter(parameter_builder, result);
+              continue;
+            }
+
+            GMutableSpan span;
+            if (result.storage_type() == ResultStorageType::HalfCPU) {
+              if (buffers[i].is_empty()) {
+                buffers[i].reinitialize(half_storage_chunk_size);
+              }
+              span = buffers[i].as_mutable_span().take_front(pixels.size());
+              if (is_input) {
+                math::half_to_float_array(result.half_texture() + pixels.first() * 4,
+                                          reinterpret_cast<float *>(buffers[i].data()),
+                                          size_t(pixels.size()) * 4);
+              }
+            }
+            else {
+              const CPPType &type = get_cpp_type(result.type());
+              span = GMutableSpan(type, result.data(), pixels.one_after_last()).slice(pixels);
+            }
+
+            if (is_input) {
+              parameter_builder.add_readonly_single_input(GSpan(span));
+            }
+            else {
+              parameter_builder.add_uninitialized_single_output(span);
+            }
+          }
+
+          mf::ContextBuilder context_builder;
+          procedure_executor_->call_auto(chunk_mask, parameter_builder, context_builder);
+
+          /* Convert the outputs that are stored in half precision back from their full precision
+           * buffers. */
+          for (const int i : IndexRange(parameters_count)) {
+            if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
+              continue;
+            }
+
+            Result &result = get_result(parameter_identifiers_[i]);
+            if (result.storage_type() == ResultStorageType::HalfCPU) {
+              math::float_to_half_array(reinterpret_cast<const float *>(buffers[i].data()),
+                                        result.half_texture() + pixels.first() * 4,
+                                        size_t(pixels.size()) * 4);
+            }
+          }
+        }
+      },
+      threading::individual_task_sizes([&](const int64_t i) { return chunks[i].size(); },
+                                       mask.size()));
+}
+
+IndexMask MultiFunctionProcedureOperation::compute_needed_pixels_mask(const int2 size,
+                                                                      IndexMaskMemory &memory)
+{
+  Region region = std::nullopt;
+  for (const DOutputSocket &output : output_sockets_to_output_identifiers_map_.keys()) {
+    region = bounds::merge(region, compute_needed_region(schedule_, output, size));
+  }
+
+  if (!region) {
+    return IndexMask();
+  }
+
+  /* The region spans entire rows, so the pixels are contiguous in memory. */
+  if (region->min.x == 0 && region->max.x == size.x) {
+    return IndexMask(IndexRange::from_begin_end(int64_t(region->min.y) * size.x,
+                                                int64_t(region->max.y) * size.x));
+  }
+
+  Vector<IndexMask::Initializer> rows;
+  rows.reserve(region->max.y - region->min.y);
+  for (const int64_t y : IndexRange::from_begin_end(region->min.y, region->max.y)) {
+    const int64_t row_start = y * size.x;
+    rows.append(IndexRange::from_begin_end(row_start + region->min.x, row_start + region->max.x));
+  }
+  return IndexMask::from_initializers(rows, memory);
+}
+
 void MultiFunctionProcedureOperation::build_procedure()
 {
   for (DNode node : compile_unit_) {
@@ -2,9 +2,15 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstdint>
 #include <memory>
 
+#include <xxhash.h>
+
+#include "MEM_guardedalloc.h"
+
 #include "BLI_assert.h"
+#include "BLI_hash.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.h"
 #include "BLI_math_base.hh"
@@ -24,10 +30,13 @@
 #include "BKE_node.hh"
 
 #include "COM_algorithm_compute_preview.hh"
+#include "COM_cached_node_outputs.hh"
 #include "COM_context.hh"
+#include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -51,12 +60,120 @@ NodeOperation::NodeOperation(Context &context, DNode node) : Operation(context),
 
 void NodeOperation::evaluate()
 {
-  const timeit::TimePoint before_time = timeit::Clock::now();
-  Operation::evaluate();
-  const timeit::TimePoint after_time = timeit::Clock::now();
-  if (context().profiler()) {
-    context().profiler()->set_node_evaluation_time(node_.instance_key(), after_time - before_time);
+  const timeit::Nanoseconds duration = this->evaluate_and_profile(node_->name, {node_});
+  Profiler *profiler = context().profiler();
+  if (profiler) {
+    profiler->set_node_evaluation_time(node_.instance_key(), duration);
+  }
+}
+
+void NodeOperation::compute_results()
+{
+  if (this->context().use_gpu() || !this->should_cache_outputs()) {
+    this->execute();
+    return;
+  }
+
+  CachedNodeOutputsContainer &cached_node_outputs =
+      this->context().cache_manager().cached_node_outputs;
+  const CachedNodeOutputsKey key(node_.instance_key(), this->compute_outputs_cache_hash());
+
+  if (const CachedNodeOutputs *cached_outputs = cached_node_outputs.get(key)) {
+    for (const bNodeSocket *output : node_->output_sockets()) {
+      Result &result = this->get_result(output->identifier);
+      if (result.should_compute()) {
+        result.wrap_external(*cached_outputs->get_output(output->identifier));
+      }
+    }
+    return;
+  }
+
+  this->execute();
+
+  /* The execution might have been canceled midway, like in the Denoise node, so the outputs might
+   * be incomplete and should not be cached. */
+  if (this->context().is_canceled()) {
+    return;
+  }
+
+  std::unique_ptr<CachedNodeOutputs> outputs = std::make_unique<CachedNodeOutputs>(
+      this->context());
+  for (const bNodeSocket *output : node_->output_sockets()) {
+    Result &result = this->get_result(output->identifier);
+    if (!result.should_compute()) {
+      continue;
+    }
+
+    /* Single values are cheap to compute, so they are not worth caching. */
+    if (!result.is_allocated() || result.is_single_value()) {
+      return;
+    }
+
+    /* Outputs that are passed through from inputs are cheap to compute, so they are not worth
+     * caching either. */
+    for (const bNodeSocket *input : node_->input_sockets()) {
+      if (result.data() == this->get_input(input->identifier).data()) {
+        return;
+      }
+    }
+
+    outputs->add_output(output->identifier, result);
+  }
+
+  cached_node_outputs.add(key, std::move(outputs));
+}
+
+/* Computes a hash of the contents of the given result, including its domain. */
+static uint64_t compute_result_content_hash(const Result &result)
+{
+  if (!result.is_allocated()) {
+    return 0;
   }
+
+  const Domain &domain = result.domain();
+  const RealizationOptions &realization_options = domain.realization_options;
+  const uint64_t domain_hash = get_default_hash(
+      domain.size,
+      XXH3_64bits(&domain.transformation, sizeof(domain.transformation)),
+      get_default_hash(int(realization_options.interpolation),
+                       realization_options.wrap_x,
+                       realization_options.wrap_y));
+
+  /* Half storage stores four half floats per pixel, see ResultStorageType::HalfCPU. */
+  const int64_t pixels_count = result.is_single_value() ? 1 :
+                                                          int64_t(domain.size.x) * domain.size.y;
+  const int64_t pixel_size = result.storage_type() == ResultStorageType::HalfCPU ?
+                                 4 * sizeof(uint16_t) :
+                                 result.channels_count() * sizeof(float);
+  const uint64_t data_hash = XXH3_64bits(result.data(), pixels_count * pixel_size);
+
+  return get_default_hash(int(result.type()), result.is_single_value(), domain_hash, data_hash);
+}
+
+uint64_t NodeOperation::compute_outputs_cache_hash()
+{
+  const bNode &node = this->bnode();
+  uint64_t hash = get_default_hash(
+      get_default_hash(node.typeinfo, node.id, int(this->context().get_precision())),
+      get_default_hash(node.custom1, node.custom2, node.custom3, node.custom4),
+      this->compute_cache_parameters_hash());
+
+  /* The storage of nodes is always allocated using the guarded allocator, so its size is known. */
+  if (node.storage) {
+    hash = get_default_hash(hash, XXH3_64bits(node.storage, MEM_allocN_len(node.storage)));
+  }
+
+  for (const bNodeSocket *input : node_->input_sockets()) {
+    hash = get_default_hash(hash, compute_result_content_hash(this->get_input(input->identifier)));
+  }
+
+  /* Different sets of needed outputs are cached separately, since only needed outputs are
+   * cached. */
+  for (const bNodeSocket *output : node_->output_sockets()) {
+    hash = get_default_hash(hash, this->get_result(output->identifier).should_compute());
+  }
+
+  return hash;
 }
 
 void NodeOperation::compute_preview()
@@ -115,4 +232,14 @@ bool NodeOperation::should_compute_output(StringRef identifier)
   return get_result(identifier).should_compute();
 }
 
+bool NodeOperation::should_cache_outputs()
+{
+  return false;
+}
+
+uint64_t NodeOperation::compute_cache_parameters_hash()
+{
+  return 0;
+}
+
 }  // namespace blender::compositor
@@ -2,11 +2,14 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstdint>
 #include <limits>
 #include <memory>
 
 #include "BLI_map.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_timeit.hh"
 #include "BLI_vector.hh"
 
 #include "COM_context.hh"
@@ -14,6 +17,7 @@
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_realize_on_domain_operation.hh"
 #include "COM_reduce_to_single_value_operation.hh"
 #include "COM_result.hh"
@@ -28,11 +32,13 @@ Operation::~Operation() = default;
 
 void Operation::evaluate()
 {
+  computed_pixels_count_.reset();
+
   evaluate_input_processors();
 
   reset_results();
 
-  execute();
+  compute_results();
 
   compute_preview();
 
@@ -146,6 +152,11 @@ void Operation::add_and_evaluate_input_processor(StringRef identifier, SimpleOpe
   processor->evaluate();
 }
 
+void Operation::compute_results()
+{
+  execute();
+}
+
 void Operation::compute_preview(){};
 
 Result &Operation::get_input(StringRef identifier) const
@@ -182,6 +193,58 @@ void Operation::release_unneeded_results()
   }
 }
 
+timeit::Nanoseconds Operation::evaluate_and_profile(const StringRef name,
+                                                   const Span<nodes::DNode> nodes)
+{
+  const timeit::TimePoint before_time = timeit::Clock::now();
+  Operation::evaluate();
+  const timeit::TimePoint after_time = timeit::Clock::now();
+
+  Profiler *profiler = context().profiler();
+  if (profiler) {
+    OperationProfile profile = this->compute_profile(before_time, after_time);
+    profile.name = name;
+    for (const nodes::DNode &node : nodes) {
+      profile.node_instance_keys.append(node.instance_key());
+      profile.node_names.append(node->name);
+    }
+    profiler->add_operation_profile(std::move(profile));
+  }
+
+  return after_time - before_time;
+}
+
+void Operation::set_computed_pixels_count(const int64_t pixels_count)
+{
+  computed_pixels_count_ = pixels_count;
+}
+
+OperationProfile Operation::compute_profile(const timeit::TimePoint start_time,
+                                            const timeit::TimePoint end_time) const
+{
+  OperationProfile profile;
+  profile.start_time = start_time;
+  profile.end_time = end_time;
+
+  /* Unneeded results were already released at this point, so only computed results remain
+   * allocated. */
+  for (const Result &result : results_.values()) {
+    if (!result.is_allocated()) {
+      continue;
+    }
+    if (result.is_single_value()) {
+      profile.pixels_count += 1;
+    }
+    else {
+      const int2 size = result.domain().size;
+      profile.pixels_count += computed_pixels_count_.value_or(int64_t(size.x) * size.y);
+    }
+    profile.allocated_size += result.allocated_size_in_bytes();
+  }
+
+  return profile;
+}
+
 Context &Operation::context() const
 {
   return context_;
@@ -0,0 +1,162 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <memory>
+#include <mutex>
+
+#include "BLI_function_ref.hh"
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+#include "COM_operation_task_graph.hh"
+
+namespace blender::compositor {
+
+OperationTaskGraph::OperationTaskGraph(Context &context) : context_(context)
+{
+  task_pool_ = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
+}
+
+OperationTaskGraph::~OperationTaskGraph()
+{
+  this->wait();
+
+  /* Worker tasks that are still pushed find no ready tasks and return immediately, but they still
+   * need to finish before the task pool is freed. */
+  BLI_task_pool_work_and_wait(task_pool_);
+  BLI_task_pool_free(task_pool_);
+}
+
+void OperationTaskGraph::add_operation(Operation &operation, Span<Operation *> dependencies)
+{
+  std::unique_ptr<Task> task = std::make_unique<Task>();
+  task->operation = &operation;
+  Task &added_task = *task;
+
+  {
+    std::scoped_lock lock(mutex_);
+    for (const Operation *dependency : dependencies) {
+      const std::unique_ptr<Task> *dependency_task = tasks_.lookup_ptr(dependency);
+      if (!dependency_task || (*dependency_task)->is_evaluated) {
+        continue;
+      }
+
+      /* An operation might use multiple results of the same operation, but it only depends on it
+       * once. */
+      Vector<Task *> &dependents = (*dependency_task)->dependents;
+      if (!dependents.is_empty() && dependents.last() == &added_task) {
+        continue;
+      }
+
+      dependents.append(&added_task);
+      added_task.remaining_dependencies_count++;
+    }
+
+    tasks_.add_new(&operation, std::move(task));
+    unevaluated_tasks_count_++;
+
+    if (added_task.remaining_dependencies_count != 0) {
+      return;
+    }
+    ready_tasks_.append(&added_task);
+  }
+
+  this->push_worker_tasks(1);
+}
+
+void OperationTaskGraph::wait_for_operation(const Operation &operation)
+{
+  std::unique_lock lock(mutex_);
+  const std::unique_ptr<Task> *task = tasks_.lookup_ptr(&operation);
+  if (!task) {
+    return;
+  }
+
+  const Task *waited_task = task->get();
+  this->wait_until(lock, [&]() { return waited_task->is_evaluated; });
+}
+
+void OperationTaskGraph::wait()
+{
+  std::unique_lock lock(mutex_);
+  this->wait_until(lock, [&]() { return unevaluated_tasks_count_ == 0; });
+}
+
+void OperationTaskGraph::evaluate_task(Task &task)
+{
+  /* Operations are still marked as evaluated when the evaluation is canceled, such that waiting
+   * threads are not blocked, the evaluator frees all results after cancellation anyway. */
+  if (!context_.is_canceled()) {
+    /* Isolate the evaluation, such that a thread that waits inside a parallel loop of the
+     * operation, possibly while holding the lock of a cached resource container, doesn't start
+     * evaluating another operation that might need the same lock. */
+    threading::isolate_task([&]() { task.operation->evaluate(); });
+  }
+
+  int ready_tasks_count = 0;
+  {
+    std::scoped_lock lock(mutex_);
+    task.is_evaluated = true;
+    unevaluated_tasks_count_--;
+    for (Task *dependent : task.dependents) {
+      dependent->remaining_dependencies_count--;
+      if (dependent->remaining_dependencies_count == 0) {
+        ready_tasks_.append(dependent);
+        ready_tasks_count++;
+      }
+    }
+  }
+
+  evaluated_condition_.notify_all();
+  this->push_worker_tasks(ready_tasks_count);
+}
+
+void OperationTaskGraph::push_worker_tasks(const int count)
+{
+  for (int i = 0; i < count; i++) {
+    BLI_task_pool_push(task_pool_, evaluate_ready_task, nullptr, false, nullptr);
+  }
+}
+
+void OperationTaskGraph::wait_until(std::unique_lock<std::mutex> &lock,
+                                    FunctionRef<bool()> condition)
+{
+  while (!condition()) {
+    /* No task is ready, so some task is being evaluated by another thread, wait until it
+     * finishes, at which point, the condition or the set of ready tasks might change. */
+    if (ready_tasks_.is_empty()) {
+      evaluated_condition_.wait(lock);
+      continue;
+    }
+
+    /* Evaluate one of the ready tasks while waiting. */
+    Task *task = ready_tasks_.pop_last();
+    lock.unlock();
+    this->evaluate_task(*task);
+    lock.lock();
+  }
+}
+
+void OperationTaskGraph::evaluate_ready_task(TaskPool *__restrict pool, void * /*task_data*/)
+{
+  OperationTaskGraph &graph = *static_cast<OperationTaskGraph *>(BLI_task_pool_user_data(pool));
+
+  Task *task;
+  {
+    std::scoped_lock lock(graph.mutex_);
+    if (graph.ready_tasks_.is_empty()) {
+      return;
+    }
+    task = graph.ready_tasks_.pop_last();
+  }
+
+  graph.evaluate_task(*task);
+}
+
+}  // namespace blender::compositor
@@ -15,6 +15,7 @@
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
@@ -53,6 +54,18 @@ int PixelOperation::maximum_number_of_outputs(Context &context)
   return std::numeric_limits<int>::max();
 }
 
+void PixelOperation::evaluate()
+{
+  /* Avoid building the name of the profile if there is no profiler. */
+  if (!context().profiler()) {
+    Operation::evaluate();
+    return;
+  }
+
+  const std::string name = "Pixel Operation (" + std::to_string(compile_unit_.size()) + " nodes)";
+  this->evaluate_and_profile(name, compile_unit_.as_span());
+}
+
 void PixelOperation::compute_preview()
 {
   for (const DOutputSocket &output : preview_outputs_) {
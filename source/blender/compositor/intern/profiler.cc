@@ -2,6 +2,17 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "BLI_fileops.hh"
+#include "BLI_serialize.hh"
+#include "BLI_span.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_node_types.h"
@@ -15,6 +26,17 @@
 
 namespace blender::compositor {
 
+timeit::Nanoseconds OperationProfile::duration() const
+{
+  return end_time - start_time;
+}
+
+double OperationProfile::throughput() const
+{
+  const double seconds = std::chrono::duration<double>(this->duration()).count();
+  return seconds > 0.0 ? double(pixels_count) / seconds : 0.0;
+}
+
 Map<bNodeInstanceKey, timeit::Nanoseconds> &Profiler::get_nodes_evaluation_times()
 {
   return nodes_evaluation_times_;
@@ -23,9 +45,102 @@ Map<bNodeInstanceKey, timeit::Nanoseconds> &Profiler::get_nodes_evaluation_times
 void Profiler::set_node_evaluation_time(bNodeInstanceKey node_instance_key,
                                         timeit::Nanoseconds time)
 {
+  std::scoped_lock lock(mutex_);
   nodes_evaluation_times_.lookup_or_add(node_instance_key, timeit::Nanoseconds::zero()) += time;
 }
 
+Span<OperationProfile> Profiler::get_operation_profiles() const
+{
+  return operation_profiles_;
+}
+
+void Profiler::add_operation_profile(OperationProfile profile)
+{
+  std::scoped_lock lock(mutex_);
+  const std::thread::id thread = std::this_thread::get_id();
+  profile.thread_index = int(threads_.first_index_of_try(thread));
+  if (profile.thread_index == -1) {
+    profile.thread_index = int(threads_.append_and_get_index(thread));
+  }
+  operation_profiles_.append(std::move(profile));
+}
+
+int64_t Profiler::get_peak_memory_usage() const
+{
+  std::scoped_lock lock(mutex_);
+  return peak_memory_usage_;
+}
+
+void Profiler::add_peak_memory_usage(int64_t peak_memory_usage)
+{
+  std::scoped_lock lock(mutex_);
+  peak_memory_usage_ = std::max(peak_memory_usage_, peak_memory_usage);
+}
+
+bool Profiler::write_chrome_trace(const char *filepath) const
+{
+  using namespace io::serialize;
+
+  std::scoped_lock lock(mutex_);
+
+  DictionaryValue root;
+  root.append_str("displayTimeUnit", "ms");
+  std::shared_ptr<ArrayValue> events = root.append_array("traceEvents");
+
+  /* Timestamps are in microseconds relative to the start of the first operation. */
+  timeit::TimePoint origin = timeit::Clock::now();
+  for (const OperationProfile &profile : operation_profiles_) {
+    origin = std::min(origin, profile.start_time);
+  }
+  auto to_microseconds = [](const timeit::Nanoseconds duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+
+  for (const int thread_index : threads_.index_range()) {
+    std::shared_ptr<DictionaryValue> event = events->append_dict();
+    event->append_str("name", "thread_name");
+    event->append_str("ph", "M");
+    event->append_int("pid", 0);
+    event->append_int("tid", thread_index);
+    event->append_dict("args")->append_str("name", "Thread " + std::to_string(thread_index));
+  }
+
+  for (const OperationProfile &profile : operation_profiles_) {
+    std::shared_ptr<DictionaryValue> event = events->append_dict();
+    event->append_str("name", profile.name);
+    event->append_str("cat", "operation");
+    event->append_str("ph", "X");
+    event->append_double("ts", to_microseconds(profile.start_time - origin));
+    event->append_double("dur", to_microseconds(profile.duration()));
+    event->append_int("pid", 0);
+    event->append_int("tid", profile.thread_index);
+
+    std::shared_ptr<DictionaryValue> args = event->append_dict("args");
+    args->append_int("pixels", profile.pixels_count);
+    args->append_int("allocated_bytes", profile.allocated_size);
+    args->append_double("megapixels_per_second", profile.throughput() / 1.0e6);
+    std::shared_ptr<ArrayValue> nodes = args->append_array("nodes");
+    for (const std::string &node_name : profile.node_names) {
+      nodes->append_str(node_name);
+    }
+  }
+
+  std::shared_ptr<DictionaryValue> memory_event = events->append_dict();
+  memory_event->append_str("name", "Peak Memory");
+  memory_event->append_str("ph", "C");
+  memory_event->append_double("ts", 0.0);
+  memory_event->append_int("pid", 0);
+  memory_event->append_dict("args")->append_int("bytes", peak_memory_usage_);
+
+  fstream stream(filepath, std::ios::out);
+  if (!stream.is_open()) {
+    return false;
+  }
+  JsonFormatter formatter;
+  formatter.serialize(stream, root);
+  return !stream.fail();
+}
+
 timeit::Nanoseconds Profiler::accumulate_node_group_times(const bNodeTree &node_tree,
                                                           bNodeInstanceKey instance_key)
 {
@@ -31,14 +31,20 @@ void ReduceToSingleValueOperation::execute()
 
   void *pixel = nullptr;
   bool need_to_free_pixel = false;
+  float4 color_pixel;
   if (context().use_gpu()) {
     /* Make sure any prior writes to the texture are reflected before downloading it. */
     GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
     pixel = GPU_texture_read(input, GPU_DATA_FLOAT, 0);
     need_to_free_pixel = true;
   }
+  else if (input.storage_type() == ResultStorageType::HalfCPU) {
+    /* Load the pixel to convert it to full precision. */
+    color_pixel = input.load_pixel<float4>(int2(0));
+    pixel = color_pixel;
+  }
   else {
-    pixel = input.float_texture();
+    pixel = input.data();
   }
 
   Result &result = get_result();
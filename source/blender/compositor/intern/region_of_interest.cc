@@ -0,0 +1,188 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <utility>
+
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "BKE_node.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_input_descriptor.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_scheduler.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+using TargetSocketPathInfo = DOutputSocket::TargetSocketPathInfo;
+
+/* -------------------------------------------------------------------- */
+/** \name Input Region Params
+ * \{ */
+
+InputRegionParams::InputRegionParams(DInputSocket input,
+                                     int2 input_size,
+                                     FunctionRef<Region(int2 output_size)> compute_output_region)
+    : compute_output_region_(compute_output_region),
+      input(input),
+      input_size(input_size),
+      input_region(Bounds<int2>(int2(0), input_size))
+{
+}
+
+Region InputRegionParams::compute_output_region(const int2 output_size) const
+{
+  return compute_output_region_(output_size);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Needed Region
+ * \{ */
+
+/* Returns true if the given input is guaranteed to be the input that defines the domain of its
+ * node, in which case, the outputs of the node have the same size as the input. This mirrors the
+ * logic in Operation::compute_domain, but since it is not known whether linked inputs will be
+ * single values until they are computed, linked inputs are assumed to be non single values. */
+static bool is_domain_input(DInputSocket input)
+{
+  const InputDescriptor descriptor = input_descriptor_from_input_socket(input.bsocket());
+  if (descriptor.expects_single_value ||
+      !descriptor.realization_options.realize_on_operation_domain)
+  {
+    return false;
+  }
+
+  for (const bNodeSocket *other_input : input.node()->input_sockets()) {
+    if (other_input == input.bsocket() || !other_input->is_available()) {
+      continue;
+    }
+
+    /* Unlinked inputs are single values, which can't be domain inputs. */
+    if (!get_output_linked_to_input(DInputSocket(input.context(), other_input))) {
+      continue;
+    }
+
+    const InputDescriptor other_descriptor = input_descriptor_from_input_socket(other_input);
+    if (other_descriptor.expects_single_value ||
+        !other_descriptor.realization_options.realize_on_operation_domain)
+    {
+      continue;
+    }
+
+    /* Inputs of equal priority are also rejected, since the order in which operations consider
+     * their inputs is not defined. */
+    if (other_descriptor.domain_priority <= descriptor.domain_priority) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* Computes the needed regions of outputs, caching the region of every output and size, since the
+ * same outputs are typically reached through many paths in the node tree. */
+class NeededRegionComputer {
+ private:
+  const Schedule &schedule_;
+  Map<std::pair<DOutputSocket, int2>, Region> regions_;
+
+ public:
+  NeededRegionComputer(const Schedule &schedule) : schedule_(schedule) {}
+
+  Region compute_output_region(const DOutputSocket output, const int2 size)
+  {
+    if (const Region *region = regions_.lookup_ptr({output, size})) {
+      return *region;
+    }
+
+    const Bounds<int2> entire_region = Bounds<int2>(int2(0), size);
+
+    Region region = std::nullopt;
+    /* Previews are computed from the entire result. */
+    if (output == find_preview_output_socket(output.node())) {
+      region = entire_region;
+    }
+    else {
+      output.foreach_target_socket([&](DInputSocket target,
+                                       const TargetSocketPathInfo & /*path_info*/) {
+        /* Nodes that are not part of the schedule are not evaluated. */
+        if (!schedule_.contains(target.node())) {
+          return;
+        }
+        region = bounds::merge(region, this->compute_input_region(target, size));
+      });
+    }
+
+    region = bounds::intersect(region, Region(entire_region));
+    regions_.add_new({output, size}, region);
+    return region;
+  }
+
+ private:
+  /* Computes the needed region of the given input assuming the result it receives has the given
+   * size. */
+  Region compute_input_region(const DInputSocket input, const int2 size)
+  {
+    const Bounds<int2> entire_region = Bounds<int2>(int2(0), size);
+
+    /* Inputs that do not define the domain of their node might be realized on a domain that is
+     * different from their own, so their entire result is assumed to be needed. */
+    if (!is_domain_input(input)) {
+      return entire_region;
+    }
+
+    const DNode node = input.node();
+
+    /* Pixel nodes compute each pixel from the same pixel of their inputs. */
+    if (is_pixel_node(node)) {
+      return this->compute_node_outputs_region(node, size);
+    }
+
+    if (!node->typeinfo->get_compositor_input_region) {
+      return entire_region;
+    }
+
+    const auto compute_output_region = [&](const int2 output_size) {
+      return this->compute_node_outputs_region(node, output_size);
+    };
+    InputRegionParams params(input, size, compute_output_region);
+    node->typeinfo->get_compositor_input_region(params);
+    return bounds::intersect(params.input_region, Region(entire_region));
+  }
+
+  /* Computes the union of the needed regions of all outputs of the given node assuming they have
+   * the given size. */
+  Region compute_node_outputs_region(const DNode node, const int2 size)
+  {
+    Region region = std::nullopt;
+    for (const bNodeSocket *output : node->output_sockets()) {
+      if (!output->is_available()) {
+        continue;
+      }
+      region = bounds::merge(region,
+                             this->compute_output_region(DOutputSocket(node.context(), output),
+                                                         size));
+    }
+    return region;
+  }
+};
+
+Region compute_needed_region(const Schedule &schedule, DOutputSocket output, int2 size)
+{
+  NeededRegionComputer computer(schedule);
+  return computer.compute_output_region(output, size);
+}
+
+/** \} */
+
+}  // namespace blender::compositor
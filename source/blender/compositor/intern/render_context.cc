@@ -2,7 +2,9 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_assert.h"
@@ -10,6 +12,8 @@
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -118,14 +122,23 @@ void FileOutput::add_meta_data(std::string key, std::string value)
 
 void FileOutput::save(Scene *scene)
 {
-  ReportList reports;
-  BKE_reports_init(&reports, RPT_STORE);
+  this->add_stamp_meta_data(scene);
+  this->write(scene);
+}
 
+void FileOutput::add_stamp_meta_data(Scene *scene)
+{
   /* Add scene stamp data as meta data as well as the custom meta data. */
   BKE_render_result_stamp_info(scene, nullptr, render_result_, false);
   for (const auto &field : meta_data_.items()) {
     BKE_render_result_stamp_data(render_result_, field.key.c_str(), field.value.c_str());
   }
+}
+
+void FileOutput::write(const Scene *scene)
+{
+  ReportList reports;
+  BKE_reports_init(&reports, RPT_STORE);
 
   BKE_image_render_write(
       &reports, render_result_, scene, true, path_.c_str(), &format_, save_as_render_);
@@ -133,6 +146,68 @@ void FileOutput::save(Scene *scene)
   BKE_reports_free(&reports);
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * File Output Writer
+ */
+
+/* The maximum number of file outputs that are scheduled and not yet written. File outputs store
+ * full resolution float images, so this is kept low, it just needs to be large enough for writing
+ * to be mostly hidden behind the evaluation of the next frame. */
+static constexpr int max_scheduled_file_outputs = 4;
+
+struct WriteTaskData {
+  std::unique_ptr<FileOutput> file_output;
+  /* A shallow copy of the scene at the time the file output was scheduled. */
+  Scene scene;
+};
+
+FileOutputWriter::FileOutputWriter()
+{
+  task_pool_ = BLI_task_pool_create_background(this, TASK_PRIORITY_HIGH);
+}
+
+FileOutputWriter::~FileOutputWriter()
+{
+  BLI_task_pool_work_and_wait(task_pool_);
+  BLI_task_pool_free(task_pool_);
+}
+
+void FileOutputWriter::schedule(std::unique_ptr<FileOutput> file_output, Scene *scene)
+{
+  file_output->add_stamp_meta_data(scene);
+
+  WriteTaskData *task_data = MEM_new<WriteTaskData>(__func__);
+  task_data->file_output = std::move(file_output);
+  std::memcpy(static_cast<void *>(&task_data->scene), scene, sizeof(Scene));
+
+  {
+    std::unique_lock lock(mutex_);
+    condition_.wait(lock, [&]() {
+      return scheduled_file_outputs_count_ < max_scheduled_file_outputs;
+    });
+    scheduled_file_outputs_count_++;
+  }
+
+  BLI_task_pool_push(task_pool_, write_task, task_data, true, [](TaskPool *, void *task_data) {
+    MEM_delete(static_cast<WriteTaskData *>(task_data));
+  });
+}
+
+void FileOutputWriter::write_task(TaskPool *__restrict pool, void *task_data)
+{
+  FileOutputWriter &writer = *static_cast<FileOutputWriter *>(BLI_task_pool_user_data(pool));
+  WriteTaskData &data = *static_cast<WriteTaskData *>(task_data);
+
+  /* Isolate the task such that multi-threaded image operations while writing do not cause this
+   * thread to start writing another file output. */
+  threading::isolate_task([&]() { data.file_output->write(&data.scene); });
+  data.file_output.reset();
+
+  std::scoped_lock lock(writer.mutex_);
+  writer.scheduled_file_outputs_count_--;
+  writer.condition_.notify_all();
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Render Context
  */
@@ -142,15 +217,22 @@ FileOutput &RenderContext::get_file_output(std::string path,
                                            int2 size,
                                            bool save_as_render)
 {
+  std::scoped_lock lock(file_outputs_mutex_);
   return *file_outputs_.lookup_or_add_cb(
       path, [&]() { return std::make_unique<FileOutput>(path, format, size, save_as_render); });
 }
 
-void RenderContext::save_file_outputs(Scene *scene)
+void RenderContext::save_file_outputs(Scene *scene, FileOutputWriter *writer)
 {
   for (std::unique_ptr<FileOutput> &file_output : file_outputs_.values()) {
-    file_output->save(scene);
+    if (writer) {
+      writer->schedule(std::move(file_output), scene);
+    }
+    else {
+      file_output->save(scene);
+    }
   }
+  file_outputs_.clear();
 }
 
 }  // namespace blender::compositor
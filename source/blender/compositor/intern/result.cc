@@ -4,9 +4,16 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_assert.h"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_interp.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
 
 #include "GPU_shader.hh"
@@ -426,7 +433,7 @@ void Result::increment_reference_count(int count)
     return;
   }
 
-  reference_count_ += count;
+  atomic_add_and_fetch_int32(&reference_count_, count);
 }
 
 void Result::release(const int count)
@@ -440,9 +447,9 @@ void Result::release(const int count)
   }
 
   /* Decrement the reference count, and if it is not yet zero, return and do not free. */
-  reference_count_ -= count;
-  BLI_assert(reference_count_ >= 0);
-  if (reference_count_ != 0) {
+  const int reference_count = atomic_sub_and_fetch_int32(&reference_count_, count);
+  BLI_assert(reference_count >= 0);
+  if (reference_count != 0) {
     return;
   }
 
@@ -476,13 +483,32 @@ void Result::free()
       gpu_texture_ = nullptr;
       break;
     case ResultStorageType::FloatCPU:
-      MEM_freeN(float_texture_);
+      if (is_from_pool_) {
+        context_->cpu_buffer_pool().release(float_texture_);
+      }
+      else {
+        MEM_freeN(float_texture_);
+      }
       float_texture_ = nullptr;
       break;
     case ResultStorageType::IntegerCPU:
-      MEM_freeN(integer_texture_);
+      if (is_from_pool_) {
+        context_->cpu_buffer_pool().release(integer_texture_);
+      }
+      else {
+        MEM_freeN(integer_texture_);
+      }
       integer_texture_ = nullptr;
       break;
+    case ResultStorageType::HalfCPU:
+      if (is_from_pool_) {
+        context_->cpu_buffer_pool().release(half_texture_);
+      }
+      else {
+        MEM_freeN(half_texture_);
+      }
+      half_texture_ = nullptr;
+      break;
   }
 }
 
@@ -529,11 +555,35 @@ bool Result::is_allocated() const
       return float_texture_ != nullptr;
     case ResultStorageType::IntegerCPU:
       return integer_texture_ != nullptr;
+    case ResultStorageType::HalfCPU:
+      return half_texture_ != nullptr;
   }
 
   return false;
 }
 
+int64_t Result::allocated_size_in_bytes() const
+{
+  if (is_single_value_ || is_external_ || master_ || !this->is_allocated()) {
+    return 0;
+  }
+
+  const int64_t pixels_count = int64_t(domain_.size.x) * domain_.size.y;
+  switch (storage_type_) {
+    case ResultStorageType::GPU:
+      return pixels_count * this->channels_count() *
+             (precision_ == ResultPrecision::Half ? 2 : 4);
+    case ResultStorageType::FloatCPU:
+    case ResultStorageType::IntegerCPU:
+      return pixels_count * this->channels_count() * 4;
+    case ResultStorageType::HalfCPU:
+      /* Half storage always stores 4 channels of 2 bytes. */
+      return pixels_count * 4 * 2;
+  }
+
+  return 0;
+}
+
 int Result::reference_count() const
 {
   /* If there is a master result, return its reference count instead. */
@@ -543,10 +593,26 @@ int Result::reference_count() const
   return reference_count_;
 }
 
+ResultStorageType Result::storage_type() const
+{
+  return storage_type_;
+}
+
+bool Result::should_use_half_storage(bool from_pool) const
+{
+  /* Only color images are stored in half precision on the CPU, since they take the most memory,
+   * while other types are often used for data like masks and coordinates that need full
+   * precision. Single values are stored in the single value members using full precision anyway,
+   * and results that are not allocated from the pool are either persistent results of cached
+   * resources or outputs of the compositor, which are expected to be full precision buffers. */
+  return from_pool && !is_single_value_ && type_ == ResultType::Color &&
+         precision_ == ResultPrecision::Half;
+}
+
 void Result::allocate_data(int2 size, bool from_pool)
 {
+  is_from_pool_ = from_pool;
   if (context_->use_gpu()) {
-    is_from_pool_ = from_pool;
     if (from_pool) {
       gpu_texture_ = context_->texture_pool().acquire(size, this->get_gpu_texture_format());
     }
@@ -560,25 +626,190 @@ void Result::allocate_data(int2 size, bool from_pool)
                                            nullptr);
     }
   }
+  else if (this->should_use_half_storage(from_pool)) {
+    /* The buffers of the pool store elements of 4 bytes, so each pixel of 4 half channels takes
+     * 2 elements. */
+    half_texture_ = static_cast<uint16_t *>(context_->cpu_buffer_pool().acquire(size, 2));
+    storage_type_ = ResultStorageType::HalfCPU;
+  }
   else {
+    void *buffer = nullptr;
+    if (from_pool) {
+      buffer = context_->cpu_buffer_pool().acquire(size, int(this->channels_count()));
+    }
+    else {
+      buffer = MEM_malloc_arrayN(
+          int64_t(size.x) * int64_t(size.y), this->channels_count() * sizeof(float), __func__);
+    }
+
     switch (type_) {
       case ResultType::Float:
       case ResultType::Vector:
       case ResultType::Color:
       case ResultType::Float2:
       case ResultType::Float3:
-        float_texture_ = static_cast<float *>(MEM_malloc_arrayN(
-            int64_t(size.x) * int64_t(size.y), this->channels_count() * sizeof(float), __func__));
+        float_texture_ = static_cast<float *>(buffer);
         storage_type_ = ResultStorageType::FloatCPU;
         break;
       case ResultType::Int:
       case ResultType::Int2:
-        integer_texture_ = static_cast<int *>(MEM_malloc_arrayN(
-            int64_t(size.x) * int64_t(size.y), this->channels_count() * sizeof(int), __func__));
+        integer_texture_ = static_cast<int *>(buffer);
         storage_type_ = ResultStorageType::IntegerCPU;
         break;
     }
   }
 }
 
+/* Identical to the wrap_coord function used by the BLI interpolation functions, see the
+ * sample_half_* methods. Returns -1 for coordinates outside of the image for border wrapping. */
+static int wrap_coordinate(const float coordinate, const int size, const math::InterpWrapMode wrap)
+{
+  switch (wrap) {
+    case math::InterpWrapMode::Extend:
+      return math::clamp(int(coordinate), 0, size - 1);
+    case math::InterpWrapMode::Repeat:
+      return int(floored_fmod(coordinate, float(size)));
+    case math::InterpWrapMode::Border: {
+      const int wrapped_coordinate = int(coordinate);
+      if (coordinate < 0.0f || wrapped_coordinate >= size) {
+        return -1;
+      }
+      return wrapped_coordinate;
+    }
+  }
+
+  BLI_assert_unreachable();
+  return -1;
+}
+
+float4 Result::sample_half_nearest(const float2 &texel_coordinates,
+                                   const math::InterpWrapMode wrap_x,
+                                   const math::InterpWrapMode wrap_y) const
+{
+  const int x = wrap_coordinate(texel_coordinates.x, domain_.size.x, wrap_x);
+  const int y = wrap_coordinate(texel_coordinates.y, domain_.size.y, wrap_y);
+  if (x < 0 || y < 0) {
+    return float4(0.0f);
+  }
+
+  return this->load_half_pixel(int2(x, y));
+}
+
+float4 Result::sample_half_bilinear(const float2 &texel_coordinates,
+                                    const math::InterpWrapMode wrap_x,
+                                    const math::InterpWrapMode wrap_y) const
+{
+  const int2 size = domain_.size;
+  float2 coordinates = texel_coordinates;
+  if (wrap_x == math::InterpWrapMode::Repeat) {
+    coordinates.x = floored_fmod(coordinates.x, float(size.x));
+  }
+  if (wrap_y == math::InterpWrapMode::Repeat) {
+    coordinates.y = floored_fmod(coordinates.y, float(size.y));
+  }
+
+  const float2 floored_coordinates = math::floor(coordinates);
+  const int2 lower_texel = int2(floored_coordinates);
+  int2 upper_texel = lower_texel + int2(1);
+
+  /* Wrap the upper samples for repeat wrapping, or return zero if the samples are completely
+   * outside of the image for border wrapping. */
+  if (wrap_x == math::InterpWrapMode::Repeat) {
+    if (upper_texel.x >= size.x) {
+      upper_texel.x = 0;
+    }
+  }
+  else if (wrap_x == math::InterpWrapMode::Border &&
+           (upper_texel.x < 0 || lower_texel.x >= size.x))
+  {
+    return float4(0.0f);
+  }
+  if (wrap_y == math::InterpWrapMode::Repeat) {
+    if (upper_texel.y >= size.y) {
+      upper_texel.y = 0;
+    }
+  }
+  else if (wrap_y == math::InterpWrapMode::Border &&
+           (upper_texel.y < 0 || lower_texel.y >= size.y))
+  {
+    return float4(0.0f);
+  }
+
+  /* Samples outside of the image are zero for border wrapping and clamped to the boundary
+   * otherwise. */
+  auto load_sample = [&](const int x, const int y) {
+    const bool is_outside_x = x < 0 || x >= size.x;
+    const bool is_outside_y = y < 0 || y >= size.y;
+    if ((wrap_x == math::InterpWrapMode::Border && is_outside_x) ||
+        (wrap_y == math::InterpWrapMode::Border && is_outside_y))
+    {
+      return float4(0.0f);
+    }
+    return this->load_half_pixel(math::clamp(int2(x, y), int2(0), size - int2(1)));
+  };
+
+  const float2 weights = coordinates - floored_coordinates;
+  const float4 lower_row = math::interpolate(load_sample(lower_texel.x, lower_texel.y),
+                                             load_sample(upper_texel.x, lower_texel.y),
+                                             weights.x);
+  const float4 upper_row = math::interpolate(load_sample(lower_texel.x, upper_texel.y),
+                                             load_sample(upper_texel.x, upper_texel.y),
+                                             weights.x);
+  return math::interpolate(lower_row, upper_row, weights.y);
+}
+
+/* Computes the cubic B-Spline filter weights of the samples at offsets -1, 0, 1, and 2 from the
+ * given fractional offset from the texel center, matching those of the BLI interpolation
+ * functions. */
+static float4 compute_cubic_bspline_weights(const float offset)
+{
+  const float offset_squared = offset * offset;
+  const float offset_cubed = offset_squared * offset;
+  const float w3 = offset_cubed * (1.0f / 6.0f);
+  const float w0 = -w3 + offset_squared * 0.5f - offset * 0.5f + 1.0f / 6.0f;
+  const float w1 = offset_cubed * 0.5f - offset_squared + 2.0f / 3.0f;
+  const float w2 = 1.0f - w0 - w1 - w3;
+  return float4(w0, w1, w2, w3);
+}
+
+float4 Result::sample_half_cubic_bspline(const float2 &texel_coordinates,
+                                         const math::InterpWrapMode wrap_x,
+                                         const math::InterpWrapMode wrap_y) const
+{
+  const int2 size = domain_.size;
+  const float2 floored_coordinates = math::floor(texel_coordinates);
+  const int2 base_texel = int2(floored_coordinates);
+
+  /* Return zero if the sample area is entirely outside of the image for border wrapping. */
+  if (wrap_x == math::InterpWrapMode::Border && (base_texel.x + 2 < 0 || base_texel.x > size.x)) {
+    return float4(0.0f);
+  }
+  if (wrap_y == math::InterpWrapMode::Border && (base_texel.y + 2 < 0 || base_texel.y > size.y)) {
+    return float4(0.0f);
+  }
+
+  const float2 offset = texel_coordinates - floored_coordinates;
+  const float4 x_weights = compute_cubic_bspline_weights(offset.x);
+  const float4 y_weights = compute_cubic_bspline_weights(offset.y);
+
+  float4 pixel_value = float4(0.0f);
+  for (const int j : IndexRange(4)) {
+    const int y = wrap_coordinate(float(base_texel.y + j - 1), size.y, wrap_y);
+    if (y < 0) {
+      continue;
+    }
+
+    for (const int i : IndexRange(4)) {
+      const int x = wrap_coordinate(float(base_texel.x + i - 1), size.x, wrap_x);
+      if (x < 0) {
+        continue;
+      }
+
+      pixel_value += this->load_half_pixel(int2(x, y)) * x_weights[i] * y_weights[j];
+    }
+  }
+
+  return pixel_value;
+}
+
 }  // namespace blender::compositor
@@ -28,6 +28,8 @@ void StaticCacheManager::reset()
   deriche_gaussian_coefficients.reset();
   van_vliet_gaussian_coefficients.reset();
   fog_glow_kernels.reset();
+  convolution_kernel_spectra.reset();
+  cached_node_outputs.reset();
 }
 
 void StaticCacheManager::skip_next_reset()
@@ -0,0 +1,325 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/**
+ * Tests that the blocked CPU implementations of the blur algorithms of the compositor match
+ * straightforward scalar implementations, see TestContext.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+#include "DNA_scene_types.h"
+
+#include "COM_context.hh"
+#include "COM_deriche_gaussian_coefficients.hh"
+#include "COM_domain.hh"
+#include "COM_result.hh"
+#include "COM_van_vliet_gaussian_coefficients.hh"
+
+#include "COM_algorithm_deriche_gaussian_blur.hh"
+#include "COM_algorithm_summed_area_table.hh"
+#include "COM_algorithm_symmetric_separable_blur.hh"
+#include "COM_algorithm_van_vliet_gaussian_blur.hh"
+
+#include "COM_test_context.hh"
+
+namespace blender::compositor::tests {
+
+/* An odd size that is not a multiple of the block sizes of any of the algorithms, such that the
+ * partial blocks and the remainder loops are exercised. */
+static const int2 IMAGE_SIZE = int2(101, 67);
+
+static float4 test_color(const int2 texel)
+{
+  const float2 coordinates = float2(texel) / float2(IMAGE_SIZE);
+  return float4(coordinates, float((texel.x ^ texel.y) & 1), float((texel.x * 7 + texel.y) % 5));
+}
+
+static Result create_color_image(Context &context)
+{
+  Result image = context.create_result(ResultType::Color);
+  image.allocate_texture(Domain(IMAGE_SIZE));
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      image.store_pixel(int2(x, y), test_color(int2(x, y)));
+    }
+  }
+  return image;
+}
+
+static Result create_channel_image(Context &context, const int channel)
+{
+  Result image = context.create_result(ResultType::Float);
+  image.allocate_texture(Domain(IMAGE_SIZE));
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      image.store_pixel(int2(x, y), test_color(int2(x, y))[channel]);
+    }
+  }
+  return image;
+}
+
+/* The color channels of 4-channel images are blurred together using SIMD instructions, while
+ * single channel images are blurred by the scalar implementation, so blurring each channel
+ * separately should give the same result. */
+static void test_symmetric_separable_blur(const float2 radius, const bool extend_bounds)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, ResultPrecision::Full, IMAGE_SIZE);
+
+  Result input = create_color_image(context);
+  Result output = context.create_result(ResultType::Color);
+  symmetric_separable_blur(context, input, output, radius, R_FILTER_GAUSS, extend_bounds);
+
+  for (const int channel : IndexRange(4)) {
+    Result channel_input = create_channel_image(context, channel);
+    Result channel_output = context.create_result(ResultType::Float);
+    symmetric_separable_blur(
+        context, channel_input, channel_output, radius, R_FILTER_GAUSS, extend_bounds);
+
+    ASSERT_EQ(channel_output.domain().size, output.domain().size);
+    const int2 size = output.domain().size;
+    for (const int y : IndexRange(size.y)) {
+      for (const int x : IndexRange(size.x)) {
+        const float expected = channel_output.load_pixel<float>(int2(x, y));
+        EXPECT_NEAR(output.load_pixel<float4>(int2(x, y))[channel], expected, 1e-5f);
+      }
+    }
+
+    channel_input.release();
+    channel_output.release();
+  }
+
+  input.release();
+  output.release();
+}
+
+TEST(compositor_blur, symmetric_separable_blur)
+{
+  test_symmetric_separable_blur(float2(5.0f, 3.0f), false);
+}
+
+TEST(compositor_blur, symmetric_separable_blur_extend_bounds)
+{
+  test_symmetric_separable_blur(float2(4.0f, 9.0f), true);
+}
+
+static void test_summed_area_table(const SummedAreaTableOperation operation)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, ResultPrecision::Full, IMAGE_SIZE);
+
+  Result input = create_color_image(context);
+  Result output = context.create_result(ResultType::Color, ResultPrecision::Full);
+  summed_area_table(context, input, output, operation);
+
+  /* Compute the table serially in double precision. */
+  Array<double4> table(int64_t(IMAGE_SIZE.x) * IMAGE_SIZE.y);
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    double4 row_sum = double4(0.0);
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      const double4 color = double4(test_color(int2(x, y)));
+      row_sum += operation == SummedAreaTableOperation::Square ? color * color : color;
+      const double4 below = y == 0 ? double4(0.0) : table[(y - 1) * IMAGE_SIZE.x + x];
+      table[y * IMAGE_SIZE.x + x] = below + row_sum;
+    }
+  }
+
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      const float4 expected = float4(table[y * IMAGE_SIZE.x + x]);
+      const float4 result = output.load_pixel<float4>(int2(x, y));
+      for (const int channel : IndexRange(4)) {
+        EXPECT_NEAR(result[channel], expected[channel], math::abs(expected[channel]) * 1e-4f);
+      }
+    }
+  }
+
+  input.release();
+  output.release();
+}
+
+TEST(compositor_blur, summed_area_table)
+{
+  test_summed_area_table(SummedAreaTableOperation::Identity);
+}
+
+TEST(compositor_blur, summed_area_table_square)
+{
+  test_summed_area_table(SummedAreaTableOperation::Square);
+}
+
+/* Applies the causal or non causal recursive filter of the given order to a single row, one pixel
+ * at a time, adding the filter outputs to the given output. This is the same difference equation
+ * as the blocked implementation, see recursive_filter_block. */
+template<int Order, bool IsCausal>
+static void filter_row(const Span<float4> row,
+                       const VecBase<float, Order> &feedforward_coefficients,
+                       const VecBase<float, Order> &feedback_coefficients,
+                       const float boundary_coefficient,
+                       MutableSpan<float4> output)
+{
+  const int width = row.size();
+  const float4 boundary = row[IsCausal ? 0 : width - 1];
+  float4 inputs[Order + 1];
+  float4 outputs[Order + 1];
+  for (const int i : IndexRange(Order + 1)) {
+    inputs[i] = boundary;
+    outputs[i] = boundary * boundary_coefficient;
+  }
+
+  for (const int i : IndexRange(width)) {
+    const int x = IsCausal ? i : width - 1 - i;
+    inputs[0] = row[x];
+    outputs[0] = float4(0.0f);
+    const int first_input_index = IsCausal ? 0 : 1;
+    for (int j = 0; j < Order; j++) {
+      outputs[0] += feedforward_coefficients[j] * inputs[first_input_index + j];
+      outputs[0] -= feedback_coefficients[j] * outputs[j + 1];
+    }
+    output[x] += outputs[0];
+    for (int j = Order; j >= 1; j--) {
+      inputs[j] = inputs[j - 1];
+      outputs[j] = outputs[j - 1];
+    }
+  }
+}
+
+/* Blurs the given image horizontally row by row using the given row filter, and returns the result
+ * transposed, such that applying it twice blurs the image in both directions. */
+static Array<float4> blur_pass_transposed(
+    const Span<float4> image,
+    const int2 size,
+    const FunctionRef<void(Span<float4> row, MutableSpan<float4> output)> filter_row_fn)
+{
+  Array<float4> transposed(image.size());
+  Array<float4> row_output(size.x);
+  for (const int y : IndexRange(size.y)) {
+    row_output.fill(float4(0.0f));
+    filter_row_fn(image.slice(int64_t(y) * size.x, size.x), row_output);
+    for (const int x : IndexRange(size.x)) {
+      transposed[int64_t(x) * size.y + y] = row_output[x];
+    }
+  }
+  return transposed;
+}
+
+static Array<float4> recursive_blur_reference(
+    const float2 sigma,
+    const FunctionRef<void(float sigma, Span<float4> row, MutableSpan<float4> output)>
+        filter_row_fn)
+{
+  Array<float4> image(int64_t(IMAGE_SIZE.x) * IMAGE_SIZE.y);
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      image[int64_t(y) * IMAGE_SIZE.x + x] = test_color(int2(x, y));
+    }
+  }
+
+  const Array<float4> horizontal = blur_pass_transposed(
+      image, IMAGE_SIZE, [&](const Span<float4> row, MutableSpan<float4> output) {
+        filter_row_fn(sigma.x, row, output);
+      });
+  return blur_pass_transposed(horizontal,
+                              int2(IMAGE_SIZE.y, IMAGE_SIZE.x),
+                              [&](const Span<float4> row, MutableSpan<float4> output) {
+                                filter_row_fn(sigma.y, row, output);
+                              });
+}
+
+static void expect_image_near(const Result &result, const Span<float4> expected)
+{
+  ASSERT_EQ(result.domain().size, IMAGE_SIZE);
+  for (const int y : IndexRange(IMAGE_SIZE.y)) {
+    for (const int x : IndexRange(IMAGE_SIZE.x)) {
+      const float4 expected_color = expected[int64_t(y) * IMAGE_SIZE.x + x];
+      const float4 color = result.load_pixel<float4>(int2(x, y));
+      for (const int channel : IndexRange(4)) {
+        EXPECT_NEAR(color[channel], expected_color[channel], 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(compositor_blur, deriche_gaussian_blur)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, ResultPrecision::Full, IMAGE_SIZE);
+
+  const float2 sigma = float2(4.0f, 12.0f);
+  Result input = create_color_image(context);
+  Result output = context.create_result(ResultType::Color);
+  deriche_gaussian_blur(context, input, output, sigma);
+
+  const Array<float4> expected = recursive_blur_reference(
+      sigma, [&](const float row_sigma, const Span<float4> row, MutableSpan<float4> row_output) {
+        const DericheGaussianCoefficients &coefficients =
+            context.cache_manager().deriche_gaussian_coefficients.get(context, row_sigma);
+        const float4 feedback_coefficients = float4(coefficients.feedback_coefficients());
+        filter_row<4, true>(row,
+                            float4(coefficients.causal_feedforward_coefficients()),
+                            feedback_coefficients,
+                            float(coefficients.causal_boundary_coefficient()),
+                            row_output);
+        filter_row<4, false>(row,
+                             float4(coefficients.non_causal_feedforward_coefficients()),
+                             feedback_coefficients,
+                             float(coefficients.non_causal_boundary_coefficient()),
+                             row_output);
+      });
+  expect_image_near(output, expected);
+
+  input.release();
+  output.release();
+}
+
+TEST(compositor_blur, van_vliet_gaussian_blur)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, ResultPrecision::Full, IMAGE_SIZE);
+
+  const float2 sigma = float2(40.0f, 33.0f);
+  Result input = create_color_image(context);
+  Result output = context.create_result(ResultType::Color);
+  van_vliet_gaussian_blur(context, input, output, sigma);
+
+  const Array<float4> expected = recursive_blur_reference(
+      sigma, [&](const float row_sigma, const Span<float4> row, MutableSpan<float4> row_output) {
+        const VanVlietGaussianCoefficients &coefficients =
+            context.cache_manager().van_vliet_gaussian_coefficients.get(context, row_sigma);
+        filter_row<2, true>(row,
+                            float2(coefficients.first_causal_feedforward_coefficients()),
+                            float2(coefficients.first_feedback_coefficients()),
+                            float(coefficients.first_causal_boundary_coefficient()),
+                            row_output);
+        filter_row<2, false>(row,
+                             float2(coefficients.first_non_causal_feedforward_coefficients()),
+                             float2(coefficients.first_feedback_coefficients()),
+                             float(coefficients.first_non_causal_boundary_coefficient()),
+                             row_output);
+        filter_row<2, true>(row,
+                            float2(coefficients.second_causal_feedforward_coefficients()),
+                            float2(coefficients.second_feedback_coefficients()),
+                            float(coefficients.second_causal_boundary_coefficient()),
+                            row_output);
+        filter_row<2, false>(row,
+                             float2(coefficients.second_non_causal_feedforward_coefficients()),
+                             float2(coefficients.second_feedback_coefficients()),
+                             float(coefficients.second_non_causal_boundary_coefficient()),
+                             row_output);
+      });
+  expect_image_near(output, expected);
+
+  input.release();
+  output.release();
+}
+
+}  // namespace blender::compositor::tests
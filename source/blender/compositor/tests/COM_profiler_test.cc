@@ -0,0 +1,238 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/**
+ * Tests the operation statistics collected by the profiler of the compositor and their export as
+ * a trace.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "testing/testing.h"
+
+#include "BLI_fileops.h"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_serialize.hh"
+#include "BLI_tempfile.h"
+#include "BLI_timeit.hh"
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_operation.hh"
+#include "COM_profiler.hh"
+#include "COM_result.hh"
+
+#include "COM_test_context.hh"
+
+namespace blender::compositor::tests {
+
+static const int2 IMAGE_SIZE = int2(10, 8);
+/* The image output and the single value output, which counts as a single pixel. */
+static const int64_t PIXELS_COUNT = int64_t(IMAGE_SIZE.x) * IMAGE_SIZE.y + 1;
+/* The image output with four full precision channels, single values are not counted. */
+static const int64_t ALLOCATED_SIZE = int64_t(IMAGE_SIZE.x) * IMAGE_SIZE.y * 4 * 4;
+
+/* A test context that profiles the operations evaluated with it using the given profiler. */
+class ProfiledTestContext : public TestContext {
+ private:
+  Profiler &profiler_;
+
+ public:
+  ProfiledTestContext(TexturePool &texture_pool, Profiler &profiler)
+      : TestContext(texture_pool, ResultPrecision::Full, IMAGE_SIZE), profiler_(profiler)
+  {
+  }
+
+  Profiler *profiler() const override
+  {
+    return &profiler_;
+  }
+};
+
+/* An operation with an image output, a single value output, and an output that is not needed,
+ * which profiles its evaluation the same way node operations do. If a computed pixels count is
+ * given, the operation declares that it only computed that many pixels of its image output, like
+ * pixel operations do when only a region of their outputs is needed. */
+class ProfiledTestOperation : public Operation {
+ private:
+  std::optional<int64_t> computed_pixels_count_;
+
+ public:
+  ProfiledTestOperation(Context &context,
+                        std::optional<int64_t> computed_pixels_count = std::nullopt)
+      : Operation(context), computed_pixels_count_(computed_pixels_count)
+  {
+    this->populate_result("Image", context.create_result(ResultType::Color));
+    this->populate_result("Value", context.create_result(ResultType::Float));
+
+    Result unneeded_result = context.create_result(ResultType::Color);
+    unneeded_result.set_initial_reference_count(0);
+    this->populate_result("Unneeded", unneeded_result);
+  }
+
+  void evaluate() override
+  {
+    this->evaluate_and_profile("Test Operation", {});
+  }
+
+ protected:
+  void execute() override
+  {
+    Result &image = this->get_result("Image");
+    image.allocate_texture(Domain(IMAGE_SIZE));
+    for (const int y : IndexRange(IMAGE_SIZE.y)) {
+      for (const int x : IndexRange(IMAGE_SIZE.x)) {
+        image.store_pixel(int2(x, y), float4(0.0f));
+      }
+    }
+
+    Result &value = this->get_result("Value");
+    value.allocate_single_value();
+    value.set_single_value(1.0f);
+
+    this->get_result("Unneeded").allocate_texture(Domain(IMAGE_SIZE));
+
+    if (computed_pixels_count_) {
+      this->set_computed_pixels_count(*computed_pixels_count_);
+    }
+  }
+};
+
+TEST(compositor_profiler, operation_statistics)
+{
+  TestTexturePool texture_pool;
+  Profiler profiler;
+  ProfiledTestContext context(texture_pool, profiler);
+
+  ProfiledTestOperation operation(context);
+  operation.evaluate();
+
+  ASSERT_EQ(profiler.get_operation_profiles().size(), 1);
+  const OperationProfile &profile = profiler.get_operation_profiles().first();
+  EXPECT_EQ(profile.name, "Test Operation");
+  EXPECT_EQ(profile.thread_index, 0);
+  EXPECT_GE(profile.duration().count(), 0);
+
+  /* The unneeded output was released after evaluation, so it is not counted. */
+  EXPECT_EQ(profile.pixels_count, PIXELS_COUNT);
+  EXPECT_EQ(profile.allocated_size, ALLOCATED_SIZE);
+
+  operation.free_results();
+}
+
+TEST(compositor_profiler, computed_pixels_count)
+{
+  TestTexturePool texture_pool;
+  Profiler profiler;
+  ProfiledTestContext context(texture_pool, profiler);
+
+  /* Only the pixels that were actually computed are counted, the single value still counts as a
+   * single pixel, and the whole image is still allocated. */
+  ProfiledTestOperation operation(context, 20);
+  operation.evaluate();
+
+  ASSERT_EQ(profiler.get_operation_profiles().size(), 1);
+  const OperationProfile &profile = profiler.get_operation_profiles().first();
+  EXPECT_EQ(profile.pixels_count, 21);
+  EXPECT_EQ(profile.allocated_size, ALLOCATED_SIZE);
+
+  operation.free_results();
+}
+
+TEST(compositor_profiler, thread_indices)
+{
+  Profiler profiler;
+  auto add_profile = [&]() { profiler.add_operation_profile(OperationProfile()); };
+
+  add_profile();
+  std::thread(add_profile).join();
+  add_profile();
+
+  /* Threads are indexed in the order in which they first added a profile. */
+  const Span<OperationProfile> profiles = profiler.get_operation_profiles();
+  ASSERT_EQ(profiles.size(), 3);
+  EXPECT_EQ(profiles[0].thread_index, 0);
+  EXPECT_EQ(profiles[1].thread_index, 1);
+  EXPECT_EQ(profiles[2].thread_index, 0);
+}
+
+TEST(compositor_profiler, throughput)
+{
+  OperationProfile profile;
+  profile.start_time = timeit::TimePoint();
+  profile.end_time = profile.start_time + std::chrono::milliseconds(500);
+  profile.pixels_count = 1000;
+  EXPECT_DOUBLE_EQ(profile.throughput(), 2000.0);
+
+  /* Operations that took no measurable time have no throughput. */
+  profile.end_time = profile.start_time;
+  EXPECT_EQ(profile.throughput(), 0.0);
+}
+
+TEST(compositor_profiler, peak_memory_usage)
+{
+  Profiler profiler;
+  profiler.add_peak_memory_usage(1024);
+  profiler.add_peak_memory_usage(4096);
+  profiler.add_peak_memory_usage(2048);
+  EXPECT_EQ(profiler.get_peak_memory_usage(), 4096);
+}
+
+TEST(compositor_profiler, write_chrome_trace)
+{
+  TestTexturePool texture_pool;
+  Profiler profiler;
+  ProfiledTestContext context(texture_pool, profiler);
+
+  ProfiledTestOperation operation(context);
+  for ([[maybe_unused]] const int i : IndexRange(2)) {
+    operation.evaluate();
+    operation.free_results();
+  }
+  profiler.add_peak_memory_usage(4096);
+
+  char temp_dir[FILE_MAX];
+  BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), temp_dir, "blender_compositor_profiler_test.json");
+  ASSERT_TRUE(profiler.write_chrome_trace(filepath));
+
+  std::ifstream stream(filepath);
+  io::serialize::JsonFormatter formatter;
+  const std::unique_ptr<io::serialize::Value> value = formatter.deserialize(stream);
+  stream.close();
+  BLI_delete(filepath, false, false);
+
+  ASSERT_NE(value, nullptr);
+  const io::serialize::DictionaryValue *root = value->as_dictionary_value();
+  ASSERT_NE(root, nullptr);
+  const io::serialize::ArrayValue *events = root->lookup_array("traceEvents");
+  ASSERT_NE(events, nullptr);
+
+  /* A thread name, an event for each of the two evaluations, and the peak memory counter. */
+  ASSERT_EQ(events->elements().size(), 4);
+
+  const io::serialize::DictionaryValue *event = events->elements()[1]->as_dictionary_value();
+  ASSERT_NE(event, nullptr);
+  EXPECT_EQ(event->lookup_str("name").value_or(""), "Test Operation");
+  EXPECT_EQ(event->lookup_str("ph").value_or(""), "X");
+  const io::serialize::DictionaryValue *args = event->lookup_dict("args");
+  ASSERT_NE(args, nullptr);
+  EXPECT_EQ(args->lookup_int("pixels").value_or(0), PIXELS_COUNT);
+  EXPECT_EQ(args->lookup_int("allocated_bytes").value_or(0), ALLOCATED_SIZE);
+
+  const io::serialize::DictionaryValue *memory_event =
+      events->elements()[3]->as_dictionary_value();
+  ASSERT_NE(memory_event, nullptr);
+  EXPECT_EQ(memory_event->lookup_dict("args")->lookup_int("bytes").value_or(0), 4096);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_ID.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_vec_types.h"
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_result.hh"
+#include "COM_texture_pool.hh"
+
+namespace blender::compositor::tests {
+
+/* A texture pool that is never used, since the test context evaluates on the CPU. */
+class TestTexturePool : public TexturePool {
+ private:
+  GPUTexture *allocate_texture(int2 /*size*/, eGPUTextureFormat /*format*/) override
+  {
+    return nullptr;
+  }
+};
+
+/* A minimal CPU context that provides what algorithms and operations need, such that they can be
+ * evaluated directly on generated images, without a node tree or a render result. */
+class TestContext : public Context {
+ private:
+  Scene scene_ = {};
+  bNodeTree node_tree_ = {};
+  ResultPrecision precision_;
+  int2 size_;
+
+ public:
+  TestContext(TexturePool &texture_pool, ResultPrecision precision, int2 size)
+      : Context(texture_pool), precision_(precision), size_(size)
+  {
+  }
+
+  const Scene &get_scene() const override
+  {
+    return scene_;
+  }
+
+  const bNodeTree &get_node_tree() const override
+  {
+    return node_tree_;
+  }
+
+  bool use_gpu() const override
+  {
+    return false;
+  }
+
+  eCompositorDenoiseQaulity get_denoise_quality() const override
+  {
+    return SCE_COMPOSITOR_DENOISE_HIGH;
+  }
+
+  bool use_file_output() const override
+  {
+    return false;
+  }
+
+  bool should_compute_node_previews() const override
+  {
+    return false;
+  }
+
+  bool use_composite_output() const override
+  {
+    return false;
+  }
+
+  const RenderData &get_render_data() const override
+  {
+    return scene_.r;
+  }
+
+  int2 get_render_size() const override
+  {
+    return size_;
+  }
+
+  rcti get_compositing_region() const override
+  {
+    return rcti{0, size_.x, 0, size_.y};
+  }
+
+  Result get_output_result() override
+  {
+    return this->create_result(ResultType::Color);
+  }
+
+  Result get_viewer_output_result(Domain /*domain*/,
+                                  bool /*is_data*/,
+                                  ResultPrecision /*precision*/) override
+  {
+    return this->create_result(ResultType::Color);
+  }
+
+  Result get_pass(const Scene * /*scene*/,
+                  int /*view_layer*/,
+                  const char * /*pass_name*/) override
+  {
+    return this->create_result(ResultType::Color);
+  }
+
+  StringRef get_view_name() const override
+  {
+    return "";
+  }
+
+  ResultPrecision get_precision() const override
+  {
+    return precision_;
+  }
+
+  void set_info_message(StringRef /*message*/) const override {}
+
+  IDRecalcFlag query_id_recalc_flag(ID * /*id*/) const override
+  {
+    return IDRecalcFlag(0);
+  }
+};
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,153 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/**
+ * Benchmarks for the CPU implementations of the blur algorithms of the compositor. The
+ * algorithms are evaluated directly on generated images through a minimal context, see
+ * TestContext.
+ */
+
+#include <string>
+
+#include "testing/testing.h"
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_timeit.hh"
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_result.hh"
+#include "COM_utilities.hh"
+
+#include "COM_algorithm_deriche_gaussian_blur.hh"
+#include "COM_algorithm_summed_area_table.hh"
+#include "COM_algorithm_symmetric_separable_blur.hh"
+#include "COM_algorithm_symmetric_separable_blur_variable_size.hh"
+#include "COM_algorithm_van_vliet_gaussian_blur.hh"
+
+#include "../COM_test_context.hh"
+
+namespace blender::compositor::tests {
+
+static const int2 IMAGE_SIZE = int2(1920, 1080);
+
+static Result create_color_image(Context &context)
+{
+  Result image = context.create_result(ResultType::Color);
+  image.allocate_texture(Domain(IMAGE_SIZE));
+  parallel_for(IMAGE_SIZE, [&](const int2 texel) {
+    const float2 coordinates = float2(texel) / float2(IMAGE_SIZE);
+    image.store_pixel(texel, float4(coordinates, float((texel.x ^ texel.y) & 1), 1.0f));
+  });
+  return image;
+}
+
+static Result create_radius_image(Context &context, const int maximum_radius)
+{
+  Result image = context.create_result(ResultType::Float);
+  image.allocate_texture(Domain(IMAGE_SIZE));
+  parallel_for(IMAGE_SIZE, [&](const int2 texel) {
+    image.store_pixel(texel, float(texel.x * maximum_radius / IMAGE_SIZE.x));
+  });
+  return image;
+}
+
+static void test_blur_perf(const ResultPrecision precision)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, precision, IMAGE_SIZE);
+  Result input = create_color_image(context);
+
+  for (const int radius : {5, 25, 100}) {
+    /* Evaluate once before timing to compute the cached blur weights. */
+    for (const bool is_warmup : {true, false}) {
+      Result output = context.create_result(ResultType::Color);
+      {
+        const std::string name = is_warmup ? "warmup" : "blur_" + std::to_string(radius);
+        SCOPED_TIMER(name);
+        symmetric_separable_blur(context, input, output, float2(radius));
+      }
+      output.release();
+    }
+  }
+
+  for (const int maximum_radius : {5, 25, 100}) {
+    Result radius = create_radius_image(context, maximum_radius);
+    for (const bool is_warmup : {true, false}) {
+      Result output = context.create_result(ResultType::Color);
+      {
+        const std::string name = is_warmup ? "warmup" :
+                                             "variable_blur_" + std::to_string(maximum_radius);
+        SCOPED_TIMER(name);
+        symmetric_separable_blur_variable_size(context, input, radius, output);
+      }
+      output.release();
+    }
+    radius.release();
+  }
+
+  input.release();
+}
+
+static void test_recursive_blur_perf(const ResultPrecision precision)
+{
+  TestTexturePool texture_pool;
+  TestContext context(texture_pool, precision, IMAGE_SIZE);
+  Result input = create_color_image(context);
+
+  for (const float sigma : {10.0f, 50.0f}) {
+    /* Evaluate once before timing to compute the cached filter coefficients. */
+    for (const bool is_warmup : {true, false}) {
+      Result output = context.create_result(ResultType::Color);
+      {
+        const std::string name = is_warmup ? "warmup" :
+                                             "recursive_blur_" + std::to_string(int(sigma));
+        SCOPED_TIMER(name);
+        if (sigma < 32.0f) {
+          deriche_gaussian_blur(context, input, output, float2(sigma));
+        }
+        else {
+          van_vliet_gaussian_blur(context, input, output, float2(sigma));
+        }
+      }
+      output.release();
+    }
+  }
+
+  for (const SummedAreaTableOperation operation :
+       {SummedAreaTableOperation::Identity, SummedAreaTableOperation::Square})
+  {
+    Result output = context.create_result(ResultType::Color, ResultPrecision::Full);
+    {
+      SCOPED_TIMER(operation == SummedAreaTableOperation::Identity ? "summed_area_table" :
+                                                                     "summed_area_table_square");
+      summed_area_table(context, input, output, operation);
+    }
+    output.release();
+  }
+
+  input.release();
+}
+
+TEST(compositor_blur, blur_perf_full_precision)
+{
+  test_blur_perf(ResultPrecision::Full);
+}
+
+TEST(compositor_blur, blur_perf_half_precision)
+{
+  test_blur_perf(ResultPrecision::Half);
+}
+
+TEST(compositor_blur, recursive_blur_perf_full_precision)
+{
+  test_recursive_blur_perf(ResultPrecision::Full);
+}
+
+TEST(compositor_blur, recursive_blur_perf_half_precision)
+{
+  test_recursive_blur_perf(ResultPrecision::Half);
+}
+
+}  // namespace blender::compositor::tests
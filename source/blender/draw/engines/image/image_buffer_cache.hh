@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "BLI_vector.hh"
 
 #include "IMB_colormanagement.hh"
@@ -19,10 +21,12 @@ namespace blender::image_engine {
 struct FloatImageBuffer {
   ImBuf *source_buffer = nullptr;
   ImBuf *float_buffer = nullptr;
+  /** Number of times the source buffer has been halved to get the resolution of float_buffer. */
+  int mip_level = 0;
   bool is_used = true;
 
-  FloatImageBuffer(ImBuf *source_buffer, ImBuf *float_buffer)
-      : source_buffer(source_buffer), float_buffer(float_buffer)
+  FloatImageBuffer(ImBuf *source_buffer, ImBuf *float_buffer, int mip_level)
+      : source_buffer(source_buffer), float_buffer(float_buffer), mip_level(mip_level)
   {
   }
 
@@ -30,6 +34,7 @@ struct FloatImageBuffer {
   {
     source_buffer = other.source_buffer;
     float_buffer = other.float_buffer;
+    mip_level = other.mip_level;
     is_used = other.is_used;
     other.source_buffer = nullptr;
     other.float_buffer = nullptr;
@@ -46,6 +51,7 @@ struct FloatImageBuffer {
   {
     this->source_buffer = other.source_buffer;
     this->float_buffer = other.float_buffer;
+    this->mip_level = other.mip_level;
     is_used = other.is_used;
     other.source_buffer = nullptr;
     other.float_buffer = nullptr;
@@ -62,13 +68,23 @@ struct FloatImageBuffer {
  *
  * For this reason we store the float buffer in separate image buffers. The FloatBufferCache keep
  * track of the cached buffers and if they are still used.
+ *
+ * When zoomed out, a downscaled (mip level) float buffer of a byte image is used instead of the
+ * full resolution one. The byte buffer is scaled down before the conversion, so the colorspace
+ * conversion only runs on the pixels that can be displayed and the full resolution float copy,
+ * which takes four times the memory of the byte buffer, is only created when it is needed.
  */
 struct FloatBufferCache {
  private:
   Vector<FloatImageBuffer> cache_;
 
  public:
-  ImBuf *cached_float_buffer(ImBuf *image_buffer)
+  /**
+   * Get a float buffer with the pixels of image_buffer. For byte buffers a mip_level higher than
+   * zero returns a buffer of which the resolution is halved mip_level times. Float image buffers
+   * are always returned as is.
+   */
+  ImBuf *cached_float_buffer(ImBuf *image_buffer, const int mip_level = 0)
   {
     /* Check if we can use the float buffer of the given image_buffer. */
     if (image_buffer->float_buffer.data != nullptr) {
@@ -82,22 +98,41 @@ struct FloatBufferCache {
 
     /* Do we have a cached float buffer. */
     for (FloatImageBuffer &item : cache_) {
-      if (item.source_buffer == image_buffer) {
+      if (item.source_buffer == image_buffer && item.mip_level == mip_level) {
         item.is_used = true;
         return item.float_buffer;
       }
     }
 
+    if (mip_level > 0) {
+      ImBuf *new_imbuf = create_mip_level_float_buffer(image_buffer, mip_level);
+      cache_.append(FloatImageBuffer(image_buffer, new_imbuf, mip_level));
+      return new_imbuf;
+    }
+
     /* Generate a new float buffer. */
     IMB_float_from_rect(image_buffer);
     ImBuf *new_imbuf = IMB_allocImBuf(image_buffer->x, image_buffer->y, image_buffer->planes, 0);
 
     IMB_assign_float_buffer(new_imbuf, IMB_steal_float_buffer(image_buffer), IB_TAKE_OWNERSHIP);
 
-    cache_.append(FloatImageBuffer(image_buffer, new_imbuf));
+    cache_.append(FloatImageBuffer(image_buffer, new_imbuf, 0));
     return new_imbuf;
   }
 
+  /**
+   * Remove the downscaled float buffers of the given image buffer. Needed when the pixels of the
+   * image buffer have changed, as only the full resolution float buffer is partially updated.
+   */
+  void remove_mip_levels(const ImBuf *image_buffer)
+  {
+    for (int64_t i = cache_.size() - 1; i >= 0; i--) {
+      if (cache_[i].source_buffer == image_buffer && cache_[i].mip_level != 0) {
+        cache_.remove_and_reorder(i);
+      }
+    }
+  }
+
   void reset_usage_flags()
   {
     for (FloatImageBuffer &buffer : cache_) {
@@ -110,7 +145,6 @@ struct FloatBufferCache {
     for (FloatImageBuffer &item : cache_) {
       if (item.source_buffer == image_buffer) {
         item.is_used = true;
-        return;
       }
     }
   }
@@ -128,6 +162,20 @@ struct FloatBufferCache {
   {
     cache_.clear();
   }
+
+ private:
+  static ImBuf *create_mip_level_float_buffer(const ImBuf *image_buffer, const int mip_level)
+  {
+    const int width = std::max(image_buffer->x >> mip_level, 1);
+    const int height = std::max(image_buffer->y >> mip_level, 1);
+    ImBuf *new_imbuf = IMB_scale_into_new(image_buffer, width, height, IMBScaleFilter::Box, true);
+    /* Alpha mode is needed to convert the byte buffer the same way as the full resolution one. */
+    new_imbuf->flags |= image_buffer->flags & (IB_alphamode_premul | IB_alphamode_channel_packed |
+                                               IB_alphamode_ignore);
+    IMB_float_from_rect(new_imbuf);
+    imb_freerectImBuf(new_imbuf);
+    return new_imbuf;
+  }
 };
 
 }  // namespace blender::image_engine
@@ -2,10 +2,14 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cmath>
+
 #include "image_drawing_mode.hh"
 #include "image_instance.hh"
 #include "image_shader.hh"
 
+#include "BLI_math_vector.hh"
+
 #include "BKE_image.hh"
 #include "BKE_image_partial_update.hh"
 
@@ -132,6 +136,8 @@ void ScreenSpaceDrawingMode::do_partial_update(
     if (iterator.tile_data.tile_buffer == nullptr) {
       continue;
     }
+    /* Downscaled float buffers are not partially updated, they are regenerated when needed. */
+    instance_.state.float_buffers.remove_mip_levels(iterator.tile_data.tile_buffer);
     ImBuf *tile_buffer = instance_.state.float_buffers.cached_float_buffer(
         iterator.tile_data.tile_buffer);
     if (tile_buffer != iterator.tile_data.tile_buffer) {
@@ -277,6 +283,28 @@ void ScreenSpaceDrawingMode::do_full_update_gpu_texture(TextureInfo &info,
   imb_freerectImbuf_all(&texture_buffer);
 }
 
+/**
+ * Number of times the tile buffer can be halved while still having at least one image pixel per
+ * texel of the texture. Only byte buffers are downscaled, float buffers are always used at full
+ * resolution.
+ */
+static int texture_slot_mip_level(const TextureInfo &texture_info,
+                                  const ImBuf &texture_buffer,
+                                  const ImBuf &tile_buffer)
+{
+  if (tile_buffer.float_buffer.data != nullptr) {
+    return 0;
+  }
+  const float2 pixels_per_texel = float2(
+      tile_buffer.x * BLI_rctf_size_x(&texture_info.clipping_uv_bounds) / texture_buffer.x,
+      tile_buffer.y * BLI_rctf_size_y(&texture_info.clipping_uv_bounds) / texture_buffer.y);
+  const float min_pixels_per_texel = math::reduce_min(pixels_per_texel);
+  if (min_pixels_per_texel < 2.0f) {
+    return 0;
+  }
+  return int(std::floor(std::log2(min_pixels_per_texel)));
+}
+
 void ScreenSpaceDrawingMode::do_full_update_texture_slot(const TextureInfo &texture_info,
                                                          ImBuf &texture_buffer,
                                                          ImBuf &tile_buffer,
@@ -284,7 +312,11 @@ void ScreenSpaceDrawingMode::do_full_update_texture_slot(const TextureInfo &text
 {
   const int texture_width = texture_buffer.x;
   const int texture_height = texture_buffer.y;
-  ImBuf *float_tile_buffer = instance_.state.float_buffers.cached_float_buffer(&tile_buffer);
+  /* When zoomed out only a downscaled version of the image is converted to float, the texture
+   * would sample one pixel out of many of the full resolution float buffer anyway. */
+  const int mip_level = texture_slot_mip_level(texture_info, texture_buffer, tile_buffer);
+  ImBuf *float_tile_buffer = instance_.state.float_buffers.cached_float_buffer(&tile_buffer,
+                                                                               mip_level);
 
   /* IMB_transform works in a non-consistent space. This should be documented or fixed!.
    * Construct a variant of the info_uv_to_texture that adds the texel space
@@ -296,10 +328,14 @@ void ScreenSpaceDrawingMode::do_full_update_texture_slot(const TextureInfo &text
   BLI_rctf_init(&texture_area, 0.0, texture_width, 0.0, texture_height);
   BLI_rctf_init(
       &tile_area,
-      tile_buffer.x * (texture_info.clipping_uv_bounds.xmin - image_tile.get_tile_x_offset()),
-      tile_buffer.x * (texture_info.clipping_uv_bounds.xmax - image_tile.get_tile_x_offset()),
-      tile_buffer.y * (texture_info.clipping_uv_bounds.ymin - image_tile.get_tile_y_offset()),
-      tile_buffer.y * (texture_info.clipping_uv_bounds.ymax - image_tile.get_tile_y_offset()));
+      float_tile_buffer->x *
+          (texture_info.clipping_uv_bounds.xmin - image_tile.get_tile_x_offset()),
+      float_tile_buffer->x *
+          (texture_info.clipping_uv_bounds.xmax - image_tile.get_tile_x_offset()),
+      float_tile_buffer->y *
+          (texture_info.clipping_uv_bounds.ymin - image_tile.get_tile_y_offset()),
+      float_tile_buffer->y *
+          (texture_info.clipping_uv_bounds.ymax - image_tile.get_tile_y_offset()));
   BLI_rctf_transform_calc_m4_pivot_min(&tile_area, &texture_area, uv_to_texel.ptr());
   uv_to_texel = math::invert(uv_to_texel);
 
@@ -310,7 +346,7 @@ void ScreenSpaceDrawingMode::do_full_update_texture_slot(const TextureInfo &text
     transform_mode = IMB_TRANSFORM_MODE_WRAP_REPEAT;
   }
   else {
-    BLI_rctf_init(&crop_rect, 0.0, tile_buffer.x, 0.0, tile_buffer.y);
+    BLI_rctf_init(&crop_rect, 0.0, float_tile_buffer->x, 0.0, float_tile_buffer->y);
     crop_rect_ptr = &crop_rect;
     transform_mode = IMB_TRANSFORM_MODE_CROP_SRC;
   }
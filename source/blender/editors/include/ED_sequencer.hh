@@ -10,6 +10,7 @@
 
 #include "BLI_vector_set.hh"
 
+struct Main;
 struct Scene;
 struct Strip;
 struct SpaceSeq;
@@ -56,6 +57,13 @@ bool ED_space_sequencer_check_show_strip(SpaceSeq *sseq);
  */
 bool ED_space_sequencer_has_playback_animation(const SpaceSeq *sseq, const Scene *scene);
 
+/**
+ * Register the editor as user of the render timings of the scene while its render times overlay
+ * is enabled, and unregister it from the scene it was registered for otherwise. Pass null as
+ * \a scene when the editor is closed.
+ */
+void ED_sequencer_render_timings_user_update(Main *bmain, SpaceSeq *sseq, Scene *scene);
+
 void ED_operatormacros_sequencer();
 
 Strip *ED_sequencer_special_preview_get();
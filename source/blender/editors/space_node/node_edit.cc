@@ -339,6 +339,8 @@ static void compo_completejob(void *cjv)
   BKE_callback_exec_id(bmain, &scene->id, BKE_CB_EVT_COMPOSITE_POST);
 
   scene->runtime->compositor.per_node_execution_time = cj->profiler.get_nodes_evaluation_times();
+
+  COM_write_trace(cj->profiler, scene->r.cfra);
 }
 
 /** \} */
@@ -37,6 +37,7 @@
 #include "SEQ_prefetch.hh"
 #include "SEQ_relations.hh"
 #include "SEQ_render.hh"
+#include "SEQ_render_timing.hh"
 #include "SEQ_select.hh"
 #include "SEQ_sequencer.hh"
 #include "SEQ_thumbnail_cache.hh"
@@ -3155,6 +3156,77 @@ void SEQUENCER_OT_export_subtitles(wmOperatorType *ot)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Export Render Times Operator
+ * \{ */
+
+static int sequencer_export_render_times_invoke(bContext *C,
+                                                wmOperator *op,
+                                                const wmEvent * /*event*/)
+{
+  ED_fileselect_ensure_default_filepath(C, op, ".json");
+
+  WM_event_add_fileselect(C, op);
+
+  return OPERATOR_RUNNING_MODAL;
+}
+
+static int sequencer_export_render_times_exec(bContext *C, wmOperator *op)
+{
+  Scene *scene = CTX_data_scene(C);
+  char filepath[FILE_MAX];
+
+  if (!RNA_struct_property_is_set_ex(op->ptr, "filepath", false)) {
+    BKE_report(op->reports, RPT_ERROR, "No filepath given");
+    return OPERATOR_CANCELLED;
+  }
+
+  RNA_string_get(op->ptr, "filepath", filepath);
+  BLI_path_extension_ensure(filepath, sizeof(filepath), ".json");
+  BLI_file_ensure_parent_dir_exists(filepath);
+
+  if (!blender::seq::render_timings_write_json(scene, filepath)) {
+    BKE_reportf(op->reports, RPT_ERROR, "Can't write render times to \"%s\"", filepath);
+    return OPERATOR_CANCELLED;
+  }
+
+  return OPERATOR_FINISHED;
+}
+
+static bool sequencer_export_render_times_poll(bContext *C)
+{
+  const Scene *scene = CTX_data_scene(C);
+  return scene != nullptr && blender::seq::render_timings_is_recording(scene);
+}
+
+void SEQUENCER_OT_export_render_times(wmOperatorType *ot)
+{
+  /* Identifiers. */
+  ot->name = "Export Render Times";
+  ot->idname = "SEQUENCER_OT_export_render_times";
+  ot->description =
+      "Export .json file containing the render times recorded by the Render Times overlay, per "
+      "strip and frame";
+
+  /* Api callbacks. */
+  ot->exec = sequencer_export_render_times_exec;
+  ot->invoke = sequencer_export_render_times_invoke;
+  ot->poll = sequencer_export_render_times_poll;
+
+  /* Flags. */
+  ot->flag = OPTYPE_REGISTER;
+
+  WM_operator_properties_filesel(ot,
+                                 FILE_TYPE_FOLDER,
+                                 FILE_BLENDER,
+                                 FILE_SAVE,
+                                 WM_FILESEL_FILEPATH,
+                                 FILE_DEFAULTDISPLAY,
+                                 FILE_SORT_DEFAULT);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Set Range to Strips Operator
  * \{ */
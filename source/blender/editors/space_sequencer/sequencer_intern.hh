@@ -16,6 +16,8 @@
 
 #include "DNA_sequence_types.h"
 
+#include "BKE_lib_id.hh"
+
 #include "RNA_access.hh"
 
 #include "GPU_immediate.hh"
@@ -54,6 +56,11 @@ class StripsDrawBatch;
 struct SpaceSeq_Runtime : public NonCopyable {
   int rename_channel_index = 0;
   float timeline_clamp_custom_range = 0;
+  /**
+   * Session UID of the scene this editor records render timings for, while the render times
+   * overlay is enabled. See #ED_sequencer_render_timings_user_update.
+   */
+  uint32_t render_timings_scene_session_uid = MAIN_ID_SESSION_UID_UNSET;
 
   blender::ed::seq::SeqScopes scopes;
 
@@ -253,6 +260,7 @@ void SEQUENCER_OT_rebuild_proxy(wmOperatorType *ot);
 void SEQUENCER_OT_enable_proxies(wmOperatorType *ot);
 
 void SEQUENCER_OT_export_subtitles(wmOperatorType *ot);
+void SEQUENCER_OT_export_render_times(wmOperatorType *ot);
 
 void SEQUENCER_OT_set_range_to_strips(wmOperatorType *ot);
 void SEQUENCER_OT_strip_transform_clear(wmOperatorType *ot);
@@ -52,6 +52,7 @@ void sequencer_operatortypes()
   WM_operatortype_append(SEQUENCER_OT_rendersize);
 
   WM_operatortype_append(SEQUENCER_OT_export_subtitles);
+  WM_operatortype_append(SEQUENCER_OT_export_render_times);
 
   WM_operatortype_append(SEQUENCER_OT_copy);
   WM_operatortype_append(SEQUENCER_OT_paste);
@@ -12,6 +12,7 @@
 
 #include "BLI_array.hh"
 #include "BLI_blenlib.h"
+#include "BLI_math_vector.hh"
 #include "BLI_string_utils.hh"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
@@ -48,6 +49,7 @@
 #include "SEQ_prefetch.hh"
 #include "SEQ_relations.hh"
 #include "SEQ_render.hh"
+#include "SEQ_render_timing.hh"
 #include "SEQ_retiming.hh"
 #include "SEQ_select.hh"
 #include "SEQ_sequencer.hh"
@@ -1846,6 +1848,60 @@ static void draw_cache_view(const bContext *C)
   GPU_blend(GPU_BLEND_NONE);
 }
 
+/**
+ * Draw the recorded render time of every frame of the visible strips, as bars growing from the
+ * bottom of the strip. A bar reaches the top of the strip when rendering the strip takes as long
+ * as one frame lasts at the scene frame rate, and goes from green to red while approaching it.
+ */
+static void draw_render_times_view(const bContext *C)
+{
+  Scene *scene = CTX_data_scene(C);
+  const SpaceSeq *sseq = CTX_wm_space_seq(C);
+
+  if ((sseq->flag & SEQ_SHOW_OVERLAY) == 0 ||
+      (sseq->timeline_overlay.flag & SEQ_TIMELINE_SHOW_RENDER_TIMES) == 0)
+  {
+    return;
+  }
+
+  /* Recording is started by enabling the overlay, see
+   * #ED_sequencer_render_timings_user_update. */
+  if (!blender::seq::render_timings_is_recording(scene)) {
+    return;
+  }
+
+  const float frame_ms = 1000.0f / float(FPS);
+  const float strip_ht = SEQ_STRIP_OFSTOP - SEQ_STRIP_OFSBOTTOM;
+  const float4 col_fast{40.0f, 200.0f, 60.0f, 140.0f};
+  const float4 col_slow{230.0f, 40.0f, 30.0f, 200.0f};
+
+  SeqQuadsBatch quads;
+  GPU_blend(GPU_BLEND_ALPHA);
+
+  for (const Strip *seq : sequencer_visible_strips_get(C)) {
+    if (seq->type == SEQ_TYPE_SOUND_RAM) {
+      continue;
+    }
+    const float stripe_bot = seq->machine + SEQ_STRIP_OFSBOTTOM;
+    blender::seq::render_timings_foreach_frame(
+        scene, seq, [&](const int timeline_frame, const blender::seq::StripFrameTiming &timing) {
+          const float fac = std::min(timing.total_ms() / frame_ms, 1.0f);
+          if (fac <= 0.0f) {
+            return;
+          }
+          const uchar4 col = uchar4(math::interpolate(col_fast, col_slow, fac));
+          quads.add_quad(timeline_frame,
+                         stripe_bot,
+                         timeline_frame + 1,
+                         stripe_bot + strip_ht * fac,
+                         col);
+        });
+  }
+
+  quads.draw();
+  GPU_blend(GPU_BLEND_NONE);
+}
+
 /* Draw sequencer timeline. */
 static void draw_overlap_frame_indicator(const Scene *scene, const View2D *v2d)
 {
@@ -1969,6 +2025,7 @@ void draw_timeline_seq_display(const bContext *C, ARegion *region)
   if (scene->ed != nullptr) {
     UI_view2d_view_ortho(v2d);
     draw_cache_view(C);
+    draw_render_times_view(C);
     if (scene->ed->overlay_frame_flag & SEQ_EDIT_OVERLAY_FRAME_SHOW) {
       draw_overlap_frame_indicator(scene, v2d);
     }
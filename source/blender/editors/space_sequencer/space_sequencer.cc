@@ -22,6 +22,7 @@
 #include "BLF_api.hh"
 
 #include "BKE_global.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_lib_query.hh"
 #include "BKE_lib_remap.hh"
 #include "BKE_screen.hh"
@@ -41,6 +42,7 @@
 #include "WM_api.hh"
 #include "WM_message.hh"
 
+#include "SEQ_render_timing.hh"
 #include "SEQ_retiming.hh"
 #include "SEQ_sequencer.hh"
 #include "SEQ_time.hh"
@@ -197,6 +199,32 @@ static SpaceLink *sequencer_create(const ScrArea * /*area*/, const Scene *scene)
 }
 
 /* Not spacelink itself. */
+void ED_sequencer_render_timings_user_update(Main *bmain, SpaceSeq *sseq, Scene *scene)
+{
+  if (sseq->runtime == nullptr) {
+    return;
+  }
+  uint32_t &registered_uid = sseq->runtime->render_timings_scene_session_uid;
+  const bool show_render_times = scene != nullptr && (sseq->timeline_overlay.flag &
+                                                      SEQ_TIMELINE_SHOW_RENDER_TIMES) != 0;
+  const uint32_t uid = show_render_times ? scene->id.session_uid : MAIN_ID_SESSION_UID_UNSET;
+  if (registered_uid == uid) {
+    return;
+  }
+  if (registered_uid != MAIN_ID_SESSION_UID_UNSET) {
+    /* The registered scene may have been deleted, its timings were freed with it then. */
+    Scene *registered_scene = reinterpret_cast<Scene *>(
+        BKE_libblock_find_session_uid(bmain, ID_SCE, registered_uid));
+    if (registered_scene != nullptr) {
+      blender::seq::render_timings_remove_user(registered_scene);
+    }
+    registered_uid = MAIN_ID_SESSION_UID_UNSET;
+  }
+  if (show_render_times && blender::seq::render_timings_add_user(scene)) {
+    registered_uid = uid;
+  }
+}
+
 static void sequencer_free(SpaceLink *sl)
 {
   SpaceSeq *sseq = (SpaceSeq *)sl;
@@ -210,12 +238,23 @@ static void sequencer_free(SpaceLink *sl)
 }
 
 /* Space-type init callback. */
-static void sequencer_init(wmWindowManager * /*wm*/, ScrArea *area)
+static void sequencer_init(wmWindowManager *wm, ScrArea *area)
 {
   SpaceSeq *sseq = (SpaceSeq *)area->spacedata.first;
   if (sseq->runtime == nullptr) {
     sseq->runtime = MEM_new<SpaceSeq_Runtime>(__func__);
   }
+
+  /* Editors loaded from a file or duplicated with the render times overlay enabled. */
+  if (wmWindow *win = WM_window_find_by_area(wm, area)) {
+    ED_sequencer_render_timings_user_update(G_MAIN, sseq, WM_window_get_active_scene(win));
+  }
+}
+
+static void sequencer_exit(wmWindowManager * /*wm*/, ScrArea *area)
+{
+  SpaceSeq *sseq = (SpaceSeq *)area->spacedata.first;
+  ED_sequencer_render_timings_user_update(G_MAIN, sseq, nullptr);
 }
 
 static void sequencer_refresh(const bContext *C, ScrArea *area)
@@ -302,6 +341,12 @@ static void sequencer_listener(const wmSpaceTypeListenerParams *params)
           sequencer_scopes_tag_refresh(area);
           break;
       }
+      /* Follow the scene of the window and record once it gets sequencer data. */
+      if (ELEM(wmn->data, ND_SCENEBROWSE, ND_SEQUENCER)) {
+        ED_sequencer_render_timings_user_update(G_MAIN,
+                                                static_cast<SpaceSeq *>(area->spacedata.first),
+                                                const_cast<Scene *>(params->scene));
+      }
       break;
     case NC_WINDOW:
     case NC_SPACE:
@@ -1085,6 +1130,7 @@ void ED_spacetype_sequencer()
   st->create = sequencer_create;
   st->free = sequencer_free;
   st->init = sequencer_init;
+  st->exit = sequencer_exit;
   st->duplicate = sequencer_duplicate;
   st->operatortypes = sequencer_operatortypes;
   st->keymap = sequencer_keymap;
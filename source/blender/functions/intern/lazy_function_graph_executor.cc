@@ -41,6 +41,7 @@
  * starts again.
  */
 
+#include <algorithm>
 #include <mutex>
 #include <sstream>
 
@@ -257,13 +258,16 @@ struct ScheduledNodes {
   }
 
   /**
-   * Split up the scheduled nodes into two groups that can be worked on in parallel.
+   * Move about `1 / parts_num` of the scheduled nodes into #other, so that both groups can be
+   * worked on in parallel. Splitting off parts one after another with a decreasing #parts_num
+   * results in groups of roughly equal size.
    */
-  void split_into(ScheduledNodes &other)
+  void split_into(ScheduledNodes &other, const int64_t parts_num = 2)
   {
     BLI_assert(this != &other);
-    const int64_t priority_split = priority_.size() / 2;
-    const int64_t normal_split = normal_.size() / 2;
+    BLI_assert(parts_num >= 2);
+    const int64_t priority_split = priority_.size() - priority_.size() / parts_num;
+    const int64_t normal_split = normal_.size() - normal_.size() / parts_num;
     other.priority_.extend(priority_.as_span().drop_front(priority_split));
     other.normal_.extend(normal_.as_span().drop_front(normal_split));
     priority_.resize(priority_split);
@@ -271,6 +275,16 @@ struct ScheduledNodes {
   }
 };
 
+/**
+ * When more nodes than this are scheduled in a single task, they are distributed to other threads.
+ */
+static constexpr int64_t split_scheduled_nodes_threshold = 128;
+/**
+ * Lower bound for the number of nodes that are pushed to the task pool as a single task. This
+ * avoids creating lots of tiny tasks whose scheduling overhead is larger than the work they do.
+ */
+static constexpr int64_t min_scheduled_nodes_per_batch = 32;
+
 struct CurrentTask {
   /**
    * Mutex used to protect #scheduled_nodes when the executor uses multi-threading.
@@ -816,16 +830,42 @@ class Executor {
 
       /* If there are many nodes scheduled at the same time, it's beneficial to let multiple
        * threads work on those. */
-      if (current_task.scheduled_nodes.nodes_num() > 128) {
+      if (current_task.scheduled_nodes.nodes_num() > split_scheduled_nodes_threshold) {
         if (this->try_enable_multi_threading()) {
-          std::unique_ptr<ScheduledNodes> split_nodes = std::make_unique<ScheduledNodes>();
-          current_task.scheduled_nodes.split_into(*split_nodes);
-          this->push_to_task_pool(std::move(split_nodes));
+          this->distribute_scheduled_nodes(current_task);
         }
       }
     }
   }
 
+  /**
+   * Split the nodes scheduled in the current task into batches and push all but one of them to
+   * the task pool. This way, all threads get work at once, instead of the nodes being handed out
+   * in halves one split at a time. Every batch still contains many nodes, so that the per-task
+   * overhead stays small when the nodes are cheap.
+   */
+  void distribute_scheduled_nodes(CurrentTask &current_task)
+  {
+    BLI_assert(this->use_multi_threading());
+    Vector<std::unique_ptr<ScheduledNodes>, 16> batches;
+    {
+      std::lock_guard lock{current_task.mutex};
+      ScheduledNodes &scheduled_nodes = current_task.scheduled_nodes;
+      const int64_t max_batches_num = std::max<int64_t>(
+          2, scheduled_nodes.nodes_num() / min_scheduled_nodes_per_batch);
+      const int64_t batches_num = std::clamp<int64_t>(
+          BLI_system_thread_count(), 2, max_batches_num);
+      for (int64_t remaining_parts = batches_num; remaining_parts > 1; remaining_parts--) {
+        std::unique_ptr<ScheduledNodes> batch = std::make_unique<ScheduledNodes>();
+        scheduled_nodes.split_into(*batch, remaining_parts);
+        batches.append(std::move(batch));
+      }
+    }
+    for (std::unique_ptr<ScheduledNodes> &batch : batches) {
+      this->push_to_task_pool(std::move(batch));
+    }
+  }
+
   void run_node_task(const FunctionNode &node,
                      CurrentTask &current_task,
                      const LocalData &local_data)
@@ -0,0 +1,148 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "FN_lazy_function_execute.hh"
+#include "FN_lazy_function_graph.hh"
+#include "FN_lazy_function_graph_executor.hh"
+
+#include "BLI_task.h"
+#include "BLI_timeit.hh"
+
+namespace blender::fn::lazy_function::tests {
+
+class AddLazyFunction : public LazyFunction {
+ private:
+  /** Additional artificial work done per execution to simulate more expensive nodes. */
+  int extra_iterations_;
+
+ public:
+  AddLazyFunction(const int extra_iterations = 0) : extra_iterations_(extra_iterations)
+  {
+    debug_name_ = "Add";
+    inputs_.append({"A", CPPType::get<int>()});
+    inputs_.append({"B", CPPType::get<int>()});
+    outputs_.append({"Result", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    const int a = params.get_input<int>(0);
+    const int b = params.get_input<int>(1);
+    volatile int sink = 0;
+    for (int i = 0; i < extra_iterations_; i++) {
+      sink = sink + i;
+    }
+    params.set_output(0, a + b);
+  }
+};
+
+/**
+ * Builds a graph with #width independent nodes that all depend on the graph input. Their results
+ * are summed up with a balanced tree of additional nodes. This results in many nodes being
+ * scheduled at the same time, which is where multi-threading is most useful.
+ */
+static int evaluate_wide_graph(const LazyFunction &fn, const int width, const int input)
+{
+  Graph graph;
+  GraphInputSocket &graph_input = graph.add_input(CPPType::get<int>());
+  GraphOutputSocket &graph_output = graph.add_output(CPPType::get<int>());
+
+  const int one = 1;
+  Vector<OutputSocket *> layer;
+  for ([[maybe_unused]] const int i : IndexRange(width)) {
+    FunctionNode &node = graph.add_function(fn);
+    graph.add_link(graph_input, node.input(0));
+    node.input(1).set_default_value(&one);
+    layer.append(&node.output(0));
+  }
+  while (layer.size() > 1) {
+    Vector<OutputSocket *> next_layer;
+    for (int64_t i = 0; i + 1 < layer.size(); i += 2) {
+      FunctionNode &node = graph.add_function(fn);
+      graph.add_link(*layer[i], node.input(0));
+      graph.add_link(*layer[i + 1], node.input(1));
+      next_layer.append(&node.output(0));
+    }
+    if (layer.size() % 2 == 1) {
+      next_layer.append(layer.last());
+    }
+    layer = std::move(next_layer);
+  }
+  graph.add_link(*layer[0], graph_output);
+  graph.update_node_indices();
+
+  GraphExecutor executor_fn{graph, {&graph_input}, {&graph_output}, nullptr, nullptr, nullptr};
+  int result = 0;
+  {
+    SCOPED_TIMER("evaluate");
+    execute_lazy_function_eagerly(
+        executor_fn, nullptr, nullptr, std::make_tuple(input), std::make_tuple(&result));
+  }
+  return result;
+}
+
+/**
+ * Builds a graph that is a single chain of #length nodes. There is no parallelism in this graph,
+ * so it measures the per-node overhead of the executor.
+ */
+static int evaluate_chain_graph(const LazyFunction &fn, const int length, const int input)
+{
+  Graph graph;
+  GraphInputSocket &graph_input = graph.add_input(CPPType::get<int>());
+  GraphOutputSocket &graph_output = graph.add_output(CPPType::get<int>());
+
+  const int one = 1;
+  OutputSocket *previous = &graph_input;
+  for ([[maybe_unused]] const int i : IndexRange(length)) {
+    FunctionNode &node = graph.add_function(fn);
+    graph.add_link(*previous, node.input(0));
+    node.input(1).set_default_value(&one);
+    previous = &node.output(0);
+  }
+  graph.add_link(*previous, graph_output);
+  graph.update_node_indices();
+
+  GraphExecutor executor_fn{graph, {&graph_input}, {&graph_output}, nullptr, nullptr, nullptr};
+  int result = 0;
+  {
+    SCOPED_TIMER("evaluate");
+    execute_lazy_function_eagerly(
+        executor_fn, nullptr, nullptr, std::make_tuple(input), std::make_tuple(&result));
+  }
+  return result;
+}
+
+TEST(lazy_function_graph_executor_performance, WideGraphCheapNodes)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction fn;
+  for (const int width : {1000, 10'000, 50'000}) {
+    std::cout << "Width: " << width << "\n";
+    EXPECT_EQ(evaluate_wide_graph(fn, width, 3), width * 4);
+  }
+}
+
+TEST(lazy_function_graph_executor_performance, WideGraphExpensiveNodes)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction fn{10'000};
+  for (const int width : {100, 1000, 5000}) {
+    std::cout << "Width: " << width << "\n";
+    EXPECT_EQ(evaluate_wide_graph(fn, width, 3), width * 4);
+  }
+}
+
+TEST(lazy_function_graph_executor_performance, ChainGraph)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction fn;
+  for (const int length : {1000, 10'000, 50'000}) {
+    std::cout << "Length: " << length << "\n";
+    EXPECT_EQ(evaluate_chain_graph(fn, length, 3), length + 3);
+  }
+}
+
+}  // namespace blender::fn::lazy_function::tests
@@ -70,4 +70,33 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
                                    const RealizeInstancesOptions &options,
                                    const VariedDepthOptions &varied_depth_option);
 
+/**
+ * Options for #realize_instances_chunked.
+ */
+struct RealizeInstancesChunkOptions {
+  /**
+   * Approximate upper bound for the number of points (mesh vertices, curve points, grease pencil
+   * stroke points and point cloud points) in each realized chunk. A single top-level instance is
+   * never split, so chunks can be larger when a single instance contains more points than that.
+   */
+  int64_t max_points_per_chunk = 16 * 1024 * 1024;
+};
+
+/**
+ * Same as #realize_instances, but instead of joining everything into a single geometry, the
+ * top-level instances are split into consecutive ranges that are realized one after the other.
+ * Each realized chunk is passed to the callback together with the range of top-level instances
+ * it contains, and is freed when the callback returns unless the callback keeps it. The geometry
+ * that is not instanced is part of the first chunk.
+ *
+ * This allows consumers like exporters to process scenes whose fully realized geometry would not
+ * fit into memory. Generated ids are the same as when realizing all instances at once, as long as
+ * the chunks contain the same kinds of geometry.
+ */
+void realize_instances_chunked(
+    bke::GeometrySet geometry_set,
+    const RealizeInstancesOptions &options,
+    const RealizeInstancesChunkOptions &chunk_options,
+    FunctionRef<void(bke::GeometrySet chunk, IndexRange instances_range)> fn);
+
 }  // namespace blender::geometry
@@ -2296,9 +2296,14 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   return realize_instances(geometry_set, options, all_instances);
 }
 
-bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
-                                   const RealizeInstancesOptions &options,
-                                   const VariedDepthOptions &varied_depth_option)
+/**
+ * Realize the selected top-level instances. The instances that should be kept unrealized in the
+ * output are passed in separately in #not_to_realize_set.
+ */
+static bke::GeometrySet realize_selected_instances(const bke::GeometrySet &geometry_set,
+                                                   const RealizeInstancesOptions &options,
+                                                   const VariedDepthOptions &varied_depth_option,
+                                                   bke::GeometrySet not_to_realize_set)
 {
   /* The algorithm works in three steps:
    * 1. Preprocess each unique geometry that is instanced (e.g. each `Mesh`).
@@ -2307,18 +2312,6 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
    * 3. Execute all tasks in parallel.
    */
 
-  if (!geometry_set.has_instances()) {
-    return geometry_set;
-  }
-
-  bke::GeometrySet not_to_realize_set;
-  propagate_instances_to_keep(
-      geometry_set, varied_depth_option.selection, not_to_realize_set, options.attribute_filter);
-
-  if (options.keep_original_ids) {
-    remove_id_attribute_from_instances(geometry_set);
-  }
-
   AllPointCloudsInfo all_pointclouds_info = preprocess_pointclouds(
       geometry_set, options, varied_depth_option);
   AllMeshesInfo all_meshes_info = preprocess_meshes(geometry_set, options, varied_depth_option);
@@ -2398,6 +2391,126 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   return new_geometry_set;
 }
 
+bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
+                                   const RealizeInstancesOptions &options,
+                                   const VariedDepthOptions &varied_depth_option)
+{
+  if (!geometry_set.has_instances()) {
+    return geometry_set;
+  }
+
+  bke::GeometrySet not_to_realize_set;
+  propagate_instances_to_keep(
+      geometry_set, varied_depth_option.selection, not_to_realize_set, options.attribute_filter);
+
+  if (options.keep_original_ids) {
+    remove_id_attribute_from_instances(geometry_set);
+  }
+
+  return realize_selected_instances(
+      geometry_set, options, varied_depth_option, std::move(not_to_realize_set));
+}
+
+static Array<int64_t> estimate_realized_points_by_reference(const Instances &instances);
+
+/**
+ * Rough estimate of the number of points the realized geometry will have, used to decide how many
+ * instances are realized together in #realize_instances_chunked. Grease pencil strokes are counted
+ * like curves.
+ */
+static int64_t estimate_realized_points_num(const bke::GeometrySet &geometry_set)
+{
+  int64_t points_num = 0;
+  if (const Mesh *mesh = geometry_set.get_mesh()) {
+    points_num += mesh->verts_num;
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud()) {
+    points_num += pointcloud->totpoint;
+  }
+  if (const Curves *curves = geometry_set.get_curves()) {
+    points_num += curves->geometry.wrap().points_num();
+  }
+  if (const GreasePencil *grease_pencil = geometry_set.get_grease_pencil()) {
+    /* Only the evaluated drawings of the layers are realized. */
+    for (const bke::greasepencil::Layer *layer : grease_pencil->layers()) {
+      if (const bke::greasepencil::Drawing *drawing = grease_pencil->get_eval_drawing(*layer)) {
+        points_num += drawing->strokes().points_num();
+      }
+    }
+  }
+  if (const Instances *instances = geometry_set.get_instances()) {
+    const Array<int64_t> points_by_reference = estimate_realized_points_by_reference(*instances);
+    for (const int handle : instances->reference_handles()) {
+      points_num += points_by_reference[handle];
+    }
+  }
+  return points_num;
+}
+
+static Array<int64_t> estimate_realized_points_by_reference(const Instances &instances)
+{
+  const Span<InstanceReference> references = instances.references();
+  Array<int64_t> points_by_reference(references.size());
+  for (const int i : references.index_range()) {
+    bke::GeometrySet reference_geometry;
+    references[i].to_geometry_set(reference_geometry);
+    points_by_reference[i] = estimate_realized_points_num(reference_geometry);
+  }
+  return points_by_reference;
+}
+
+void realize_instances_chunked(
+    bke::GeometrySet geometry_set,
+    const RealizeInstancesOptions &options,
+    const RealizeInstancesChunkOptions &chunk_options,
+    FunctionRef<void(bke::GeometrySet chunk, IndexRange instances_range)> fn)
+{
+  if (!geometry_set.has_instances()) {
+    fn(std::move(geometry_set), IndexRange());
+    return;
+  }
+
+  if (options.keep_original_ids) {
+    remove_id_attribute_from_instances(geometry_set);
+  }
+
+  const Instances &instances = *geometry_set.get_instances();
+  const int instances_num = instances.instances_num();
+  const Span<int> handles = instances.reference_handles();
+  const Array<int64_t> points_by_reference = estimate_realized_points_by_reference(instances);
+
+  /* All chunks except the first only contain the instances, the other geometry is realized with
+   * the first chunk. */
+  bke::GeometrySet instances_only;
+  instances_only.add(*geometry_set.get_component<bke::InstancesComponent>());
+
+  const VArray<int> depths = VArray<int>::ForSingle(VariedDepthOptions::MAX_DEPTH, instances_num);
+  auto realize_chunk = [&](const IndexRange range) {
+    VariedDepthOptions chunk_depth_options;
+    chunk_depth_options.selection = IndexMask(range);
+    chunk_depth_options.depths = depths;
+    const bke::GeometrySet &chunk_geometry = range.start() == 0 ? geometry_set : instances_only;
+    fn(realize_selected_instances(chunk_geometry, options, chunk_depth_options, {}), range);
+  };
+
+  bke::GeometrySet base_geometry = geometry_set;
+  base_geometry.remove<bke::InstancesComponent>();
+  int64_t chunk_start = 0;
+  int64_t chunk_points_num = estimate_realized_points_num(base_geometry);
+  for (const int i : IndexRange(instances_num)) {
+    const int64_t instance_points_num = points_by_reference[handles[i]];
+    if (i > chunk_start &&
+        chunk_points_num + instance_points_num > chunk_options.max_points_per_chunk)
+    {
+      realize_chunk(IndexRange::from_begin_end(chunk_start, i));
+      chunk_start = i;
+      chunk_points_num = 0;
+    }
+    chunk_points_num += instance_points_num;
+  }
+  realize_chunk(IndexRange::from_begin_end(chunk_start, instances_num));
+}
+
 /** \} */
 
 }  // namespace blender::geometry
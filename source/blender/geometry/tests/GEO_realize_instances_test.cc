@@ -0,0 +1,140 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "BKE_curves.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_grease_pencil.hh"
+#include "BKE_idtype.hh"
+#include "BKE_instances.hh"
+#include "BKE_pointcloud.hh"
+
+#include "BLI_math_matrix.hh"
+
+#include "DNA_pointcloud_types.h"
+
+#include "GEO_realize_instances.hh"
+
+#include "testing/testing.h"
+
+using namespace blender::bke;
+
+namespace blender::geometry::tests {
+
+static PointCloud *create_test_pointcloud(const int points_num)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  MutableSpan<float3> positions = pointcloud->positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(i, 0.0f, 0.0f);
+  }
+  return pointcloud;
+}
+
+/** Instance the given geometry the given number of times, offset along the Y axis. */
+static GeometrySet create_test_instances(const GeometrySet &reference, const int instances_num)
+{
+  Instances *instances = new Instances();
+  const int handle = instances->add_reference(InstanceReference{reference});
+  for (const int i : IndexRange(instances_num)) {
+    instances->add_instance(handle, math::from_location<float4x4>(float3(0.0f, i, 0.0f)));
+  }
+  return GeometrySet::from_instances(instances);
+}
+
+struct RealizedChunk {
+  GeometrySet geometry;
+  IndexRange instances_range;
+};
+
+static Vector<RealizedChunk> realize_chunked(const GeometrySet &geometry,
+                                             const int64_t max_points_per_chunk)
+{
+  RealizeInstancesChunkOptions chunk_options;
+  chunk_options.max_points_per_chunk = max_points_per_chunk;
+  Vector<RealizedChunk> chunks;
+  realize_instances_chunked(
+      geometry, {}, chunk_options, [&](GeometrySet chunk, const IndexRange instances_range) {
+        chunks.append({std::move(chunk), instances_range});
+      });
+  return chunks;
+}
+
+TEST(realize_instances_chunked, NoInstances)
+{
+  const GeometrySet geometry = GeometrySet::from_pointcloud(create_test_pointcloud(10));
+  const Vector<RealizedChunk> chunks = realize_chunked(geometry, 5);
+  ASSERT_EQ(chunks.size(), 1);
+  EXPECT_TRUE(chunks[0].instances_range.is_empty());
+  EXPECT_EQ(chunks[0].geometry.get_pointcloud()->totpoint, 10);
+}
+
+TEST(realize_instances_chunked, MatchesFullRealization)
+{
+  GeometrySet geometry = create_test_instances(
+      GeometrySet::from_pointcloud(create_test_pointcloud(100)), 10);
+  geometry.replace_pointcloud(create_test_pointcloud(10));
+
+  const Vector<RealizedChunk> chunks = realize_chunked(geometry, 250);
+
+  /* The base point cloud is realized with the first two instances, then two instances fit into
+   * every chunk. */
+  ASSERT_EQ(chunks.size(), 5);
+  int64_t next_instance = 0;
+  Vector<float3> chunked_positions;
+  for (const RealizedChunk &chunk : chunks) {
+    EXPECT_EQ(chunk.instances_range.start(), next_instance);
+    EXPECT_EQ(chunk.instances_range.size(), 2);
+    next_instance = chunk.instances_range.one_after_last();
+    EXPECT_FALSE(chunk.geometry.has_instances());
+    const PointCloud *pointcloud = chunk.geometry.get_pointcloud();
+    ASSERT_NE(pointcloud, nullptr);
+    EXPECT_LE(pointcloud->totpoint, 250);
+    chunked_positions.extend(pointcloud->positions());
+  }
+  EXPECT_EQ(next_instance, 10);
+
+  const GeometrySet realized = realize_instances(geometry, {});
+  const Span<float3> positions = realized.get_pointcloud()->positions();
+  ASSERT_EQ(chunked_positions.size(), positions.size());
+  for (const int i : positions.index_range()) {
+    EXPECT_EQ(chunked_positions[i], positions[i]);
+  }
+}
+
+TEST(realize_instances_chunked, LargeInstanceIsNotSplit)
+{
+  const GeometrySet geometry = create_test_instances(
+      GeometrySet::from_pointcloud(create_test_pointcloud(100)), 3);
+  const Vector<RealizedChunk> chunks = realize_chunked(geometry, 50);
+  ASSERT_EQ(chunks.size(), 3);
+  for (const RealizedChunk &chunk : chunks) {
+    EXPECT_EQ(chunk.instances_range.size(), 1);
+    EXPECT_EQ(chunk.geometry.get_pointcloud()->totpoint, 100);
+  }
+}
+
+TEST(realize_instances_chunked, GreasePencilPointsAreCounted)
+{
+  BKE_idtype_init();
+
+  GreasePencil *grease_pencil = BKE_grease_pencil_new_nomain();
+  greasepencil::Layer &layer = grease_pencil->add_layer("Layer");
+  greasepencil::Drawing *drawing = grease_pencil->insert_frame(layer, 0);
+  ASSERT_NE(drawing, nullptr);
+  drawing->strokes_for_write() = bke::CurvesGeometry(100, 1);
+  drawing->tag_topology_changed();
+
+  const GeometrySet geometry = create_test_instances(
+      GeometrySet::from_grease_pencil(grease_pencil), 4);
+  const Vector<RealizedChunk> chunks = realize_chunked(geometry, 150);
+
+  /* Every chunk can only contain a single instance with 100 stroke points. */
+  ASSERT_EQ(chunks.size(), 4);
+  for (const RealizedChunk &chunk : chunks) {
+    EXPECT_EQ(chunk.instances_range.size(), 1);
+    EXPECT_TRUE(chunk.geometry.has_grease_pencil());
+  }
+}
+
+}  // namespace blender::geometry::tests
@@ -9,6 +9,7 @@
 #include "IMB_colormanagement.hh"
 #include "IMB_colormanagement_intern.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
@@ -32,6 +33,7 @@
 #include "BLI_math_color.h"
 #include "BLI_math_color.hh"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_task.hh"
@@ -120,6 +122,35 @@ static struct global_color_picking_state {
   bool failed;
 } global_color_picking_state = {nullptr};
 
+/**
+ * Display processors for the most recently used view settings. Creating the OCIO processor for a
+ * view transform with look, exposure and gamma is expensive compared to applying it to the pixels
+ * of a small preview, and the same settings are used for every redraw. The CPU processors are
+ * cached by OCIO per processor, so only the processor itself is stored here.
+ */
+#define DISPLAY_PROCESSOR_CACHE_SIZE 8
+
+struct DisplayProcessorCacheItem {
+  char look[MAX_COLORSPACE_NAME];
+  char view_transform[MAX_COLORSPACE_NAME];
+  char display[MAX_COLORSPACE_NAME];
+  char from_colorspace[MAX_COLORSPACE_NAME];
+  float exposure;
+  float gamma;
+  float temperature;
+  float tint;
+  bool use_white_balance;
+
+  OCIO_ConstProcessorRcPtr *processor;
+  /** Value of the cache clock when the item was last used, the oldest item is replaced first. */
+  uint64_t last_used;
+};
+
+static struct global_display_processor_cache {
+  DisplayProcessorCacheItem items[DISPLAY_PROCESSOR_CACHE_SIZE];
+  uint64_t clock;
+} global_display_processor_cache = {};
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -664,6 +695,14 @@ static void colormanage_free_config()
   /* free looks */
   BLI_freelistN(&global_looks);
   global_tot_looks = 0;
+
+  /* free cached display processors */
+  for (DisplayProcessorCacheItem &item : global_display_processor_cache.items) {
+    if (item.processor) {
+      OCIO_processorRelease(item.processor);
+    }
+  }
+  memset(&global_display_processor_cache, 0, sizeof(global_display_processor_cache));
 }
 
 void colormanagement_init()
@@ -884,6 +923,24 @@ static ColorSpace *display_transform_get_colorspace(
   return nullptr;
 }
 
+static bool display_processor_cache_item_matches(const DisplayProcessorCacheItem &item,
+                                                 const char *look,
+                                                 const char *view_transform,
+                                                 const char *display,
+                                                 const float exposure,
+                                                 const float gamma,
+                                                 const float temperature,
+                                                 const float tint,
+                                                 const bool use_white_balance,
+                                                 const char *from_colorspace)
+{
+  return item.processor != nullptr && STREQ(item.look, look) &&
+         STREQ(item.view_transform, view_transform) && STREQ(item.display, display) &&
+         STREQ(item.from_colorspace, from_colorspace) && item.exposure == exposure &&
+         item.gamma == gamma && item.temperature == temperature && item.tint == tint &&
+         item.use_white_balance == use_white_balance;
+}
+
 static OCIO_ConstCPUProcessorRcPtr *create_display_buffer_processor(const char *look,
                                                                     const char *view_transform,
                                                                     const char *display,
@@ -894,31 +951,82 @@ static OCIO_ConstCPUProcessorRcPtr *create_display_buffer_processor(const char *
                                                                     const bool use_white_balance,
                                                                     const char *from_colorspace)
 {
-  OCIO_ConstConfigRcPtr *config = OCIO_getCurrentConfig();
-  const bool use_look = colormanage_use_look(look, view_transform);
-  const float scale = (exposure == 0.0f) ? 1.0f : powf(2.0f, exposure);
-  const float exponent = (gamma == 1.0f) ? 1.0f : 1.0f / max_ff(FLT_EPSILON, gamma);
+  BLI_mutex_lock(&processor_lock);
+
+  /* Use the processor of the same view settings if it was created before. */
+  DisplayProcessorCacheItem *cache_item = nullptr;
+  for (DisplayProcessorCacheItem &item : global_display_processor_cache.items) {
+    if (display_processor_cache_item_matches(item,
+                                             look,
+                                             view_transform,
+                                             display,
+                                             exposure,
+                                             gamma,
+                                             temperature,
+                                             tint,
+                                             use_white_balance,
+                                             from_colorspace))
+    {
+      cache_item = &item;
+      break;
+    }
+  }
 
-  OCIO_ConstProcessorRcPtr *processor = OCIO_createDisplayProcessor(config,
-                                                                    from_colorspace,
-                                                                    view_transform,
-                                                                    display,
-                                                                    (use_look) ? look : "",
-                                                                    scale,
-                                                                    exponent,
-                                                                    temperature,
-                                                                    tint,
-                                                                    use_white_balance,
-                                                                    false);
+  if (cache_item == nullptr) {
+    OCIO_ConstConfigRcPtr *config = OCIO_getCurrentConfig();
+    const bool use_look = colormanage_use_look(look, view_transform);
+    const float scale = (exposure == 0.0f) ? 1.0f : powf(2.0f, exposure);
+    const float exponent = (gamma == 1.0f) ? 1.0f : 1.0f / max_ff(FLT_EPSILON, gamma);
+
+    OCIO_ConstProcessorRcPtr *processor = OCIO_createDisplayProcessor(config,
+                                                                      from_colorspace,
+                                                                      view_transform,
+                                                                      display,
+                                                                      (use_look) ? look : "",
+                                                                      scale,
+                                                                      exponent,
+                                                                      temperature,
+                                                                      tint,
+                                                                      use_white_balance,
+                                                                      false);
 
-  OCIO_configRelease(config);
+    OCIO_configRelease(config);
 
-  if (processor == nullptr) {
-    return nullptr;
+    if (processor == nullptr) {
+      BLI_mutex_unlock(&processor_lock);
+      return nullptr;
+    }
+
+    /* Replace the least recently used item. */
+    cache_item = &global_display_processor_cache.items[0];
+    for (DisplayProcessorCacheItem &item : global_display_processor_cache.items) {
+      if (item.last_used < cache_item->last_used) {
+        cache_item = &item;
+      }
+    }
+    if (cache_item->processor) {
+      OCIO_processorRelease(cache_item->processor);
+    }
+    STRNCPY(cache_item->look, look);
+    STRNCPY(cache_item->view_transform, view_transform);
+    STRNCPY(cache_item->display, display);
+    STRNCPY(cache_item->from_colorspace, from_colorspace);
+    cache_item->exposure = exposure;
+    cache_item->gamma = gamma;
+    cache_item->temperature = temperature;
+    cache_item->tint = tint;
+    cache_item->use_white_balance = use_white_balance;
+    cache_item->processor = processor;
   }
 
-  OCIO_ConstCPUProcessorRcPtr *cpu_processor = OCIO_processorGetCPUProcessor(processor);
-  OCIO_processorRelease(processor);
+  cache_item->last_used = ++global_display_processor_cache.clock;
+
+  /* The CPU processor keeps a reference to the OCIO data it needs, so it stays valid when the
+   * cache item is replaced. */
+  OCIO_ConstCPUProcessorRcPtr *cpu_processor = OCIO_processorGetCPUProcessor(
+      cache_item->processor);
+
+  BLI_mutex_unlock(&processor_lock);
 
   return cpu_processor;
 }
@@ -1566,8 +1674,9 @@ struct DisplayBufferThread {
   bool is_data;
   bool predivide;
 
-  const char *byte_colorspace;
-  const char *float_colorspace;
+  /* Conversion of the source buffers to scene linear, null when they already are. */
+  OCIO_ConstCPUProcessorRcPtr *byte_to_scene_linear;
+  OCIO_ConstCPUProcessorRcPtr *float_to_scene_linear;
 };
 
 struct DisplayBufferInitData {
@@ -1581,10 +1690,17 @@ struct DisplayBufferInitData {
 
   int width;
 
-  const char *byte_colorspace;
-  const char *float_colorspace;
+  OCIO_ConstCPUProcessorRcPtr *byte_to_scene_linear;
+  OCIO_ConstCPUProcessorRcPtr *float_to_scene_linear;
 };
 
+/**
+ * Number of pixels the display buffer threads convert at once. All conversion steps are done for
+ * a block before moving on to the next one, so the intermediate float pixels stay in the CPU
+ * cache instead of being written to and read back from memory for every step.
+ */
+#define DISPLAY_BUFFER_BLOCK_SIZE 8192
+
 static void display_buffer_init_handle(void *handle_v,
                                        int start_line,
                                        int tot_line,
@@ -1631,11 +1747,116 @@ static void display_buffer_init_handle(void *handle_v,
   handle->is_data = is_data;
   handle->predivide = IMB_alpha_affects_rgb(ibuf);
 
-  handle->byte_colorspace = init_data->byte_colorspace;
-  handle->float_colorspace = init_data->float_colorspace;
+  handle->byte_to_scene_linear = init_data->byte_to_scene_linear;
+  handle->float_to_scene_linear = init_data->float_to_scene_linear;
 }
 
+static void cpu_processor_apply(OCIO_ConstCPUProcessorRcPtr *cpu_processor,
+                                float *buffer,
+                                int width,
+                                int height,
+                                int channels,
+                                bool predivide)
+{
+  OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(buffer,
+                                                              width,
+                                                              height,
+                                                              channels,
+                                                              sizeof(float),
+                                                              size_t(channels) * sizeof(float),
+                                                              size_t(channels) * sizeof(float) *
+                                                                  width);
+  if (predivide) {
+    OCIO_cpuProcessorApply_predivide(cpu_processor, img);
+  }
+  else {
+    OCIO_cpuProcessorApply(cpu_processor, img);
+  }
+  OCIO_PackedImageDescRelease(img);
+}
+
+/** Same as #rgba_uchar_to_float for every pixel. */
+static void rgba_uchar_to_float_buffer(float *dst, const uchar *src, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 norm = _mm_set1_ps(1.0f / 255.0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= pixels_num; i += 4) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+    const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    float *dst_pixels = dst + i * 4;
+    _mm_storeu_ps(dst_pixels, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), norm));
+    _mm_storeu_ps(dst_pixels + 4,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), norm));
+    _mm_storeu_ps(dst_pixels + 8,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), norm));
+    _mm_storeu_ps(dst_pixels + 12,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), norm));
+  }
+#endif
+  for (; i < pixels_num; i++) {
+    rgba_uchar_to_float(dst + i * 4, src + i * 4);
+  }
+}
+
+/**
+ * Same as #rgba_float_to_uchar for every pixel, or #premul_float_to_straight_uchar when
+ * predivide is true.
+ */
+static void rgba_float_to_uchar_buffer(uchar *dst,
+                                       const float *src,
+                                       const int64_t pixels_num,
+                                       const bool predivide)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  /* Mask of the alpha channel, which is never divided by itself. */
+  const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  for (; i + 4 <= pixels_num; i += 4) {
+    __m128i pixels[4];
+    for (int j = 0; j < 4; j++) {
+      __m128 color = _mm_loadu_ps(src + (i + j) * 4);
+      if (predivide) {
+        /* Colors with zero or one alpha are kept as is, which is also what a division by one
+         * does. */
+        const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 keep = _mm_or_ps(alpha_mask,
+                                      _mm_or_ps(_mm_cmpeq_ps(alpha, zero),
+                                                _mm_cmpeq_ps(alpha, one)));
+        const __m128 divisor = _mm_or_ps(_mm_and_ps(keep, one), _mm_andnot_ps(keep, alpha));
+        color = _mm_mul_ps(color, _mm_div_ps(one, divisor));
+      }
+      /* Matches #unit_float_to_uchar_clamp, the maximum also maps NaN to zero. */
+      const __m128 value = _mm_add_ps(_mm_mul_ps(color, scale), half);
+      pixels[j] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(value, zero), scale));
+    }
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(pixels[0], pixels[1]),
+                                            _mm_packs_epi32(pixels[2], pixels[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), packed);
+  }
+#endif
+  for (; i < pixels_num; i++) {
+    if (predivide) {
+      premul_float_to_straight_uchar(dst + i * 4, src + i * 4);
+    }
+    else {
+      rgba_float_to_uchar(dst + i * 4, src + i * 4);
+    }
+  }
+}
+
+/**
+ * Convert the lines of the thread starting at start_line to scene linear floats. The result is
+ * premultiplied when the source is a float buffer, and has straight alpha for byte buffers.
+ */
 static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
+                                                   int start_line,
                                                    int height,
                                                    float *linear_buffer,
                                                    bool *is_straight_alpha)
@@ -1643,6 +1864,7 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
   int channels = handle->channels;
   int width = handle->width;
 
+  size_t buffer_offset = size_t(channels) * width * start_line;
   size_t buffer_size = size_t(channels) * width * height;
 
   bool is_data = handle->is_data;
@@ -1650,68 +1872,111 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
   bool predivide = handle->predivide;
 
   if (!handle->buffer) {
-    uchar *byte_buffer = handle->byte_buffer;
-
-    const char *from_colorspace = handle->byte_colorspace;
-    const char *to_colorspace = global_role_scene_linear;
-
-    float *fp;
-    uchar *cp;
-    const size_t i_last = size_t(width) * height;
-    size_t i;
+    const uchar *byte_buffer = handle->byte_buffer + buffer_offset;
 
     /* first convert byte buffer to float, keep in image space */
-    for (i = 0, fp = linear_buffer, cp = byte_buffer; i != i_last;
-         i++, fp += channels, cp += channels)
-    {
-      if (channels == 3) {
-        rgb_uchar_to_float(fp, cp);
-      }
-      else if (channels == 4) {
-        rgba_uchar_to_float(fp, cp);
-      }
-      else {
-        BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
+    if (channels == 4) {
+      rgba_uchar_to_float_buffer(linear_buffer, byte_buffer, int64_t(width) * height);
+    }
+    else if (channels == 3) {
+      const size_t i_last = size_t(width) * height;
+      for (size_t i = 0; i != i_last; i++) {
+        rgb_uchar_to_float(linear_buffer + i * 3, byte_buffer + i * 3);
       }
     }
+    else {
+      BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
+    }
 
-    if (!is_data && !is_data_display) {
+    if (!is_data && !is_data_display && handle->byte_to_scene_linear) {
       /* convert float buffer to scene linear space */
-      IMB_colormanagement_transform(
-          linear_buffer, width, height, channels, from_colorspace, to_colorspace, false);
+      cpu_processor_apply(
+          handle->byte_to_scene_linear, linear_buffer, width, height, channels, false);
     }
 
     *is_straight_alpha = true;
   }
-  else if (handle->float_colorspace) {
+  else {
+    /* some processors would want to modify float original buffer
+     * before converting it into display byte buffer, so we need to
+     * make sure original's ImBuf buffers wouldn't be modified by
+     * using duplicated buffer here
+     */
+    memcpy(linear_buffer, handle->buffer + buffer_offset, buffer_size * sizeof(float));
+
     /* currently float is non-linear only in sequencer, which is working
      * in its own color space even to handle float buffers.
      * This color space is the same for byte and float images.
      * Need to convert float buffer to linear space before applying display transform
      */
-
-    const char *from_colorspace = handle->float_colorspace;
-    const char *to_colorspace = global_role_scene_linear;
-
-    memcpy(linear_buffer, handle->buffer, buffer_size * sizeof(float));
-
-    if (!is_data && !is_data_display) {
-      IMB_colormanagement_transform(
-          linear_buffer, width, height, channels, from_colorspace, to_colorspace, predivide);
+    if (!is_data && !is_data_display && handle->float_to_scene_linear) {
+      cpu_processor_apply(
+          handle->float_to_scene_linear, linear_buffer, width, height, channels, predivide);
     }
 
     *is_straight_alpha = false;
   }
-  else {
-    /* some processors would want to modify float original buffer
-     * before converting it into display byte buffer, so we need to
-     * make sure original's ImBuf buffers wouldn't be modified by
-     * using duplicated buffer here
-     */
+}
 
-    memcpy(linear_buffer, handle->buffer, buffer_size * sizeof(float));
+/**
+ * Write the display transformed pixels of a block to the byte display buffer. The dither noise
+ * depends on the position in the lines of the thread, not in the block, so it does not change
+ * with the block size.
+ */
+static void display_buffer_apply_store_byte(DisplayBufferThread *handle,
+                                            int start_line,
+                                            int height,
+                                            const float *linear_buffer,
+                                            bool predivide)
+{
+  const int width = handle->width;
+  const int channels = handle->channels;
+  uchar *display_buffer_byte = handle->display_buffer_byte +
+                               size_t(DISPLAY_BUFFER_CHANNELS) * width * start_line;
 
-    *is_straight_alpha = false;
+  if (channels != 4) {
+    /* Dithering and alpha are only used for RGBA buffers. */
+    IMB_buffer_byte_from_float(display_buffer_byte,
+                               linear_buffer,
+                               channels,
+                               0.0f,
+                               IB_PROFILE_SRGB,
+                               IB_PROFILE_SRGB,
+                               false,
+                               width,
+                               height,
+                               width,
+                               width);
+    return;
+  }
+
+  if (handle->dither == 0.0f) {
+    rgba_float_to_uchar_buffer(
+        display_buffer_byte, linear_buffer, int64_t(width) * height, predivide);
+    return;
+  }
+
+  const float inv_width = 1.0f / width;
+  const float inv_height = 1.0f / handle->tot_line;
+  for (int y = 0; y < height; y++) {
+    const float t = float(start_line + y) * inv_height;
+    const float *from = linear_buffer + size_t(width) * y * 4;
+    uchar *to = display_buffer_byte + size_t(width) * y * 4;
+    for (int x = 0; x < width; x++, from += 4, to += 4) {
+      float straight[4];
+      if (predivide) {
+        premul_to_straight_v4_v4(straight, from);
+      }
+      else {
+        copy_v4_v4(straight, from);
+      }
+      const float dither_value = dither_random_value(float(x) * inv_width, t) * 0.0033f *
+                                 handle->dither;
+      to[0] = unit_float_to_uchar_clamp(dither_value + straight[0]);
+      to[1] = unit_float_to_uchar_clamp(dither_value + straight[1]);
+      to[2] = unit_float_to_uchar_clamp(dither_value + straight[2]);
+      to[3] = unit_float_to_uchar_clamp(straight[3]);
+    }
   }
 }
 
@@ -1782,51 +2047,46 @@ static void *do_display_buffer_apply_thread(void *handle_v)
     return nullptr;
   }
 
-  float *display_buffer = handle->display_buffer;
-  uchar *display_buffer_byte = handle->display_buffer_byte;
   int channels = handle->channels;
   int width = handle->width;
   int height = handle->tot_line;
+  const int block_height = std::clamp(DISPLAY_BUFFER_BLOCK_SIZE / width, 1, height);
   float *linear_buffer = static_cast<float *>(MEM_mallocN(
-      size_t(channels) * width * height * sizeof(float), "color conversion linear buffer"));
+      size_t(channels) * width * block_height * sizeof(float), "color conversion linear buffer"));
 
-  bool is_straight_alpha;
-  display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
+  for (int start_line = 0; start_line < height; start_line += block_height) {
+    const int block_lines = std::min(block_height, height - start_line);
 
-  bool predivide = handle->predivide && (is_straight_alpha == false);
+    bool is_straight_alpha;
+    display_buffer_apply_get_linear_buffer(
+        handle, start_line, block_lines, linear_buffer, &is_straight_alpha);
 
-  /* Apply processor (note: data buffers never get color space conversions). */
-  if (!handle->is_data) {
-    IMB_colormanagement_processor_apply(
-        cm_processor, linear_buffer, width, height, channels, predivide);
-  }
+    bool predivide = handle->predivide && (is_straight_alpha == false);
 
-  /* copy result to output buffers */
-  if (display_buffer_byte) {
-    /* do conversion */
-    IMB_buffer_byte_from_float(display_buffer_byte,
-                               linear_buffer,
-                               channels,
-                               handle->dither,
-                               IB_PROFILE_SRGB,
-                               IB_PROFILE_SRGB,
-                               predivide,
-                               width,
-                               height,
-                               width,
-                               width);
-  }
+    /* Apply processor (note: data buffers never get color space conversions). */
+    if (!handle->is_data) {
+      IMB_colormanagement_processor_apply(
+          cm_processor, linear_buffer, width, block_lines, channels, predivide);
+    }
 
-  if (display_buffer) {
-    memcpy(display_buffer, linear_buffer, size_t(width) * height * channels * sizeof(float));
+    /* copy result to output buffers */
+    if (handle->display_buffer_byte) {
+      display_buffer_apply_store_byte(handle, start_line, block_lines, linear_buffer, predivide);
+    }
 
-    if (is_straight_alpha && channels == 4) {
-      const size_t i_last = size_t(width) * height;
-      size_t i;
-      float *fp;
+    if (handle->display_buffer) {
+      float *display_buffer = handle->display_buffer + size_t(channels) * width * start_line;
+      memcpy(
+          display_buffer, linear_buffer, size_t(width) * block_lines * channels * sizeof(float));
 
-      for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
-        straight_to_premul_v4(fp);
+      if (is_straight_alpha && channels == 4) {
+        const size_t i_last = size_t(width) * block_lines;
+        size_t i;
+        float *fp;
+
+        for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
+          straight_to_premul_v4(fp);
+        }
       }
     }
   }
@@ -1836,6 +2096,28 @@ static void *do_display_buffer_apply_thread(void *handle_v)
   return nullptr;
 }
 
+/**
+ * Processor to convert the given color space to scene linear, or null when no conversion is
+ * needed.
+ */
+static OCIO_ConstCPUProcessorRcPtr *display_buffer_to_scene_linear_processor(
+    const char *from_colorspace)
+{
+  if (from_colorspace == nullptr || STREQ(from_colorspace, global_role_scene_linear)) {
+    return nullptr;
+  }
+  ColorSpace *colorspace = colormanage_colorspace_get_named(from_colorspace);
+  if (colorspace == nullptr) {
+    return nullptr;
+  }
+  OCIO_ConstCPUProcessorRcPtr *cpu_processor = colorspace_to_scene_linear_cpu_processor(
+      colorspace);
+  if (cpu_processor == nullptr || OCIO_cpuProcessorIsNoOp(cpu_processor)) {
+    return nullptr;
+  }
+  return cpu_processor;
+}
+
 static void display_buffer_apply_threaded(ImBuf *ibuf,
                                           const float *buffer,
                                           uchar *byte_buffer,
@@ -1852,22 +2134,26 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
   init_data.display_buffer = display_buffer;
   init_data.display_buffer_byte = display_buffer_byte;
 
+  /* The color space processors are looked up once instead of in every thread. */
   if (ibuf->byte_buffer.colorspace != nullptr) {
-    init_data.byte_colorspace = ibuf->byte_buffer.colorspace->name;
+    init_data.byte_to_scene_linear = display_buffer_to_scene_linear_processor(
+        ibuf->byte_buffer.colorspace->name);
   }
   else {
     /* happens for viewer images, which are not so simple to determine where to
      * set image buffer's color spaces
      */
-    init_data.byte_colorspace = global_role_default_byte;
+    init_data.byte_to_scene_linear = display_buffer_to_scene_linear_processor(
+        global_role_default_byte);
   }
 
   if (ibuf->float_buffer.colorspace != nullptr) {
     /* sequencer stores float buffers in non-linear space */
-    init_data.float_colorspace = ibuf->float_buffer.colorspace->name;
+    init_data.float_to_scene_linear = display_buffer_to_scene_linear_processor(
+        ibuf->float_buffer.colorspace->name);
   }
   else {
-    init_data.float_colorspace = nullptr;
+    init_data.float_to_scene_linear = nullptr;
   }
 
   IMB_processor_apply_threaded(ibuf->y,
@@ -77,6 +77,15 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
  */
 ImBuf *MOV_decode_preview_frame(MovieReader *anim);
 
+/**
+ * Decode up to \a frames_num frames around the last requested position in a background thread,
+ * ahead of the position when playing forward and behind it when playing backwards. Avoids stalls
+ * on seeks when playing or scrubbing movies with long GOPs. Disabled by default and when
+ * \a frames_num is zero. The decoded frames are not part of any cache, callers are responsible
+ * for accounting for the memory of up to twice \a frames_num frames per movie.
+ */
+void MOV_set_decode_ahead(MovieReader *anim, int frames_num);
+
 /**
  * Return the length (in frames) of the movie.
  */
@@ -8,6 +8,7 @@
  */
 
 #include <cstdlib>
+#include <mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -19,6 +20,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -848,9 +850,23 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(MovieProxyBuilder *context,
   uint64_t s_dts = context->seek_pos_dts;
   uint64_t pts = av_get_pts_from_frame(in_frame);
 
+  /* Every proxy size has its own scaler and encoder, so they are fed in parallel. An output that
+   * encodes the decoded frame without scaling sets the timestamp of that frame, so it is fed
+   * before the others read from the frame. */
   for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+    if (context->proxy_ctx[i] && !context->proxy_ctx[i]->sws_ctx) {
+      add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+    }
   }
+  blender::threading::parallel_for(
+      blender::IndexRange(context->num_proxy_sizes), 1, [&](const blender::IndexRange range) {
+        for (const int64_t size_index : range) {
+          proxy_output_ctx *proxy_ctx = context->proxy_ctx[size_index];
+          if (proxy_ctx && proxy_ctx->sws_ctx) {
+            add_to_proxy_output_ffmpeg(proxy_ctx, in_frame);
+          }
+        }
+      });
 
   if (!context->start_pts_set) {
     context->start_pts = pts;
@@ -1190,12 +1206,21 @@ void MOV_proxy_builder_finish(MovieProxyBuilder *context, const bool stop)
   UNUSED_VARS(context, stop, proxy_sizes);
 }
 
+/**
+ * Guards the time-code indices of all movies. They are opened lazily, both by the thread that
+ * decodes frames ahead and by callers that query the duration or frame indices of the movie.
+ */
+static std::mutex movie_index_mutex;
+
 void MOV_close_proxies(MovieReader *anim)
 {
   if (anim == nullptr) {
     return;
   }
 
+  /* Frames decoded in the background may depend on the time-code index freed below. */
+  movie_decode_ahead_reset(anim);
+
   for (int i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
     if (anim->proxy_anim[i]) {
       MOV_close(anim->proxy_anim[i]);
@@ -1203,17 +1228,20 @@ void MOV_close_proxies(MovieReader *anim)
     }
   }
 
-  if (anim->record_run) {
-    movie_index_free(anim->record_run);
-    anim->record_run = nullptr;
-  }
-  if (anim->no_gaps) {
-    movie_index_free(anim->no_gaps);
-    anim->no_gaps = nullptr;
+  {
+    std::lock_guard lock(movie_index_mutex);
+    if (anim->record_run) {
+      movie_index_free(anim->record_run);
+      anim->record_run = nullptr;
+    }
+    if (anim->no_gaps) {
+      movie_index_free(anim->no_gaps);
+      anim->no_gaps = nullptr;
+    }
+    anim->indices_tried = 0;
   }
 
   anim->proxies_tried = 0;
-  anim->indices_tried = 0;
 }
 
 void MOV_set_custom_proxy_dir(MovieReader *anim, const char *dir)
@@ -1259,6 +1287,8 @@ const MovieIndex *movie_open_index(MovieReader *anim, IMB_Timecode_Type tc)
 
   MovieIndex **index = nullptr;
 
+  std::lock_guard lock(movie_index_mutex);
+
   if (tc == IMB_TC_RECORD_RUN) {
     index = &anim->record_run;
   }
@@ -14,9 +14,18 @@
 #include <cstdlib>
 #include <sys/types.h>
 
+#ifdef WITH_FFMPEG
+#  include <atomic>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+#include "BLI_map.hh"
 #include "BLI_math_base.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -52,6 +61,7 @@ extern "C" {
 
 #ifdef WITH_FFMPEG
 static void free_anim_ffmpeg(MovieReader *anim);
+static void decode_ahead_free(MovieReader *anim);
 #endif
 
 void MOV_close(MovieReader *anim)
@@ -61,6 +71,7 @@ void MOV_close(MovieReader *anim)
   }
 
 #ifdef WITH_FFMPEG
+  decode_ahead_free(anim);
   free_anim_ffmpeg(anim);
 #endif
   MOV_close_proxies(anim);
@@ -230,6 +241,22 @@ static int calc_pix_fmt_max_component_bits(AVPixelFormat fmt)
   return bits;
 }
 
+/**
+ * Pixel format that high bit depth videos are converted to. Interleaved RGBA floats can be
+ * written by swscale straight into the #ImBuf, but older swscale versions (ffmpeg 6.1 and
+ * before) do not support that as destination. Those convert into planar GBRA floats which are
+ * then interleaved into RGBA manually.
+ */
+static AVPixelFormat ffmpeg_float_pix_fmt_get()
+{
+#  ifdef AV_PIX_FMT_RGBAF32
+  if (sws_isSupportedOutput(AV_PIX_FMT_RGBAF32LE)) {
+    return AV_PIX_FMT_RGBAF32LE;
+  }
+#  endif
+  return AV_PIX_FMT_GBRAPF32LE;
+}
+
 static int startffmpeg(MovieReader *anim)
 {
   const AVCodec *pCodec;
@@ -361,10 +388,7 @@ static int startffmpeg(MovieReader *anim)
   anim->pFrame_complete = false;
   anim->pFrameDeinterlaced = av_frame_alloc();
   anim->pFrameRGB = av_frame_alloc();
-  /* Ideally we'd use AV_PIX_FMT_RGBAF32LE for floats, but currently (ffmpeg 6.1)
-   * swscale does not support that as destination. So using AV_PIX_FMT_GBRAPF32LE
-   * with manual interleaving to RGBA floats. */
-  anim->pFrameRGB->format = anim->is_float ? AV_PIX_FMT_GBRAPF32LE : AV_PIX_FMT_RGBA;
+  anim->pFrameRGB->format = anim->is_float ? ffmpeg_float_pix_fmt_get() : AV_PIX_FMT_RGBA;
   anim->pFrameRGB->width = anim->x;
   anim->pFrameRGB->height = anim->y;
 
@@ -557,7 +581,7 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
     }
   }
 
-  if (anim->is_float) {
+  if (anim->pFrameRGB->format == AV_PIX_FMT_GBRAPF32LE) {
     /* Float images are converted into planar BGRA layout by swscale (since
      * it does not support direct YUV->RGBA float interleaved conversion).
      * Do vertical flip and interleave into RGBA manually. */
@@ -569,27 +593,36 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
                        anim->pFrameRGB->linesize[2] == src_linesize &&
                        anim->pFrameRGB->linesize[3] == src_linesize,
                    "ffmpeg frame should be 4 same size planes for a floating point image case");
-    for (int y = 0; y < ibuf->y; y++) {
-      size_t src_offset = src_linesize * (ibuf->y - y - 1);
-      const float *src_g = reinterpret_cast<const float *>(anim->pFrameRGB->data[0] + src_offset);
-      const float *src_b = reinterpret_cast<const float *>(anim->pFrameRGB->data[1] + src_offset);
-      const float *src_r = reinterpret_cast<const float *>(anim->pFrameRGB->data[2] + src_offset);
-      const float *src_a = reinterpret_cast<const float *>(anim->pFrameRGB->data[3] + src_offset);
-      float *dst = ibuf->float_buffer.data + ibuf->x * y * 4;
-      for (int x = 0; x < ibuf->x; x++) {
-        *dst++ = *src_r++;
-        *dst++ = *src_g++;
-        *dst++ = *src_b++;
-        *dst++ = *src_a++;
-      }
-    }
+    const AVFrame *rgb_frame = anim->pFrameRGB;
+    blender::threading::parallel_for(
+        blender::IndexRange(ibuf->y), 64, [&](const blender::IndexRange y_range) {
+          for (const int64_t y : y_range) {
+            size_t src_offset = src_linesize * (ibuf->y - y - 1);
+            const float *src_g = reinterpret_cast<const float *>(rgb_frame->data[0] + src_offset);
+            const float *src_b = reinterpret_cast<const float *>(rgb_frame->data[1] + src_offset);
+            const float *src_r = reinterpret_cast<const float *>(rgb_frame->data[2] + src_offset);
+            const float *src_a = reinterpret_cast<const float *>(rgb_frame->data[3] + src_offset);
+            float *dst = ibuf->float_buffer.data + ibuf->x * y * 4;
+            for (int x = 0; x < ibuf->x; x++) {
+              *dst++ = *src_r++;
+              *dst++ = *src_g++;
+              *dst++ = *src_b++;
+              *dst++ = *src_a++;
+            }
+          }
+        });
   }
   else {
-    /* If final destination image layout matches that of decoded RGB frame (including
+    /* Interleaved RGBA bytes, or RGBA floats for high bit depth videos.
+     *
+     * If final destination image layout matches that of decoded RGB frame (including
      * any line padding done by ffmpeg for SIMD alignment), we can directly
      * decode into that, doing the vertical flip in the same step. Otherwise have
      * to do a separate flip. */
-    const int ibuf_linesize = ibuf->x * 4;
+    const int pixel_size = anim->is_float ? 16 : 4;
+    uint8_t *ibuf_data = anim->is_float ? reinterpret_cast<uint8_t *>(ibuf->float_buffer.data) :
+                                          ibuf->byte_buffer.data;
+    const int ibuf_linesize = ibuf->x * pixel_size;
     const int rgb_linesize = anim->pFrameRGB->linesize[0];
     bool scale_to_ibuf = (rgb_linesize == ibuf_linesize);
     /* swscale on arm64 before ffmpeg 6.0 (libswscale major version 7)
@@ -604,7 +637,7 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
       /* Decode RGB and do vertical flip directly into destination image, by using negative
        * line size. */
       anim->pFrameRGB->linesize[0] = -ibuf_linesize;
-      anim->pFrameRGB->data[0] = ibuf->byte_buffer.data + (ibuf->y - 1) * ibuf_linesize;
+      anim->pFrameRGB->data[0] = ibuf_data + (ibuf->y - 1) * ibuf_linesize;
 
       ffmpeg_sws_scale_frame(anim->img_convert_ctx, anim->pFrameRGB, input);
 
@@ -623,7 +656,7 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
                                               anim->pFrameRGB->width,
                                               anim->pFrameRGB->height,
                                               1);
-      av_image_copy_to_buffer(ibuf->byte_buffer.data,
+      av_image_copy_to_buffer(ibuf_data,
                               dst_size,
                               src,
                               src_linesize,
@@ -1177,7 +1210,258 @@ static void free_anim_ffmpeg(MovieReader *anim)
   anim->duration_in_frames = 0;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Decode Ahead
+ *
+ * Frames around the last requested position are decoded by a background thread, so sequential
+ * playback does not wait for the decoder. When playing backwards, frames behind the requested
+ * position are decoded in batches in ascending order, so a batch costs one seek and one pass over
+ * the GOP instead of a seek for every frame. Requests for a frame that the thread is about to
+ * decode wait for it instead of moving the decoder elsewhere. The thread exits once all frames
+ * around the requested position are decoded, and is started again by the next request.
+ * \{ */
+
+struct MovieDecodeAhead {
+  /** Guards this struct and the FFmpeg decoding state of the movie. */
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::thread thread;
+  bool thread_running = false;
+  bool stop = false;
+  /** Number of callers waiting for #mutex, the thread yields to them between frames. */
+  std::atomic<int> waiting_num = 0;
+  /** Number of frames decoded after and before the requested position. */
+  int frames_num = 0;
+
+  int requested_position = -1;
+  IMB_Timecode_Type tc = IMB_TC_NONE;
+  bool playing_backwards = false;
+  /** Frames behind the requested position that are decoded in one pass. */
+  int batch_next = 0;
+  int batch_end = -1;
+
+  /** Decoded frames that were not requested yet, null for frames that failed to decode. */
+  blender::Map<int, ImBuf *> frames;
+};
+
+static void decode_ahead_frames_clear(MovieDecodeAhead *decode_ahead)
+{
+  for (ImBuf *ibuf : decode_ahead->frames.values()) {
+    if (ibuf != nullptr) {
+      IMB_freeImBuf(ibuf);
+    }
+  }
+  decode_ahead->frames.clear();
+  decode_ahead->batch_end = -1;
+}
+
+static void decode_ahead_thread_stop(MovieDecodeAhead *decode_ahead)
+{
+  {
+    std::lock_guard lock(decode_ahead->mutex);
+    decode_ahead->stop = true;
+  }
+  decode_ahead->cond.notify_all();
+  if (decode_ahead->thread.joinable()) {
+    decode_ahead->thread.join();
+  }
+  decode_ahead->stop = false;
+}
+
+static void decode_ahead_free(MovieReader *anim)
+{
+  if (anim->decode_ahead == nullptr) {
+    return;
+  }
+  decode_ahead_thread_stop(anim->decode_ahead);
+  decode_ahead_frames_clear(anim->decode_ahead);
+  MEM_delete(anim->decode_ahead);
+  anim->decode_ahead = nullptr;
+}
+
+/** Next frame to decode in the background, or -1 when there is nothing to do. */
+static int decode_ahead_next_position_get(MovieReader *anim)
+{
+  MovieDecodeAhead *decode_ahead = anim->decode_ahead;
+  const int requested = decode_ahead->requested_position;
+
+  if (!decode_ahead->playing_backwards) {
+    const int end = min_ii(requested + decode_ahead->frames_num, anim->duration_in_frames - 1);
+    for (int position = requested + 1; position <= end; position++) {
+      if (!decode_ahead->frames.contains(position)) {
+        return position;
+      }
+    }
+    return -1;
+  }
+
+  if (decode_ahead->batch_next <= decode_ahead->batch_end &&
+      decode_ahead->batch_next < requested)
+  {
+    return decode_ahead->batch_next++;
+  }
+  decode_ahead->batch_end = -1;
+
+  /* Start a new batch once half of the frames behind were used, it covers all frames between the
+   * start of the window and the oldest frame that is still decoded. */
+  const int start = max_ii(requested - decode_ahead->frames_num, 0);
+  int end = requested - 1;
+  int frames_behind_num = 0;
+  for (int position = requested - 1; position >= start; position--) {
+    if (decode_ahead->frames.contains(position)) {
+      frames_behind_num++;
+      end = position - 1;
+    }
+  }
+  if (frames_behind_num * 2 >= decode_ahead->frames_num || start > end) {
+    return -1;
+  }
+
+  decode_ahead->batch_next = start + 1;
+  decode_ahead->batch_end = end;
+  return start;
+}
+
+/** Whether the background thread will decode the frame without seeking elsewhere first. */
+static bool decode_ahead_is_pending(const MovieReader *anim, const int position)
+{
+  const MovieDecodeAhead *decode_ahead = anim->decode_ahead;
+  if (!decode_ahead->thread_running) {
+    return false;
+  }
+  if (decode_ahead->playing_backwards) {
+    return position >= decode_ahead->batch_next && position <= decode_ahead->batch_end;
+  }
+  return position > anim->cur_position &&
+         position <= decode_ahead->requested_position + decode_ahead->frames_num;
+}
+
+static void decode_ahead_thread_run(MovieReader *anim)
+{
+  MovieDecodeAhead *decode_ahead = anim->decode_ahead;
+  std::unique_lock lock(decode_ahead->mutex);
+
+  while (!decode_ahead->stop) {
+    if (decode_ahead->waiting_num > 0) {
+      decode_ahead->cond.wait(
+          lock, [&]() { return decode_ahead->waiting_num == 0 || decode_ahead->stop; });
+      continue;
+    }
+
+    const int position = decode_ahead_next_position_get(anim);
+    if (position == -1) {
+      break;
+    }
+
+    ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, decode_ahead->tc);
+    decode_ahead->frames.add_overwrite(position, ibuf);
+    decode_ahead->cond.notify_all();
+  }
+
+  decode_ahead->thread_running = false;
+  decode_ahead->cond.notify_all();
+}
+
+static ImBuf *decode_ahead_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Type tc)
+{
+  MovieDecodeAhead *decode_ahead = anim->decode_ahead;
+
+  decode_ahead->waiting_num++;
+  std::unique_lock lock(decode_ahead->mutex);
+  decode_ahead->waiting_num--;
+
+  if (tc != decode_ahead->tc) {
+    decode_ahead_frames_clear(decode_ahead);
+    decode_ahead->tc = tc;
+  }
+
+  if (!decode_ahead->frames.contains(position) && decode_ahead_is_pending(anim, position)) {
+    /* The thread may be waiting for #waiting_num to drop. */
+    decode_ahead->cond.notify_all();
+    decode_ahead->cond.wait(lock, [&]() {
+      return decode_ahead->frames.contains(position) || !decode_ahead->thread_running;
+    });
+  }
+
+  /* Hand decoded frame over to the caller, it is not kept around. */
+  ImBuf *ibuf = decode_ahead->frames.pop_default(position, nullptr);
+  if (ibuf == nullptr) {
+    ibuf = ffmpeg_fetchibuf(anim, position, tc);
+  }
+
+  if (position != decode_ahead->requested_position) {
+    const bool playing_backwards = position < decode_ahead->requested_position;
+    if (playing_backwards != decode_ahead->playing_backwards) {
+      decode_ahead->playing_backwards = playing_backwards;
+      decode_ahead->batch_end = -1;
+    }
+  }
+  decode_ahead->requested_position = position;
+
+  decode_ahead->frames.remove_if([&](const blender::Map<int, ImBuf *>::MutableItem item) {
+    if (item.key >= position - decode_ahead->frames_num &&
+        item.key <= position + decode_ahead->frames_num)
+    {
+      return false;
+    }
+    if (item.value != nullptr) {
+      IMB_freeImBuf(item.value);
+    }
+    return true;
+  });
+
+  if (!decode_ahead->thread_running) {
+    /* Previous thread has finished its work, it does not need the lock to exit. */
+    if (decode_ahead->thread.joinable()) {
+      decode_ahead->thread.join();
+    }
+    decode_ahead->thread_running = true;
+    decode_ahead->thread = std::thread(decode_ahead_thread_run, anim);
+  }
+
+  lock.unlock();
+  decode_ahead->cond.notify_all();
+
+  return ibuf;
+}
+
+/** \} */
+
+#endif
+
+void movie_decode_ahead_reset(MovieReader *anim)
+{
+#ifdef WITH_FFMPEG
+  if (anim->decode_ahead == nullptr) {
+    return;
+  }
+  decode_ahead_thread_stop(anim->decode_ahead);
+  decode_ahead_frames_clear(anim->decode_ahead);
+#else
+  UNUSED_VARS(anim);
 #endif
+}
+
+void MOV_set_decode_ahead(MovieReader *anim, const int frames_num)
+{
+#ifdef WITH_FFMPEG
+  if (frames_num <= 0) {
+    decode_ahead_free(anim);
+    return;
+  }
+  if (anim->decode_ahead == nullptr) {
+    anim->decode_ahead = MEM_new<MovieDecodeAhead>(__func__);
+  }
+  else if (anim->decode_ahead->frames_num == frames_num) {
+    return;
+  }
+  decode_ahead_thread_stop(anim->decode_ahead);
+  decode_ahead_frames_clear(anim->decode_ahead);
+  anim->decode_ahead->frames_num = frames_num;
+#else
+  UNUSED_VARS(anim, frames_num);
+#endif
+}
 
 /**
  * Try to initialize the #anim struct.
@@ -1277,15 +1561,17 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
 
 #ifdef WITH_FFMPEG
   if (anim->state == MovieReader::State::Valid) {
-    ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
+    if (anim->decode_ahead) {
+      ibuf = decode_ahead_fetchibuf(anim, position, tc);
+    }
+    else {
+      ibuf = ffmpeg_fetchibuf(anim, position, tc);
     }
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
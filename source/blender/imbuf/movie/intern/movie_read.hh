@@ -20,6 +20,7 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+struct MovieDecodeAhead;
 #endif
 
 struct IDProperty;
@@ -62,6 +63,9 @@ struct MovieReader {
 
   bool seek_before_decode;
   bool is_float;
+
+  /** Background decoding state, null unless enabled with #MOV_set_decode_ahead. */
+  MovieDecodeAhead *decode_ahead;
 #endif
 
   char index_dir[768];
@@ -78,3 +82,9 @@ struct MovieReader {
 
   IDProperty *metadata;
 };
+
+/**
+ * Stop background decoding and discard frames it has decoded so far, for when the decoding state
+ * of the movie changes. Decoding ahead resumes with the next requested frame.
+ */
+void movie_decode_ahead_reset(MovieReader *anim);
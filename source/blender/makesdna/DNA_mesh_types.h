@@ -325,6 +325,14 @@ typedef struct Mesh {
    * Cached map from each vertex to the faces using it.
    */
   blender::GroupedSpan<int> vert_to_face_map() const;
+  /**
+   * Offsets per edge used to slice arrays containing data for connected faces.
+   */
+  blender::OffsetIndices<int> edge_to_face_map_offsets() const;
+  /**
+   * Cached map from each edge to the faces using it, sorted by face index.
+   */
+  blender::GroupedSpan<int> edge_to_face_map() const;
 
   /**
    * Cached information about loose edges, calculated lazily when necessary.
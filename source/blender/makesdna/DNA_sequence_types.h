@@ -31,14 +31,17 @@ struct bSound;
 #ifdef __cplusplus
 namespace blender::seq {
 struct MediaPresence;
+struct RenderTimings;
 struct ThumbnailCache;
 struct TextVarsRuntime;
 }  // namespace blender::seq
 using MediaPresence = blender::seq::MediaPresence;
+using RenderTimings = blender::seq::RenderTimings;
 using ThumbnailCache = blender::seq::ThumbnailCache;
 using TextVarsRuntime = blender::seq::TextVarsRuntime;
 #else
 typedef struct MediaPresence MediaPresence;
+typedef struct RenderTimings RenderTimings;
 typedef struct ThumbnailCache ThumbnailCache;
 typedef struct TextVarsRuntime TextVarsRuntime;
 #endif
@@ -326,7 +329,8 @@ typedef struct EditingRuntime {
   struct SequenceLookup *sequence_lookup;
   MediaPresence *media_presence;
   ThumbnailCache *thumbnail_cache;
-  void *_pad;
+  /** Only set while recording render timings, see `SEQ_render_timing.hh`. */
+  RenderTimings *render_timings;
 } EditingRuntime;
 
 typedef struct Editing {
@@ -644,6 +644,7 @@ typedef enum eSpaceSeq_SequencerTimelineOverlay_Flag {
   SEQ_TIMELINE_SHOW_STRIP_SOURCE = (1 << 15),
   SEQ_TIMELINE_SHOW_STRIP_DURATION = (1 << 16),
   SEQ_TIMELINE_SHOW_GRID = (1 << 18),
+  SEQ_TIMELINE_SHOW_RENDER_TIMES = (1 << 19),
 } eSpaceSeq_SequencerTimelineOverlay_Flag;
 
 typedef struct SequencerCacheOverlay {
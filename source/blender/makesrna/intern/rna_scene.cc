@@ -6782,6 +6782,11 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
        "Auto",
        "Full precision for final renders, half precision otherwise"},
       {SCE_COMPOSITOR_PRECISION_FULL, "FULL", 0, "Full", "Full precision"},
+      {SCE_COMPOSITOR_PRECISION_HALF,
+       "HALF",
+       0,
+       "Half",
+       "Half precision, which halves the memory needed by intermediate color images"},
       {0, nullptr, 0, nullptr, nullptr},
   };
 
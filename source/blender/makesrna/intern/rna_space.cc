@@ -2539,6 +2539,14 @@ static std::optional<std::string> rna_SpaceSequencerTimelineOverlay_path(const P
       "{}{}{}", editor_path.value_or(""), editor_path ? "." : "", "timeline_overlay");
 }
 
+static void rna_SequencerTimelineOverlay_show_render_times_update(Main *bmain,
+                                                                 Scene *scene,
+                                                                 PointerRNA *ptr)
+{
+  SpaceSeq *sseq = static_cast<SpaceSeq *>(ptr->data);
+  ED_sequencer_render_timings_user_update(bmain, sseq, scene);
+}
+
 static PointerRNA rna_SpaceSequenceEditor_cache_overlay_get(PointerRNA *ptr)
 {
   return rna_pointer_inherit_refine(ptr, &RNA_SequencerCacheOverlay, ptr->data);
@@ -6076,6 +6084,18 @@ static void rna_def_space_sequencer_timeline_overlay(BlenderRNA *brna)
       prop, nullptr, "timeline_overlay.flag", SEQ_TIMELINE_SHOW_STRIP_RETIMING);
   RNA_def_property_ui_text(prop, "Show Retiming Keys", "Display retiming keys on top of strips");
   RNA_def_property_update(prop, NC_SPACE | ND_SPACE_SEQUENCER, nullptr);
+
+  prop = RNA_def_property(srna, "show_render_times", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(
+      prop, nullptr, "timeline_overlay.flag", SEQ_TIMELINE_SHOW_RENDER_TIMES);
+  RNA_def_property_ui_text(
+      prop,
+      "Show Render Times",
+      "Record the time spent rendering each strip and display it per frame, relative to the "
+      "frame duration");
+  RNA_def_property_update(prop,
+                          NC_SPACE | ND_SPACE_SEQUENCER,
+                          "rna_SequencerTimelineOverlay_show_render_times_update");
 }
 
 static void rna_def_space_sequencer_cache_overlay(BlenderRNA *brna)
@@ -983,45 +983,6 @@ static BakeFrameIndices get_bake_frame_indices(
   return frame_indices;
 }
 
-static void ensure_bake_loaded(bake::NodeBakeCache &bake_cache, bake::FrameCache &frame_cache)
-{
-  if (!frame_cache.state.items_by_id.is_empty()) {
-    return;
-  }
-  if (!frame_cache.meta_data_source.has_value()) {
-    return;
-  }
-  if (bake_cache.memory_blob_reader) {
-    if (const auto *meta_buffer = std::get_if<Span<std::byte>>(&*frame_cache.meta_data_source)) {
-      const std::string meta_str{reinterpret_cast<const char *>(meta_buffer->data()),
-                                 size_t(meta_buffer->size())};
-      std::istringstream meta_stream{meta_str};
-      std::optional<bake::BakeState> bake_state = bake::deserialize_bake(
-          meta_stream, *bake_cache.memory_blob_reader, *bake_cache.blob_sharing);
-      if (!bake_state.has_value()) {
-        return;
-      }
-      frame_cache.state = std::move(*bake_state);
-      return;
-    }
-  }
-  if (!bake_cache.blobs_dir) {
-    return;
-  }
-  const auto *meta_path = std::get_if<std::string>(&*frame_cache.meta_data_source);
-  if (!meta_path) {
-    return;
-  }
-  bake::DiskBlobReader blob_reader{*bake_cache.blobs_dir};
-  fstream meta_file{*meta_path};
-  std::optional<bake::BakeState> bake_state = bake::deserialize_bake(
-      meta_file, blob_reader, *bake_cache.blob_sharing);
-  if (!bake_state.has_value()) {
-    return;
-  }
-  frame_cache.state = std::move(*bake_state);
-}
-
 static bool try_find_baked_data(const NodesModifierBake &bake,
                                 bake::NodeBakeCache &bake_cache,
                                 const Main &bmain,
@@ -1103,6 +1064,11 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
   bake::ModifierCache *modifier_cache_;
   float fps_;
   bool has_invalid_simulation_ = false;
+  /**
+   * Session UIDs of the baked frames whose state is referenced by this evaluation, see
+   * #FrameCache::users_num.
+   */
+  mutable Vector<uint64_t> used_frame_session_uids_;
 
  public:
   struct DataPerZone {
@@ -1160,6 +1126,15 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
     }
   }
 
+  ~NodesModifierSimulationParams()
+  {
+    if (used_frame_session_uids_.is_empty()) {
+      return;
+    }
+    std::lock_guard lock{modifier_cache_->mutex};
+    modifier_cache_->remove_frame_users(used_frame_session_uids_);
+  }
+
   void reset_invalid_node_bakes()
   {
     for (auto item : modifier_cache_->simulation_cache_by_id.items()) {
@@ -1401,12 +1376,23 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
     }
   }
 
+  /** Keep the state of the frame alive while it is referenced by this evaluation. */
+  void add_frame_user(bake::FrameCache &frame_cache) const
+  {
+    frame_cache.users_num++;
+    used_frame_session_uids_.append(frame_cache.session_uid);
+  }
+
   void read_single(const int frame_index,
                    bake::SimulationNodeCache &node_cache,
                    nodes::SimulationZoneBehavior &zone_behavior) const
   {
     bake::FrameCache &frame_cache = *node_cache.bake.frames[frame_index];
-    ensure_bake_loaded(node_cache.bake, frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, frame_cache);
+    this->add_frame_user(frame_cache);
+    if (depsgraph_is_active_) {
+      bake::prefetch_frames(node_cache.bake, frame_index, current_frame_);
+    }
     auto &read_single_info = zone_behavior.output.emplace<sim_output::ReadSingle>();
     read_single_info.state = frame_cache.state;
   }
@@ -1418,8 +1404,13 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
   {
     bake::FrameCache &prev_frame_cache = *node_cache.bake.frames[prev_frame_index];
     bake::FrameCache &next_frame_cache = *node_cache.bake.frames[next_frame_index];
-    ensure_bake_loaded(node_cache.bake, prev_frame_cache);
-    ensure_bake_loaded(node_cache.bake, next_frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, prev_frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, next_frame_cache);
+    this->add_frame_user(prev_frame_cache);
+    this->add_frame_user(next_frame_cache);
+    if (depsgraph_is_active_) {
+      bake::prefetch_frames(node_cache.bake, prev_frame_index, current_frame_);
+    }
     auto &read_interpolated_info = zone_behavior.output.emplace<sim_output::ReadInterpolated>();
     read_interpolated_info.mix_factor = (float(current_frame_) - float(prev_frame_cache.frame)) /
                                         (float(next_frame_cache.frame) -
@@ -1437,6 +1428,11 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
   SubFrame current_frame_;
   bake::ModifierCache *modifier_cache_;
   bool depsgraph_is_active_;
+  /**
+   * Session UIDs of the baked frames whose state is referenced by this evaluation, see
+   * #FrameCache::users_num.
+   */
+  mutable Vector<uint64_t> used_frame_session_uids_;
 
  public:
   struct DataPerNode {
@@ -1456,6 +1452,15 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
     bmain_ = DEG_get_bmain(depsgraph);
   }
 
+  ~NodesModifierBakeParams()
+  {
+    if (used_frame_session_uids_.is_empty()) {
+      return;
+    }
+    std::lock_guard lock{modifier_cache_->mutex};
+    modifier_cache_->remove_frame_users(used_frame_session_uids_);
+  }
+
   nodes::BakeNodeBehavior *get(const int id) const
   {
     if (!modifier_cache_) {
@@ -1544,12 +1549,23 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
     BLI_assert_unreachable();
   }
 
+  /** Keep the state of the frame alive while it is referenced by this evaluation. */
+  void add_frame_user(bake::FrameCache &frame_cache) const
+  {
+    frame_cache.users_num++;
+    used_frame_session_uids_.append(frame_cache.session_uid);
+  }
+
   void read_single(const int frame_index,
                    bake::BakeNodeCache &node_cache,
                    nodes::BakeNodeBehavior &behavior) const
   {
     bake::FrameCache &frame_cache = *node_cache.bake.frames[frame_index];
-    ensure_bake_loaded(node_cache.bake, frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, frame_cache);
+    this->add_frame_user(frame_cache);
+    if (depsgraph_is_active_) {
+      bake::prefetch_frames(node_cache.bake, frame_index, current_frame_);
+    }
     if (this->check_read_error(frame_cache, behavior)) {
       return;
     }
@@ -1564,8 +1580,13 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
   {
     bake::FrameCache &prev_frame_cache = *node_cache.bake.frames[prev_frame_index];
     bake::FrameCache &next_frame_cache = *node_cache.bake.frames[next_frame_index];
-    ensure_bake_loaded(node_cache.bake, prev_frame_cache);
-    ensure_bake_loaded(node_cache.bake, next_frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, prev_frame_cache);
+    bake::ensure_frame_loaded(node_cache.bake, next_frame_cache);
+    this->add_frame_user(prev_frame_cache);
+    this->add_frame_user(next_frame_cache);
+    if (depsgraph_is_active_) {
+      bake::prefetch_frames(node_cache.bake, prev_frame_index, current_frame_);
+    }
     if (this->check_read_error(prev_frame_cache, behavior) ||
         this->check_read_error(next_frame_cache, behavior))
     {
@@ -7,6 +7,7 @@
  */
 
 #include "BLI_assert.h"
+#include "BLI_bounds_types.hh"
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
@@ -23,6 +24,7 @@
 #include "COM_algorithm_recursive_gaussian_blur.hh"
 #include "COM_algorithm_symmetric_separable_blur.hh"
 #include "COM_node_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_symmetric_blur_weights.hh"
 #include "COM_utilities.hh"
 
@@ -97,6 +99,30 @@ static void node_composit_buts_blur(uiLayout *layout, bContext * /*C*/, PointerR
 
 using namespace blender::compositor;
 
+/* Computes the blur radius of a blur node with the given data for an image of the given size,
+ * where size is the value of the Size input of the node. */
+static float2 compute_blur_radius(const NodeBlurData &data, int2 image_size, const float size)
+{
+  if (!data.relative) {
+    return float2(data.sizex, data.sizey) * size;
+  }
+
+  switch (data.aspect) {
+    case CMP_NODE_BLUR_ASPECT_Y:
+      image_size.y = image_size.x;
+      break;
+    case CMP_NODE_BLUR_ASPECT_X:
+      image_size.x = image_size.y;
+      break;
+    default:
+      BLI_assert(data.aspect == CMP_NODE_BLUR_ASPECT_NONE);
+      break;
+  }
+
+  const float2 size_factor = float2(data.percentx, data.percenty) / 100.0f;
+  return float2(image_size) * size_factor * size;
+}
+
 class BlurOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
@@ -423,25 +449,8 @@ class BlurOperation : public NodeOperation {
   float2 compute_blur_radius()
   {
     const float size = math::clamp(get_input("Size").get_single_value_default(1.0f), 0.0f, 1.0f);
-
-    if (!node_storage(bnode()).relative) {
-      return float2(node_storage(bnode()).sizex, node_storage(bnode()).sizey) * size;
-    }
-
-    int2 image_size = get_input("Image").domain().size;
-    switch (node_storage(bnode()).aspect) {
-      case CMP_NODE_BLUR_ASPECT_Y:
-        image_size.y = image_size.x;
-        break;
-      case CMP_NODE_BLUR_ASPECT_X:
-        image_size.x = image_size.y;
-        break;
-      default:
-        BLI_assert(node_storage(bnode()).aspect == CMP_NODE_BLUR_ASPECT_NONE);
-        break;
-    }
-
-    return float2(image_size) * get_size_factor() * size;
+    return node_composite_blur_cc::compute_blur_radius(
+        node_storage(bnode()), get_input("Image").domain().size, size);
   }
 
   /* Returns true if the operation does nothing and the input can be passed through. */
@@ -489,11 +498,6 @@ class BlurOperation : public NodeOperation {
            node_storage(bnode()).filtertype != R_FILTER_FAST_GAUSS;
   }
 
-  float2 get_size_factor()
-  {
-    return float2(node_storage(bnode()).percentx, node_storage(bnode()).percenty) / 100.0f;
-  }
-
   bool should_apply_gamma_correction()
   {
     return node_storage(this->bnode()).gamma;
@@ -515,6 +519,37 @@ static NodeOperation *get_compositor_operation(Context &context, DNode node)
   return new BlurOperation(context, node);
 }
 
+static void get_compositor_input_region(InputRegionParams &params)
+{
+  const Region output_region = params.compute_output_region(params.input_size);
+  if (!output_region) {
+    params.input_region = std::nullopt;
+    return;
+  }
+
+  /* The recursive Gaussian filter is computed over entire rows and columns, and extended bounds
+   * change the size of the output, so the entire input is needed. */
+  const bNode &node = *params.input.node().bnode();
+  if (node_storage(node).filtertype == R_FILTER_FAST_GAUSS ||
+      node.custom1 & CMP_NODEFLAG_BLUR_EXTEND_BOUNDS)
+  {
+    return;
+  }
+
+  /* The Size input is at most one, so if it is linked, the radius at a size of one is the largest
+   * radius any pixel can have. */
+  const bNodeSocket &size_input = node.input_by_identifier("Size");
+  const float size_value = size_input.default_value_typed<bNodeSocketValueFloat>()->value;
+  const float size = size_input.is_logically_linked() ? 1.0f :
+                                                        math::clamp(size_value, 0.0f, 1.0f);
+  const float2 radius = compute_blur_radius(node_storage(node), params.input_size, size);
+
+  /* Pad by an extra pixel to account for the rounding of the radius in the different filters. */
+  Bounds<int2> input_region = *output_region;
+  input_region.pad(int2(math::ceil(radius)) + 1);
+  params.input_region = input_region;
+}
+
 }  // namespace blender::nodes::node_composite_blur_cc
 
 void register_node_type_cmp_blur()
@@ -532,6 +567,7 @@ void register_node_type_cmp_blur()
   blender::bke::node_type_storage(
       &ntype, "NodeBlurData", node_free_standard_storage, node_copy_standard_storage);
   ntype.get_compositor_operation = file_ns::get_compositor_operation;
+  ntype.get_compositor_input_region = file_ns::get_compositor_input_region;
 
   blender::bke::node_register_type(&ntype);
 }
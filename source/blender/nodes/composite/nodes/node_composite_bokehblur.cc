@@ -14,6 +14,7 @@
 
 #include "GPU_texture.hh"
 
+#include "COM_algorithm_fft_convolution.hh"
 #include "COM_algorithm_parallel_reduction.hh"
 #include "COM_node_operation.hh"
 #include "COM_utilities.hh"
@@ -66,6 +67,11 @@ class BokehBlurOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
 
+  bool should_cache_outputs() override
+  {
+    return true;
+  }
+
   void execute() override
   {
     if (is_identity()) {
@@ -132,6 +138,15 @@ class BokehBlurOperation : public NodeOperation {
     const int radius = int(this->compute_blur_radius());
     const bool extend_bounds = this->get_extend_bounds();
 
+    Result blur_kernel = this->compute_blur_kernel(radius);
+
+    /* Large kernels are convolved in the frequency domain, see should_use_fft_convolution. */
+    if (should_use_fft_convolution(this->context(), blur_kernel.domain().size)) {
+      this->execute_constant_size_fft(blur_kernel);
+      blur_kernel.release();
+      return;
+    }
+
     const Result &input = this->get_input("Image");
     const Result &mask_image = this->get_input("Bounding box");
 
@@ -144,8 +159,6 @@ class BokehBlurOperation : public NodeOperation {
     Result &output = this->get_result("Image");
     output.allocate_texture(domain);
 
-    Result blur_kernel = this->compute_blur_kernel(radius);
-
     auto load_input = [&](const int2 texel) {
       /* If bounds are extended, then we treat the input as padded by a radius amount of pixels.
        * So we load the input with an offset by the radius amount and fallback to a transparent
@@ -183,6 +196,27 @@ class BokehBlurOperation : public NodeOperation {
     blur_kernel.release();
   }
 
+  void execute_constant_size_fft(const Result &blur_kernel)
+  {
+    const Result &input = this->get_input("Image");
+    Result &output = this->get_result("Image");
+    fft_convolution(this->context(), input, blur_kernel, output, this->get_extend_bounds());
+
+    /* The mask input is treated as a boolean. If it is zero, then no blurring happens for this
+     * pixel, so the blurred pixel is replaced by the input pixel. A single value mask is non zero,
+     * since a zero mask is an identity operation. */
+    const Result &mask_image = this->get_input("Bounding box");
+    if (mask_image.is_single_value()) {
+      return;
+    }
+
+    parallel_for(output.domain().size, [&](const int2 texel) {
+      if (mask_image.load_pixel<float>(texel) == 0.0f) {
+        output.store_pixel(texel, input.load_pixel<float4>(texel));
+      }
+    });
+  }
+
   void execute_variable_size()
   {
     if (this->context().use_gpu()) {
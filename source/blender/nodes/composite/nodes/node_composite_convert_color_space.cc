@@ -6,7 +6,12 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 
 #include "UI_interface.hh"
 #include "UI_resources.hh"
@@ -135,16 +140,42 @@ class ConvertColorSpaceOperation : public NodeOperation {
     Result &output_image = get_result("Image");
     output_image.allocate_texture(domain);
 
-    parallel_for(domain.size, [&](const int2 texel) {
-      output_image.store_pixel(texel, input_image.load_pixel<float4>(texel));
-    });
+    /* The color processor only operates on float buffers while the output might be stored in
+     * half precision, so the image is processed in bands of rows that are loaded into full
+     * precision buffers, which also allows processing the bands in parallel. */
+    const int band_size = 16;
+    threading::parallel_for(
+        IndexRange(domain.size.y), band_size, [&](const IndexRange sub_y_range) {
+          Array<float4> band_buffer(int64_t(band_size) * domain.size.x);
+          for (int64_t band_start = sub_y_range.first(); band_start < sub_y_range.one_after_last();
+               band_start += band_size)
+          {
+            const IndexRange band = IndexRange::from_begin_end(
+                band_start, math::min(band_start + band_size, sub_y_range.one_after_last()));
+
+            for (const int64_t y : band) {
+              for (const int64_t x : IndexRange(domain.size.x)) {
+                band_buffer[(y - band.first()) * domain.size.x + x] =
+                    input_image.load_pixel<float4>(int2(x, y));
+              }
+            }
+
+            IMB_colormanagement_processor_apply(color_processor,
+                                                reinterpret_cast<float *>(band_buffer.data()),
+                                                domain.size.x,
+                                                band.size(),
+                                                4,
+                                                false);
+
+            for (const int64_t y : band) {
+              for (const int64_t x : IndexRange(domain.size.x)) {
+                output_image.store_pixel(int2(x, y),
+                                         band_buffer[(y - band.first()) * domain.size.x + x]);
+              }
+            }
+          }
+        });
 
-    IMB_colormanagement_processor_apply(color_processor,
-                                        output_image.float_texture(),
-                                        domain.size.x,
-                                        domain.size.y,
-                                        input_image.channels_count(),
-                                        false);
     IMB_colormanagement_processor_free(color_processor);
   }
 
@@ -6,6 +6,8 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
 #include "BLI_math_base.h"
 #include "BLI_math_vector_types.hh"
 
@@ -20,6 +22,7 @@
 #include "GPU_texture.hh"
 
 #include "COM_node_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_utilities.hh"
 
 #include "node_composite_util.hh"
@@ -72,6 +75,38 @@ static void node_composit_buts_crop(uiLayout *layout, bContext * /*C*/, PointerR
 
 using namespace blender::compositor;
 
+/* Computes the cropping bounds of the given crop node for an input image of the given size. The
+ * lower bound is inclusive and the upper bound is exclusive. */
+static void compute_cropping_bounds(const bNode &node,
+                                    const int2 input_size,
+                                    int2 &lower_bound,
+                                    int2 &upper_bound)
+{
+  const NodeTwoXYs &node_two_xys = node_storage(node);
+
+  if (node.custom2) {
+    /* The cropping bounds are relative to the image size. The factors are in the [0, 1] range,
+     * so it is guaranteed that they won't go over the input image size. */
+    lower_bound.x = input_size.x * node_two_xys.fac_x1;
+    lower_bound.y = input_size.y * node_two_xys.fac_y2;
+    upper_bound.x = input_size.x * node_two_xys.fac_x2;
+    upper_bound.y = input_size.y * node_two_xys.fac_y1;
+  }
+  else {
+    /* Make sure the bounds don't go over the input image size. */
+    lower_bound.x = min_ii(node_two_xys.x1, input_size.x);
+    lower_bound.y = min_ii(node_two_xys.y2, input_size.y);
+    upper_bound.x = min_ii(node_two_xys.x2, input_size.x);
+    upper_bound.y = min_ii(node_two_xys.y1, input_size.y);
+  }
+
+  /* Make sure upper bound is actually higher than the lower bound. */
+  lower_bound.x = min_ii(lower_bound.x, upper_bound.x);
+  lower_bound.y = min_ii(lower_bound.y, upper_bound.y);
+  upper_bound.x = max_ii(lower_bound.x, upper_bound.x);
+  upper_bound.y = max_ii(lower_bound.y, upper_bound.y);
+}
+
 class CropOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
@@ -252,30 +287,8 @@ class CropOperation : public NodeOperation {
 
   void compute_cropping_bounds(int2 &lower_bound, int2 &upper_bound)
   {
-    const NodeTwoXYs &node_two_xys = node_storage(bnode());
-    const int2 input_size = get_input("Image").domain().size;
-
-    if (get_is_relative()) {
-      /* The cropping bounds are relative to the image size. The factors are in the [0, 1] range,
-       * so it is guaranteed that they won't go over the input image size. */
-      lower_bound.x = input_size.x * node_two_xys.fac_x1;
-      lower_bound.y = input_size.y * node_two_xys.fac_y2;
-      upper_bound.x = input_size.x * node_two_xys.fac_x2;
-      upper_bound.y = input_size.y * node_two_xys.fac_y1;
-    }
-    else {
-      /* Make sure the bounds don't go over the input image size. */
-      lower_bound.x = min_ii(node_two_xys.x1, input_size.x);
-      lower_bound.y = min_ii(node_two_xys.y2, input_size.y);
-      upper_bound.x = min_ii(node_two_xys.x2, input_size.x);
-      upper_bound.y = min_ii(node_two_xys.y1, input_size.y);
-    }
-
-    /* Make sure upper bound is actually higher than the lower bound. */
-    lower_bound.x = min_ii(lower_bound.x, upper_bound.x);
-    lower_bound.y = min_ii(lower_bound.y, upper_bound.y);
-    upper_bound.x = max_ii(lower_bound.x, upper_bound.x);
-    upper_bound.y = max_ii(lower_bound.y, upper_bound.y);
+    node_composite_crop_cc::compute_cropping_bounds(
+        bnode(), get_input("Image").domain().size, lower_bound, upper_bound);
   }
 };
 
@@ -284,6 +297,29 @@ static NodeOperation *get_compositor_operation(Context &context, DNode node)
   return new CropOperation(context, node);
 }
 
+static void get_compositor_input_region(InputRegionParams &params)
+{
+  const bNode &node = *params.input.node().bnode();
+  int2 lower_bound, upper_bound;
+  compute_cropping_bounds(node, params.input_size, lower_bound, upper_bound);
+
+  /* Image crop. The output only covers the cropping bounds, so the needed region of the output is
+   * offset by the lower bound of the cropping bounds. */
+  const bool is_identity = lower_bound == int2(0) && upper_bound == params.input_size;
+  if (node.custom1 && !is_identity) {
+    Region region = params.compute_output_region(upper_bound - lower_bound);
+    if (region) {
+      region->translate(lower_bound);
+    }
+    params.input_region = region;
+    return;
+  }
+
+  /* Alpha crop. Areas outside of the cropping bounds are not read. */
+  params.input_region = bounds::intersect(params.compute_output_region(params.input_size),
+                                          Region(Bounds<int2>(lower_bound, upper_bound)));
+}
+
 }  // namespace blender::nodes::node_composite_crop_cc
 
 void register_node_type_cmp_crop()
@@ -300,6 +336,7 @@ void register_node_type_cmp_crop()
   blender::bke::node_type_storage(
       &ntype, "NodeTwoXYs", node_free_standard_storage, node_copy_standard_storage);
   ntype.get_compositor_operation = file_ns::get_compositor_operation;
+  ntype.get_compositor_input_region = file_ns::get_compositor_input_region;
 
   blender::bke::node_register_type(&ntype);
 }
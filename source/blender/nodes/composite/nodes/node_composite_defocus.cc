@@ -8,6 +8,7 @@
 
 #include <climits>
 
+#include "BLI_hash.hh"
 #include "BLI_math_base.hh"
 #include "BLI_math_vector_types.hh"
 
@@ -22,6 +23,7 @@
 #include "UI_interface.hh"
 #include "UI_resources.hh"
 
+#include "COM_algorithm_fft_convolution.hh"
 #include "COM_algorithm_gamma_correct.hh"
 #include "COM_algorithm_morphological_blur.hh"
 #include "COM_bokeh_kernel.hh"
@@ -100,6 +102,22 @@ class DefocusOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
 
+  bool should_cache_outputs() override
+  {
+    return true;
+  }
+
+  uint64_t compute_cache_parameters_hash() override
+  {
+    /* The defocus radius depends on the camera of the scene. */
+    const Camera *camera = this->get_camera();
+    return get_default_hash(
+        this->get_focal_length(),
+        this->compute_focus_distance(),
+        camera ? get_default_hash(int(camera->sensor_fit), camera->sensor_x, camera->sensor_y) :
+                 0);
+  }
+
   void execute() override
   {
     Result &input = get_input("Image");
@@ -191,9 +209,6 @@ class DefocusOperation : public NodeOperation {
                    Result &output,
                    const int search_radius)
   {
-    const Domain domain = compute_domain();
-    output.allocate_texture(domain);
-
     /* Given the texel in the range [-radius, radius] in both axis, load the appropriate weight
      * from the weights image, where the given texel (0, 0) corresponds the center of weights
      * image. Note that we load the weights image inverted along both directions to maintain
@@ -216,6 +231,30 @@ class DefocusOperation : public NodeOperation {
           1.0f - ((float2(texel) + float2(radius + 0.5f)) / (radius * 2.0f + 1.0f)));
     };
 
+    /* If the radius is the same for all pixels, then defocus is a convolution with a constant
+     * kernel, which is faster to compute in the frequency domain if the kernel is large. Only the
+     * pixels whose distances are less than the radius are in the window, so the radius of the
+     * kernel is the integer part of the radius. */
+    if (radius.is_single_value()) {
+      const float constant_radius = math::max(0.0f, radius.get_single_value<float>());
+      const int kernel_radius = math::min(int(constant_radius), search_radius);
+      const int2 kernel_size = int2(kernel_radius * 2 + 1);
+      if (should_use_fft_convolution(this->context(), kernel_size)) {
+        Result kernel = this->context().create_result(ResultType::Color);
+        kernel.allocate_texture(kernel_size);
+        parallel_for(kernel_size, [&](const int2 texel) {
+          kernel.store_pixel(texel, load_weight(texel - kernel_radius, constant_radius));
+        });
+
+        fft_convolution(this->context(), input, kernel, output);
+        kernel.release();
+        return;
+      }
+    }
+
+    const Domain domain = compute_domain();
+    output.allocate_texture(domain);
+
     parallel_for(domain.size, [&](const int2 texel) {
       float center_radius = math::max(0.0f, radius.load_pixel<float, true>(texel));
 
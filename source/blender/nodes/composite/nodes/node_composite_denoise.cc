@@ -6,6 +6,7 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_hash.hh"
 #include "BLI_system.h"
 
 #include "MEM_guardedalloc.h"
@@ -95,6 +96,17 @@ class DenoiseOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
 
+  bool should_cache_outputs() override
+  {
+    return true;
+  }
+
+  uint64_t compute_cache_parameters_hash() override
+  {
+    /* The quality might be inherited from the scene, see get_quality. */
+    return get_default_hash(int(this->context().get_denoise_quality()));
+  }
+
   void execute() override
   {
     Result &input_image = get_input("Image");
@@ -114,25 +126,38 @@ class DenoiseOperation : public NodeOperation {
 
     const int width = input_image.domain().size.x;
     const int height = input_image.domain().size.y;
-    const int pixel_stride = sizeof(float) * 4;
     const eGPUDataFormat data_format = GPU_DATA_FLOAT;
 
-    float *input_color = nullptr;
-    float *output_color = nullptr;
+    /* Sets the given buffer of the given result as the image of the given name in the given
+     * filter. Buffers have four channels, only the first three of which are denoised, and the CPU
+     * data of results might be stored in half precision, which OIDN supports directly. */
+    auto set_filter_image = [&](oidn::FilterRef &filter,
+                                const char *name,
+                                const Result &result,
+                                void *buffer) {
+      const bool is_half = !this->context().use_gpu() &&
+                           result.storage_type() == ResultStorageType::HalfCPU;
+      const oidn::Format format = is_half ? oidn::Format::Half3 : oidn::Format::Float3;
+      const size_t pixel_stride = (is_half ? sizeof(uint16_t) : sizeof(float)) * 4;
+      filter.setImage(name, buffer, format, width, height, 0, pixel_stride);
+    };
+
+    void *input_color = nullptr;
+    void *output_color = nullptr;
     if (this->context().use_gpu()) {
       /* Download the input texture and set it as both the input and output of the filter to
        * denoise it in-place. */
       GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-      input_color = static_cast<float *>(GPU_texture_read(input_image, data_format, 0));
+      input_color = GPU_texture_read(input_image, data_format, 0);
       output_color = input_color;
     }
     else {
-      input_color = input_image.float_texture();
-      output_color = output_image.float_texture();
+      input_color = input_image.data();
+      output_color = output_image.data();
     }
     oidn::FilterRef filter = device.newFilter("RT");
-    filter.setImage("color", input_color, oidn::Format::Float3, width, height, 0, pixel_stride);
-    filter.setImage("output", output_color, oidn::Format::Float3, width, height, 0, pixel_stride);
+    set_filter_image(filter, "color", input_image, input_color);
+    set_filter_image(filter, "output", output_image, output_color);
     filter.set("hdr", use_hdr());
     filter.set("cleanAux", auxiliary_passes_are_clean());
     this->set_filter_quality(filter);
@@ -140,58 +165,54 @@ class DenoiseOperation : public NodeOperation {
 
     /* If the albedo input is not a single value input, download the albedo texture, denoise it
      * in-place if denoising auxiliary passes is needed, and set it to the main filter. */
-    float *albedo = nullptr;
+    void *albedo = nullptr;
     Result &input_albedo = get_input("Albedo");
     if (!input_albedo.is_single_value()) {
       if (this->context().use_gpu()) {
-        albedo = static_cast<float *>(GPU_texture_read(input_albedo, data_format, 0));
+        albedo = GPU_texture_read(input_albedo, data_format, 0);
       }
       else {
-        albedo = input_albedo.float_texture();
+        albedo = input_albedo.data();
       }
 
       if (should_denoise_auxiliary_passes()) {
         oidn::FilterRef albedoFilter = device.newFilter("RT");
         this->set_filter_quality(albedoFilter);
-        albedoFilter.setImage(
-            "albedo", albedo, oidn::Format::Float3, width, height, 0, pixel_stride);
-        albedoFilter.setImage(
-            "output", albedo, oidn::Format::Float3, width, height, 0, pixel_stride);
+        set_filter_image(albedoFilter, "albedo", input_albedo, albedo);
+        set_filter_image(albedoFilter, "output", input_albedo, albedo);
         albedoFilter.setProgressMonitorFunction(oidn_progress_monitor_function, &context());
         albedoFilter.commit();
         albedoFilter.execute();
       }
 
-      filter.setImage("albedo", albedo, oidn::Format::Float3, width, height, 0, pixel_stride);
+      set_filter_image(filter, "albedo", input_albedo, albedo);
     }
 
     /* If the albedo and normal inputs are not single value inputs, download the normal texture,
      * denoise it in-place if denoising auxiliary passes is needed, and set it to the main filter.
      * Notice that we also consider the albedo input because OIDN doesn't support denoising with
      * only the normal auxiliary pass. */
-    float *normal = nullptr;
+    void *normal = nullptr;
     Result &input_normal = get_input("Normal");
     if (albedo && !input_normal.is_single_value()) {
       if (this->context().use_gpu()) {
-        normal = static_cast<float *>(GPU_texture_read(input_normal, data_format, 0));
+        normal = GPU_texture_read(input_normal, data_format, 0);
       }
       else {
-        normal = input_normal.float_texture();
+        normal = input_normal.data();
       }
 
       if (should_denoise_auxiliary_passes()) {
         oidn::FilterRef normalFilter = device.newFilter("RT");
         this->set_filter_quality(normalFilter);
-        normalFilter.setImage(
-            "normal", normal, oidn::Format::Float3, width, height, 0, pixel_stride);
-        normalFilter.setImage(
-            "output", normal, oidn::Format::Float3, width, height, 0, pixel_stride);
+        set_filter_image(normalFilter, "normal", input_normal, normal);
+        set_filter_image(normalFilter, "output", input_normal, normal);
         normalFilter.setProgressMonitorFunction(oidn_progress_monitor_function, &context());
         normalFilter.commit();
         normalFilter.execute();
       }
 
-      filter.setImage("normal", normal, oidn::Format::Float3, width, height, 0, pixel_stride);
+      set_filter_image(filter, "normal", input_normal, normal);
     }
 
     filter.commit();
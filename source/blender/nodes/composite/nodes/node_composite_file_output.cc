@@ -16,7 +16,6 @@
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
-#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -660,15 +659,7 @@ class FileOutputOperation : public NodeOperation {
         buffer = static_cast<float *>(GPU_texture_read(result, GPU_DATA_FLOAT, 0));
       }
       else {
-        /* Copy the result into a new buffer. */
-        const int64_t buffer_size = int64_t(size.x) * size.y * result.channels_count();
-        buffer = static_cast<float *>(
-            MEM_malloc_arrayN(buffer_size, sizeof(float), "File Output Buffer Copy."));
-        threading::parallel_for(IndexRange(buffer_size), 1024, [&](const IndexRange sub_range) {
-          for (const int64_t i : sub_range) {
-            buffer[i] = result.float_texture()[i];
-          }
-        });
+        buffer = this->copy_result(result);
       }
     }
 
@@ -740,6 +731,24 @@ class FileOutputOperation : public NodeOperation {
     return nullptr;
   }
 
+  /* Allocates an image buffer and copies the pixels of the given CPU result into it, converting
+   * them to full precision if the result is stored in half precision. */
+  float *copy_result(const Result &result)
+  {
+    const int2 size = result.domain().size;
+    const int64_t channels_count = result.channels_count();
+    float *buffer = static_cast<float *>(MEM_malloc_arrayN(
+        int64_t(size.x) * size.y * channels_count, sizeof(float), "File Output Buffer Copy."));
+    parallel_for(size, [&](const int2 texel) {
+      const float4 pixel = result.load_pixel_generic_type(texel);
+      const int64_t index = (int64_t(texel.y) * size.x + texel.x) * channels_count;
+      for (const int64_t channel : IndexRange(channels_count)) {
+        buffer[index + channel] = pixel[channel];
+      }
+    });
+    return buffer;
+  }
+
   /* Read the data stored the given result and add a view of the given name and read buffer. */
   void add_view_for_result(FileOutput &file_output, const Result &result, const char *view_name)
   {
@@ -751,16 +760,7 @@ class FileOutputOperation : public NodeOperation {
       buffer = static_cast<float *>(GPU_texture_read(result, GPU_DATA_FLOAT, 0));
     }
     else {
-      /* Copy the result into a new buffer. */
-      const int2 size = result.domain().size;
-      const int64_t buffer_size = int64_t(size.x) * size.y * result.channels_count();
-      buffer = static_cast<float *>(
-          MEM_malloc_arrayN(buffer_size, sizeof(float), "File Output Buffer Copy."));
-      threading::parallel_for(IndexRange(buffer_size), 1024, [&](const IndexRange sub_range) {
-        for (const int64_t i : sub_range) {
-          buffer[i] = result.float_texture()[i];
-        }
-      });
+      buffer = this->copy_result(result);
     }
 
     const int2 size = result.domain().size;
@@ -134,6 +134,11 @@ class GlareOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
 
+  bool should_cache_outputs() override
+  {
+    return true;
+  }
+
   void execute() override
   {
     if (is_identity()) {
@@ -1720,14 +1725,20 @@ class GlareOperation : public NodeOperation {
         reinterpret_cast<fftwf_complex *>(image_frequency_domain),
         FFTW_ESTIMATE);
 
+    /* For GPU, download the highlights texture, while for CPU, load the highlights pixels from the
+     * result directly, since they might be stored in half precision. */
     float *highlights_buffer = nullptr;
     if (this->context().use_gpu()) {
       GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
       highlights_buffer = static_cast<float *>(GPU_texture_read(highlights, GPU_DATA_FLOAT, 0));
     }
-    else {
-      highlights_buffer = highlights.float_texture();
-    }
+    auto load_highlights = [&](const int2 texel) {
+      if (highlights_buffer) {
+        return float4(highlights_buffer +
+                      (int64_t(texel.y) * image_size.x + texel.x) * image_channels_count);
+      }
+      return highlights.load_pixel<float4>(texel);
+    };
 
     /* Zero pad the image to the required spatial domain size, storing each channel in planar
      * format for better cache locality, that is, RRRR...GGGG...BBBB. */
@@ -1735,16 +1746,12 @@ class GlareOperation : public NodeOperation {
       for (const int64_t y : sub_y_range) {
         for (const int64_t x : IndexRange(spatial_size.x)) {
           const bool is_inside_image = x < image_size.x && y < image_size.y;
+          const float4 highlights_color = is_inside_image ? load_highlights(int2(x, y)) :
+                                                            float4(0.0f);
           for (const int64_t channel : IndexRange(channels_count)) {
             const int64_t base_index = y * spatial_size.x + x;
             const int64_t output_index = base_index + spatial_pixels_per_channel * channel;
-            if (is_inside_image) {
-              const int64_t image_index = (y * image_size.x + x) * image_channels_count + channel;
-              image_spatial_domain[output_index] = highlights_buffer[image_index];
-            }
-            else {
-              image_spatial_domain[output_index] = 0.0f;
-            }
+            image_spatial_domain[output_index] = highlights_color[channel];
           }
         }
       }
@@ -1802,30 +1809,35 @@ class GlareOperation : public NodeOperation {
     Result fog_glow_result = context().create_result(ResultType::Color);
     fog_glow_result.allocate_texture(highlights.domain());
 
-    /* For GPU, write the output to the exist highlights_buffer then upload to the result after,
-     * while for CPU, write to the result directly. */
-    float *output = this->context().use_gpu() ? highlights_buffer :
-                                                fog_glow_result.float_texture();
-
-    /* Copy the result to the output. */
+    /* Copy the result to the output, keeping the alpha of the highlights. For GPU, write the
+     * output to the exist highlights_buffer then upload to the result after, while for CPU, write
+     * to the result directly. */
     threading::parallel_for(IndexRange(image_size.y), 1, [&](const IndexRange sub_y_range) {
       for (const int64_t y : sub_y_range) {
         for (const int64_t x : IndexRange(image_size.x)) {
+          const int2 texel = int2(x, y);
+          float4 color = float4(0.0f, 0.0f, 0.0f, load_highlights(texel).w);
           for (const int64_t channel : IndexRange(channels_count)) {
-            const int64_t output_index = (x + y * image_size.x) * image_channels_count;
             const int64_t base_index = x + y * spatial_size.x;
             const int64_t input_index = base_index + spatial_pixels_per_channel * channel;
-            output[output_index + channel] = image_spatial_domain[input_index];
-            output[output_index + 3] = highlights_buffer[output_index + 3];
+            color[channel] = image_spatial_domain[input_index];
+          }
+
+          if (highlights_buffer) {
+            const int64_t output_index = (x + y * image_size.x) * image_channels_count;
+            copy_v4_v4(highlights_buffer + output_index, color);
+          }
+          else {
+            fog_glow_result.store_pixel(texel, color);
           }
         }
       }
     });
 
     if (this->context().use_gpu()) {
-      GPU_texture_update(fog_glow_result, GPU_DATA_FLOAT, output);
+      GPU_texture_update(fog_glow_result, GPU_DATA_FLOAT, highlights_buffer);
       /* CPU writes to the output directly, so no need to free it. */
-      MEM_freeN(output);
+      MEM_freeN(highlights_buffer);
     }
 
     fftwf_destroy_plan(forward_plan);
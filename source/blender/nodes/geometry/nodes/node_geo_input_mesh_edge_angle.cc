@@ -26,33 +26,6 @@ static void node_declare(NodeDeclarationBuilder &b)
           "angles are negative. Computing this value is slower than the unsigned angle");
 }
 
-struct EdgeMapEntry {
-  int face_count;
-  int face_index_1;
-  int face_index_2;
-};
-
-static Array<EdgeMapEntry> create_edge_map(const OffsetIndices<int> faces,
-                                           const Span<int> corner_edges,
-                                           const int total_edges)
-{
-  Array<EdgeMapEntry> edge_map(total_edges, {0, 0, 0});
-
-  for (const int i_face : faces.index_range()) {
-    for (const int edge : corner_edges.slice(faces[i_face])) {
-      EdgeMapEntry &entry = edge_map[edge];
-      if (entry.face_count == 0) {
-        entry.face_index_1 = i_face;
-      }
-      else if (entry.face_count == 1) {
-        entry.face_index_2 = i_face;
-      }
-      entry.face_count++;
-    }
-  }
-  return edge_map;
-}
-
 class AngleFieldInput final : public bke::MeshFieldInput {
  public:
   AngleFieldInput() : bke::MeshFieldInput(CPPType::get<float>(), "Unsigned Angle Field")
@@ -64,22 +37,15 @@ class AngleFieldInput final : public bke::MeshFieldInput {
                                  const AttrDomain domain,
                                  const IndexMask & /*mask*/) const final
   {
-    const Span<float3> positions = mesh.vert_positions();
-    const OffsetIndices faces = mesh.faces();
-    const Span<int> corner_verts = mesh.corner_verts();
-    const Span<int> corner_edges = mesh.corner_edges();
-    Array<EdgeMapEntry> edge_map = create_edge_map(faces, corner_edges, mesh.edges_num);
+    const GroupedSpan<int> edge_to_face_map = mesh.edge_to_face_map();
+    const Span<float3> face_normals = mesh.face_normals();
 
-    auto angle_fn =
-        [edge_map = std::move(edge_map), positions, faces, corner_verts](const int i) -> float {
-      if (edge_map[i].face_count != 2) {
+    auto angle_fn = [edge_to_face_map, face_normals](const int i) -> float {
+      const Span<int> edge_faces = edge_to_face_map[i];
+      if (edge_faces.size() != 2) {
         return 0.0f;
       }
-      const IndexRange face_1 = faces[edge_map[i].face_index_1];
-      const IndexRange face_2 = faces[edge_map[i].face_index_2];
-      const float3 normal_1 = bke::mesh::face_normal_calc(positions, corner_verts.slice(face_1));
-      const float3 normal_2 = bke::mesh::face_normal_calc(positions, corner_verts.slice(face_2));
-      return angle_normalized_v3v3(normal_1, normal_2);
+      return angle_normalized_v3v3(face_normals[edge_faces[0]], face_normals[edge_faces[1]]);
     };
 
     VArray<float> angles = VArray<float>::ForFunc(mesh.edges_num, angle_fn);
@@ -118,22 +84,20 @@ class SignedAngleFieldInput final : public bke::MeshFieldInput {
     const Span<int2> edges = mesh.edges();
     const OffsetIndices faces = mesh.faces();
     const Span<int> corner_verts = mesh.corner_verts();
-    const Span<int> corner_edges = mesh.corner_edges();
-    Array<EdgeMapEntry> edge_map = create_edge_map(faces, corner_edges, mesh.edges_num);
+    const GroupedSpan<int> edge_to_face_map = mesh.edge_to_face_map();
+    const Span<float3> face_normals = mesh.face_normals();
 
-    auto angle_fn = [edge_map = std::move(edge_map), positions, edges, faces, corner_verts](
+    auto angle_fn = [edge_to_face_map, face_normals, positions, edges, faces, corner_verts](
                         const int i) -> float {
-      if (edge_map[i].face_count != 2) {
+      const Span<int> edge_faces = edge_to_face_map[i];
+      if (edge_faces.size() != 2) {
         return 0.0f;
       }
-      const IndexRange face_1 = faces[edge_map[i].face_index_1];
-      const IndexRange face_2 = faces[edge_map[i].face_index_2];
+      const IndexRange face_2 = faces[edge_faces[1]];
 
       /* Find the normals of the 2 faces. */
-      const float3 face_1_normal = bke::mesh::face_normal_calc(positions,
-                                                               corner_verts.slice(face_1));
-      const float3 face_2_normal = bke::mesh::face_normal_calc(positions,
-                                                               corner_verts.slice(face_2));
+      const float3 &face_1_normal = face_normals[edge_faces[0]];
+      const float3 &face_2_normal = face_normals[edge_faces[1]];
 
       /* Find the centerpoint of the axis edge */
       const float3 edge_centerpoint = (positions[edges[i][0]] + positions[edges[i][1]]) * 0.5f;
@@ -72,9 +72,10 @@ class VertexFaceCountFieldInput final : public bke::MeshFieldInput {
     if (domain != AttrDomain::Point) {
       return {};
     }
-    Array<int> counts(mesh.verts_num, 0);
-    array_utils::count_indices(mesh.corner_verts(), counts);
-    return VArray<int>::ForContainer(std::move(counts));
+    const OffsetIndices<int> vert_to_face_offsets = mesh.vert_to_face_map_offsets();
+    return VArray<int>::ForFunc(mesh.verts_num, [vert_to_face_offsets](const int i) {
+      return int(vert_to_face_offsets[i].size());
+    });
   }
 
   uint64_t hash() const override
@@ -0,0 +1,323 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/**
+ * Benchmarks for geometry nodes evaluation. Every test builds a small node tree that is
+ * representative for a common use case and evaluates it for different input sizes. For every
+ * evaluation, the total time, the time spent in each node and the peak memory usage are printed.
+ *
+ * Unlike the benchmarks in `tests/performance/tests/geometry_nodes.py` this does not require any
+ * `.blend` files, so that the evaluated trees are easy to extend and to profile.
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include "testing/testing.h"
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_compute_contexts.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_main.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_node_tree_update.hh"
+
+#include "BLI_math_vector.h"
+#include "BLI_timeit.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_node_types.h"
+
+#include "NOD_geo_repeat.hh"
+#include "NOD_geometry_nodes_execute.hh"
+#include "NOD_geometry_nodes_lazy_function.hh"
+#include "NOD_geometry_nodes_log.hh"
+
+namespace blender::nodes::tests {
+
+namespace geo_log = geo_eval_log;
+
+/**
+ * Small utility to build geometry node trees with as little boilerplate as possible.
+ */
+class TreeBuilder {
+ private:
+  Main &bmain_;
+  bNodeTree *tree_;
+  bNode *group_output_;
+  std::string output_identifier_;
+
+ public:
+  TreeBuilder(Main &bmain) : bmain_(bmain)
+  {
+    tree_ = bke::node_tree_add_tree(&bmain_, "Benchmark", "GeometryNodeTree");
+    bNodeTreeInterfaceSocket *output_socket = tree_->tree_interface.add_socket(
+        "Geometry", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_OUTPUT, nullptr);
+    output_identifier_ = output_socket->identifier;
+    group_output_ = this->add(NODE_GROUP_OUTPUT);
+    this->update();
+  }
+
+  bNode *add(const int type)
+  {
+    return bke::node_add_static_node(nullptr, tree_, type);
+  }
+
+  void link(bNode *from_node, const StringRef from_id, bNode *to_node, const StringRef to_id)
+  {
+    bNodeSocket *from_socket = bke::node_find_socket(from_node, SOCK_OUT, from_id);
+    bNodeSocket *to_socket = bke::node_find_socket(to_node, SOCK_IN, to_id);
+    BLI_assert(from_socket != nullptr && to_socket != nullptr);
+    bke::node_add_link(tree_, from_node, from_socket, to_node, to_socket);
+  }
+
+  void set_int(bNode *node, const StringRef id, const int value)
+  {
+    bNodeSocket *socket = bke::node_find_socket(node, SOCK_IN, id);
+    socket->default_value_typed<bNodeSocketValueInt>()->value = value;
+  }
+
+  void set_float(bNode *node, const StringRef id, const float value)
+  {
+    bNodeSocket *socket = bke::node_find_socket(node, SOCK_IN, id);
+    socket->default_value_typed<bNodeSocketValueFloat>()->value = value;
+  }
+
+  void set_vector(bNode *node, const StringRef id, const float3 &value)
+  {
+    bNodeSocket *socket = bke::node_find_socket(node, SOCK_IN, id);
+    copy_v3_v3(socket->default_value_typed<bNodeSocketValueVector>()->value, value);
+  }
+
+  void tag_node_property(bNode *node)
+  {
+    BKE_ntree_update_tag_node_property(tree_, node);
+  }
+
+  /** Rebuild the sockets of nodes whose declaration depends on other data. */
+  void update()
+  {
+    BKE_ntree_update_main_tree(&bmain_, tree_, nullptr);
+  }
+
+  /** Connect the geometry output of the given node to the group output and finalize the tree. */
+  const bNodeTree &finish(bNode *node, const StringRef output_id)
+  {
+    this->link(node, output_id, group_output_, output_identifier_);
+    this->update();
+    return *tree_;
+  }
+};
+
+class GeometryNodesPerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain_ = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain_ = BKE_main_new();
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+};
+
+/**
+ * Evaluate the tree and print the total time, the time spent in every node (including nodes in
+ * repeat zones) and the peak memory allocated during the evaluation.
+ */
+static bke::GeometrySet evaluate_and_report(const bNodeTree &tree, const StringRef label)
+{
+  geo_log::GeoModifierLog eval_log;
+  GeoNodesCallData call_data;
+  call_data.eval_log = &eval_log;
+  /* Only log execution times, logging socket values would distort the measurements. */
+  const Set<ComputeContextHash> socket_log_contexts;
+  call_data.socket_log_contexts = &socket_log_contexts;
+
+  const bke::ModifierComputeContext compute_context{nullptr, "Benchmark"};
+
+  const size_t memory_before = MEM_get_memory_in_use();
+  MEM_reset_peak_memory();
+  const timeit::TimePoint start = timeit::Clock::now();
+  bke::GeometrySet result = execute_geometry_nodes_on_geometry(
+      tree, nullptr, compute_context, call_data, {});
+  const timeit::Nanoseconds duration = timeit::Clock::now() - start;
+  const size_t peak_memory = std::max(MEM_get_peak_memory(), memory_before) - memory_before;
+
+  /* Gather the time spent in each node. Nodes in repeat zones are logged in separate compute
+   * contexts for every iteration. */
+  Map<int32_t, timeit::Nanoseconds> time_by_node;
+  auto gather_times = [&](const ComputeContext &context) {
+    geo_log::GeoTreeLog &tree_log = eval_log.get_tree_log(context.hash());
+    tree_log.ensure_execution_times();
+    for (const auto item : tree_log.nodes.items()) {
+      time_by_node.lookup_or_add_default(item.key) += item.value.execution_time;
+    }
+    return !tree_log.nodes.is_empty();
+  };
+  gather_times(compute_context);
+  for (const bNode *node : tree.nodes_by_type("GeometryNodeRepeatOutput")) {
+    for (int iteration = 0;; iteration++) {
+      const bke::RepeatZoneComputeContext zone_context{&compute_context, *node, iteration};
+      if (!gather_times(zone_context)) {
+        break;
+      }
+    }
+  }
+
+  std::cout << label << ": ";
+  timeit::print_duration(duration);
+  std::cout << ", peak memory: " << peak_memory / 1024 << " KiB\n";
+  for (const bNode *node : tree.all_nodes()) {
+    if (const timeit::Nanoseconds *time = time_by_node.lookup_ptr(node->identifier)) {
+      std::cout << "  " << std::left << std::setw(32) << node->name;
+      timeit::print_duration(*time);
+      std::cout << "\n";
+    }
+  }
+  return result;
+}
+
+/** Scatter points on a grid, instance an ico sphere on every point and realize the instances. */
+TEST_F(GeometryNodesPerformanceTest, ScatterAndInstance)
+{
+  for (const float density : {100.0f, 1'000.0f, 10'000.0f}) {
+    TreeBuilder builder{*bmain_};
+    bNode *grid = builder.add(GEO_NODE_MESH_PRIMITIVE_GRID);
+    builder.set_float(grid, "Size X", 10.0f);
+    builder.set_float(grid, "Size Y", 10.0f);
+    bNode *distribute = builder.add(GEO_NODE_DISTRIBUTE_POINTS_ON_FACES);
+    builder.set_float(distribute, "Density", density);
+    bNode *ico_sphere = builder.add(GEO_NODE_MESH_PRIMITIVE_ICO_SPHERE);
+    builder.set_int(ico_sphere, "Subdivisions", 2);
+    bNode *instance = builder.add(GEO_NODE_INSTANCE_ON_POINTS);
+    bNode *realize = builder.add(GEO_NODE_REALIZE_INSTANCES);
+    builder.link(grid, "Mesh", distribute, "Mesh");
+    builder.link(distribute, "Points", instance, "Points");
+    builder.link(ico_sphere, "Mesh", instance, "Instance");
+    builder.link(instance, "Instances", realize, "Geometry");
+    const bNodeTree &tree = builder.finish(realize, "Geometry");
+
+    const bke::GeometrySet result = evaluate_and_report(
+        tree, "Density " + std::to_string(int(density)));
+    EXPECT_TRUE(result.has_mesh());
+  }
+}
+
+/** Resample a curve line and sweep a circle profile along it. */
+TEST_F(GeometryNodesPerformanceTest, CurveResample)
+{
+  for (const int count : {1'000, 10'000, 100'000}) {
+    TreeBuilder builder{*bmain_};
+    bNode *line = builder.add(GEO_NODE_CURVE_PRIMITIVE_LINE);
+    bNode *resample = builder.add(GEO_NODE_RESAMPLE_CURVE);
+    builder.set_int(resample, "Count", count);
+    bNode *circle = builder.add(GEO_NODE_CURVE_PRIMITIVE_CIRCLE);
+    builder.set_int(circle, "Resolution", 32);
+    bNode *curve_to_mesh = builder.add(GEO_NODE_CURVE_TO_MESH);
+    builder.link(line, "Curve", resample, "Curve");
+    builder.link(resample, "Curve", curve_to_mesh, "Curve");
+    builder.link(circle, "Curve", curve_to_mesh, "Profile Curve");
+    const bNodeTree &tree = builder.finish(curve_to_mesh, "Mesh");
+
+    const bke::GeometrySet result = evaluate_and_report(tree,
+                                                        "Count " + std::to_string(count));
+    EXPECT_EQ(result.get_mesh()->verts_num, count * 32);
+  }
+}
+
+/** Subtract a cube from a sphere with increasing resolution. */
+TEST_F(GeometryNodesPerformanceTest, MeshBoolean)
+{
+  for (const int segments : {32, 128, 512}) {
+    TreeBuilder builder{*bmain_};
+    bNode *sphere = builder.add(GEO_NODE_MESH_PRIMITIVE_UV_SPHERE);
+    builder.set_int(sphere, "Segments", segments);
+    builder.set_int(sphere, "Rings", segments / 2);
+    bNode *cube = builder.add(GEO_NODE_MESH_PRIMITIVE_CUBE);
+    builder.set_vector(cube, "Size", float3(1.5f));
+    bNode *boolean = builder.add(GEO_NODE_MESH_BOOLEAN);
+    builder.link(sphere, "Mesh", boolean, "Mesh 1");
+    builder.link(cube, "Mesh", boolean, "Mesh 2");
+    const bNodeTree &tree = builder.finish(boolean, "Mesh");
+
+    const bke::GeometrySet result = evaluate_and_report(
+        tree, "Segments " + std::to_string(segments));
+    EXPECT_TRUE(result.has_mesh());
+  }
+}
+
+/** Offset the positions of a grid with a long chain of vector math field nodes. */
+TEST_F(GeometryNodesPerformanceTest, FieldMath)
+{
+  for (const int resolution : {100, 1'000, 2'000}) {
+    TreeBuilder builder{*bmain_};
+    bNode *grid = builder.add(GEO_NODE_MESH_PRIMITIVE_GRID);
+    builder.set_int(grid, "Vertices X", resolution);
+    builder.set_int(grid, "Vertices Y", resolution);
+    bNode *position = builder.add(GEO_NODE_INPUT_POSITION);
+    bNode *previous = position;
+    StringRef previous_output = "Position";
+    for (const int i : IndexRange(32)) {
+      bNode *math = builder.add(SH_NODE_VECTOR_MATH);
+      math->custom1 = (i % 2 == 0) ? NODE_VECTOR_MATH_SINE : NODE_VECTOR_MATH_ADD;
+      builder.link(previous, previous_output, math, "Vector");
+      builder.link(position, "Position", math, "Vector_001");
+      previous = math;
+      previous_output = "Vector";
+    }
+    bNode *set_position = builder.add(GEO_NODE_SET_POSITION);
+    builder.link(grid, "Mesh", set_position, "Geometry");
+    builder.link(previous, "Vector", set_position, "Offset");
+    const bNodeTree &tree = builder.finish(set_position, "Geometry");
+
+    const bke::GeometrySet result = evaluate_and_report(
+        tree, "Resolution " + std::to_string(resolution));
+    EXPECT_EQ(result.get_mesh()->verts_num, resolution * resolution);
+  }
+}
+
+/** Move the points of a grid in a repeat zone with an increasing number of iterations. */
+TEST_F(GeometryNodesPerformanceTest, RepeatZone)
+{
+  for (const int iterations : {10, 100, 1'000}) {
+    TreeBuilder builder{*bmain_};
+    bNode *grid = builder.add(GEO_NODE_MESH_PRIMITIVE_GRID);
+    builder.set_int(grid, "Vertices X", 100);
+    builder.set_int(grid, "Vertices Y", 100);
+    bNode *repeat_input = builder.add(GEO_NODE_REPEAT_INPUT);
+    bNode *repeat_output = builder.add(GEO_NODE_REPEAT_OUTPUT);
+    static_cast<NodeGeometryRepeatInput *>(repeat_input->storage)->output_node_id =
+        repeat_output->identifier;
+    builder.tag_node_property(repeat_input);
+    builder.update();
+
+    const auto &output_storage = *static_cast<const NodeGeometryRepeatOutput *>(
+        repeat_output->storage);
+    const std::string item_id = RepeatItemsAccessor::socket_identifier_for_item(
+        output_storage.items[0]);
+    builder.set_int(repeat_input, "Iterations", iterations);
+    bNode *set_position = builder.add(GEO_NODE_SET_POSITION);
+    builder.set_vector(set_position, "Offset", float3(0.0f, 0.0f, 0.01f));
+    builder.link(grid, "Mesh", repeat_input, item_id);
+    builder.link(repeat_input, item_id, set_position, "Geometry");
+    builder.link(set_position, "Geometry", repeat_output, item_id);
+    const bNodeTree &tree = builder.finish(repeat_output, item_id);
+
+    const bke::GeometrySet result = evaluate_and_report(
+        tree, "Iterations " + std::to_string(iterations));
+    EXPECT_EQ(result.get_mesh()->verts_num, 100 * 100);
+  }
+}
+
+}  // namespace blender::nodes::tests
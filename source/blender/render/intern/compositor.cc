@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <cstring>
+#include <mutex>
 #include <string>
 
 #include "BLI_math_vector_types.hh"
@@ -166,6 +167,10 @@ class Context : public compositor::Context {
   Vector<GPUTexture *> cached_gpu_passes_;
   Vector<ImBuf *> cached_cpu_passes_;
 
+  /* Protects the members above as well as the draw data of IDs, since operations might be
+   * evaluated concurrently on the CPU and access the context from multiple threads. */
+  mutable std::mutex mutex_;
+
  public:
   Context(const ContextInputData &input_data, TexturePool &texture_pool)
       : compositor::Context(texture_pool),
@@ -228,6 +233,18 @@ class Context : public compositor::Context {
     return this->render_context() == nullptr;
   }
 
+  bool should_read_ahead() const override
+  {
+    /* Only read ahead when rendering animations, where the next frame is known to be evaluated
+     * next, unless the current frame is the last one. */
+    if (!this->render_context()) {
+      return false;
+    }
+    const Render *render = RE_GetSceneRender(input_data_.scene);
+    return render && (render->flag & R_ANIMATION) &&
+           this->get_next_frame_number() <= this->get_render_data().efra;
+  }
+
   bool use_composite_output() const override
   {
     return true;
@@ -255,6 +272,7 @@ class Context : public compositor::Context {
 
   compositor::Result get_output_result() override
   {
+    std::scoped_lock lock(mutex_);
     const int2 render_size = get_render_size();
     if (output_result_.is_allocated()) {
       /* If the allocated result have the same size as the render size, return it as is. */
@@ -277,6 +295,7 @@ class Context : public compositor::Context {
                                               const bool is_data,
                                               compositor::ResultPrecision precision) override
   {
+    std::scoped_lock lock(mutex_);
     viewer_output_result_.set_transformation(domain.transformation);
     viewer_output_result_.meta_data.is_non_color_data = is_data;
 
@@ -353,6 +372,7 @@ class Context : public compositor::Context {
       /* Don't assume render will keep pass data stored, add our own reference. */
       GPU_texture_ref(pass_texture);
       pass.wrap_external(pass_texture);
+      std::scoped_lock lock(mutex_);
       cached_gpu_passes_.append(pass_texture);
     }
     else {
@@ -360,6 +380,7 @@ class Context : public compositor::Context {
       IMB_refImBuf(render_pass->ibuf);
       pass.wrap_external(render_pass->ibuf->float_buffer.data,
                          int2(render_pass->ibuf->x, render_pass->ibuf->y));
+      std::scoped_lock lock(mutex_);
       cached_cpu_passes_.append(render_pass->ibuf);
     }
 
@@ -385,6 +406,8 @@ class Context : public compositor::Context {
         }
       case SCE_COMPOSITOR_PRECISION_FULL:
         return compositor::ResultPrecision::Full;
+      case SCE_COMPOSITOR_PRECISION_HALF:
+        return compositor::ResultPrecision::Half;
     }
 
     BLI_assert_unreachable();
@@ -402,6 +425,7 @@ class Context : public compositor::Context {
 
   IDRecalcFlag query_id_recalc_flag(ID *id) const override
   {
+    std::scoped_lock lock(mutex_);
     DrawEngineType *owner = (DrawEngineType *)this;
     DrawData *draw_data = DRW_drawdata_ensure(id, owner, sizeof(DrawData), nullptr, nullptr);
     IDRecalcFlag recalc_flag = IDRecalcFlag(draw_data->recalc);
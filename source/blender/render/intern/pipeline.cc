@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <forward_list>
+#include <optional>
 
 #include "DNA_anim_types.h"
 #include "DNA_collection_types.h"
@@ -67,6 +68,7 @@
 #include "NOD_composite.hh"
 
 #include "COM_compositor.hh"
+#include "COM_profiler.hh"
 #include "COM_render_context.hh"
 
 #include "DEG_depsgraph.hh"
@@ -1371,6 +1373,12 @@ static void do_render_compositor(Render *re)
           /* If we have consistent depsgraph now would be a time to update them. */
         }
 
+        /* Only profile the evaluation if a trace was requested, since profiling has a cost. */
+        std::optional<blender::compositor::Profiler> profiler;
+        if (COM_is_trace_requested()) {
+          profiler.emplace();
+        }
+
         blender::compositor::RenderContext compositor_render_context;
         LISTBASE_FOREACH (RenderView *, rv, &re->result->views) {
           COM_execute(re,
@@ -1379,9 +1387,13 @@ static void do_render_compositor(Render *re)
                       ntree,
                       rv->name,
                       &compositor_render_context,
-                      nullptr);
+                      profiler ? &*profiler : nullptr);
+        }
+        if (profiler) {
+          COM_write_trace(*profiler, re->r.cfra);
         }
-        compositor_render_context.save_file_outputs(re->pipeline_scene_eval);
+        compositor_render_context.save_file_outputs(re->pipeline_scene_eval,
+                                                    re->compositor_file_output_writer);
 
         ntree->runtime->stats_draw = nullptr;
         ntree->runtime->test_break = nullptr;
@@ -2409,6 +2421,9 @@ void RE_RenderAnim(Render *re,
   re->flag |= R_ANIMATION;
   DEG_graph_id_tag_update(re->main, re->pipeline_depsgraph, &re->scene->id, ID_RECALC_AUDIO_MUTE);
 
+  /* Write the File Output nodes of the compositor while the next frames are rendered. */
+  re->compositor_file_output_writer = MEM_new<blender::compositor::FileOutputWriter>(__func__);
+
   scene->r.subframe = 0.0f;
   for (nfra = sfra, scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
     char filepath[FILE_MAX];
@@ -2589,6 +2604,10 @@ void RE_RenderAnim(Render *re,
     re_movie_free_all(re);
   }
 
+  /* Wait for the remaining File Output nodes to be written. */
+  MEM_delete(re->compositor_file_output_writer);
+  re->compositor_file_output_writer = nullptr;
+
   if (totskipped && totrendered == 0) {
     BKE_report(re->reports, RPT_INFO, "No frames rendered, skipped to not overwrite");
   }
@@ -26,6 +26,7 @@
 namespace blender::compositor {
 class RenderContext;
 class Profiler;
+class FileOutputWriter;
 }  // namespace blender::compositor
 
 struct bNodeTree;
@@ -246,6 +247,8 @@ struct Render : public BaseRender {
   struct ReportList *reports = nullptr;
 
   blender::Vector<MovieWriter *> movie_writers;
+  /* Writes the File Output nodes of the compositor asynchronously while rendering animations. */
+  blender::compositor::FileOutputWriter *compositor_file_output_writer = nullptr;
   char viewname[MAX_NAME] = "";
 
   /* TODO: replace by a whole draw manager. */
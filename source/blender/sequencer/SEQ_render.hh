@@ -18,7 +18,11 @@ struct Scene;
 struct Strip;
 struct StripElem;
 
-enum eSeqTaskId {
+/**
+ * Prefetch workers each use their own ID, counting up from #SEQ_TASK_PREFETCH_RENDER, so that
+ * the temporary cache entries of a worker are not freed when another worker finishes a frame.
+ */
+enum eSeqTaskId : int {
   SEQ_TASK_MAIN_RENDER,
   SEQ_TASK_PREFETCH_RENDER,
 };
@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup sequencer
+ *
+ * Recording of the time spent rendering each strip, per frame. Recording is enabled per scene,
+ * so the timings of long edits can be inspected in the timeline or exported for analysis.
+ */
+
+#include "BLI_function_ref.hh"
+
+struct Scene;
+struct Strip;
+
+namespace blender::seq {
+
+/** Steps of rendering a strip that are timed separately. */
+enum class RenderTimingStage : int8_t {
+  /**
+   * Creating the strip image: decoding images and movies, rendering scenes and masks or
+   * executing effects. Time spent rendering the inputs of effects and the content of meta strips
+   * is recorded for those strips instead.
+   */
+  Render = 0,
+  /** Transform, crop, saturation and multiply, but not the modifiers. */
+  Preprocess,
+  /** Applying the modifier stack. */
+  Modifiers,
+  /** Blending the strip over the strips in the channels below it. */
+  Blend,
+};
+static constexpr int RENDER_TIMING_STAGES_NUM = int(RenderTimingStage::Blend) + 1;
+
+/** Timings of one strip at one frame, from the last time it was not taken from the cache. */
+struct StripFrameTiming {
+  float stage_ms[RENDER_TIMING_STAGES_NUM] = {};
+  /** Number of times the strip image was found in the cache instead of being rendered. */
+  int cache_hits = 0;
+
+  float total_ms() const
+  {
+    float total = 0.0f;
+    for (const float ms : stage_ms) {
+      total += ms;
+    }
+    return total;
+  }
+};
+
+/**
+ * Add a user of the render timings of the scene, like an editor that displays them. Recording
+ * starts with the first user. Frames that are already cached are only recorded as cache hits.
+ * \return false if the scene has no sequencer data, the user is not added then.
+ */
+bool render_timings_add_user(Scene *scene);
+
+/**
+ * Remove a user added with #render_timings_add_user. Recording stops and the recorded timings
+ * are freed when the last user is removed.
+ */
+void render_timings_remove_user(Scene *scene);
+
+/**
+ * Stop recording and free all recorded timings, regardless of their users.
+ */
+void render_timings_free(Scene *scene);
+
+bool render_timings_is_recording(const Scene *scene);
+
+/**
+ * Call `fn` for every recorded frame of the strip, in no particular order. Strips are
+ * identified by name, so the timings of a renamed strip are not found anymore.
+ */
+void render_timings_foreach_frame(
+    const Scene *scene,
+    const Strip *seq,
+    FunctionRef<void(int timeline_frame, const StripFrameTiming &)> fn);
+
+/**
+ * Write all recorded timings to a JSON file.
+ * \return false if the file could not be written.
+ */
+bool render_timings_write_json(const Scene *scene, const char *filepath);
+
+}  // namespace blender::seq
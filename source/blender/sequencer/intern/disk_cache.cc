@@ -9,9 +9,12 @@
 #include <cstddef>
 #include <ctime>
 #include <memory.h>
+#include <string>
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 
@@ -24,9 +27,14 @@
 #include "BLI_endian_switch.h"
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
+#include "BLI_hash.hh"
 #include "BLI_listbase.h"
 #include "BLI_path_utils.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_main.hh"
 
@@ -44,8 +52,18 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
+ * ZSTD compression with user definable level can be used to compress image data(per image).
+ * Before compression, pixels are split into byte planes (all first bytes of each channel or
+ * float, then all second bytes and so on), which groups similar bytes together and lets even
+ * the fastest compression levels reach a good ratio.
+ * Writing happens asynchronously in a background task pool, so rendering does not wait for
+ * compression and file I/O. Writes may run in parallel and finish in any order, so images are
+ * not necessarily written in the order in which they are rendered. Every pending write keeps
+ * its image alive, so when too many writes are pending, the image is written on the calling
+ * thread instead. Invalidation cancels the pending writes to the files it deletes.
+ * Access to file contents is guarded by a set of mutexes picked by file path hash, so reads
+ * and writes of different files can run in parallel. The list of files and total size are
+ * guarded by a separate mutex, which is always locked after the file mutex.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
@@ -57,11 +75,20 @@
  * `<cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf`. */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_CURRENT_VERSION 3
+#define DCACHE_FILE_LOCKS_NUM 16
+#define DCACHE_MAX_SCHEDULED_WRITES 4
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
 
+/** #DiskCacheHeaderEntry.flag */
+enum {
+  /** Image data is stored as byte planes, see #seq_disk_cache_byte_planes_split. */
+  DCACHE_ENTRY_BYTE_PLANES = (1 << 0),
+};
+
 struct DiskCacheHeaderEntry {
   uchar encoding;
+  uchar flag;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -76,9 +103,31 @@ struct DiskCacheHeader {
 struct SeqDiskCache {
   Main *bmain;
   int64_t timestamp;
+  /** Guarded by #files_mutex. */
   ListBase files;
-  ThreadMutex read_write_mutex;
   size_t size_total;
+  ThreadMutex files_mutex;
+  /** Guard file contents, see #seq_disk_cache_file_lock. */
+  ThreadMutex file_locks[DCACHE_FILE_LOCKS_NUM];
+  /** Background pool for asynchronous writes. */
+  TaskPool *write_pool;
+  /** Writes in #write_pool that have not been freed yet, guarded by #files_mutex. */
+  ListBase pending_writes;
+  /** Number of writes in #write_pool that have not been freed yet, modified atomically. */
+  int32_t scheduled_writes_num;
+};
+
+struct DiskCacheWriteTask {
+  DiskCacheWriteTask *next, *prev;
+  char filepath[FILE_MAX];
+  /** Parts of the file path that invalidation matches, see #DiskCacheFile. */
+  char dir[FILE_MAXDIR];
+  int cache_type;
+  int start_frame;
+  uint64_t frame_index;
+  ImBuf *ibuf;
+  /** Set by invalidation when the file is deleted, guarded by #SeqDiskCache.files_mutex. */
+  bool is_canceled;
 };
 
 struct DiskCacheFile {
@@ -128,6 +177,12 @@ bool seq_disk_cache_is_enabled(Main *bmain)
           bmain->filepath[0] != '\0');
 }
 
+static ThreadMutex *seq_disk_cache_file_lock(SeqDiskCache *disk_cache, const char *filepath)
+{
+  const uint64_t hash = blender::get_default_hash(blender::StringRef(filepath));
+  return &disk_cache->file_locks[hash % DCACHE_FILE_LOCKS_NUM];
+}
+
 static DiskCacheFile *seq_disk_cache_add_file_to_list(SeqDiskCache *disk_cache,
                                                       const char *filepath)
 {
@@ -216,44 +271,73 @@ static void seq_disk_cache_delete_file(SeqDiskCache *disk_cache, DiskCacheFile *
   MEM_freeN(file);
 }
 
-bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
+static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache,
+                                                            const char *filepath)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
-  while (disk_cache->size_total > seq_disk_cache_size_limit()) {
-    DiskCacheFile *oldest_file = seq_disk_cache_get_oldest_file(disk_cache);
+  DiskCacheFile *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
 
-    if (!oldest_file) {
-      /* We shouldn't enforce limits with no files, do re-scan. */
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
+  for (; cache_file; cache_file = cache_file->next) {
+    if (BLI_strcasecmp(cache_file->filepath, filepath) == 0) {
+      return cache_file;
     }
+  }
 
-    if (BLI_exists(oldest_file->filepath) == 0) {
-      /* File may have been manually deleted during runtime, do re-scan. */
-      BLI_freelistN(&disk_cache->files);
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
-    }
+  return nullptr;
+}
 
-    seq_disk_cache_delete_file(disk_cache, oldest_file);
+/* Delete file while holding its lock, so it is not removed while being read or written. */
+static void seq_disk_cache_delete_file_by_path(SeqDiskCache *disk_cache, const char *filepath)
+{
+  ThreadMutex *file_lock = seq_disk_cache_file_lock(disk_cache, filepath);
+  BLI_mutex_lock(file_lock);
+  BLI_mutex_lock(&disk_cache->files_mutex);
+  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
+  if (cache_file != nullptr) {
+    seq_disk_cache_delete_file(disk_cache, cache_file);
   }
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-
-  return true;
+  BLI_mutex_unlock(&disk_cache->files_mutex);
+  BLI_mutex_unlock(file_lock);
 }
 
-static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache,
-                                                            const char *filepath)
+bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
 {
-  DiskCacheFile *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
+  char filepath[FILE_MAX];
 
-  for (; cache_file; cache_file = cache_file->next) {
-    if (BLI_strcasecmp(cache_file->filepath, filepath) == 0) {
-      return cache_file;
+  while (true) {
+    DiskCacheFile *oldest_file = nullptr;
+
+    BLI_mutex_lock(&disk_cache->files_mutex);
+    while (disk_cache->size_total > seq_disk_cache_size_limit()) {
+      oldest_file = seq_disk_cache_get_oldest_file(disk_cache);
+
+      if (!oldest_file) {
+        /* We shouldn't enforce limits with no files, do re-scan. */
+        seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+        continue;
+      }
+
+      if (BLI_exists(oldest_file->filepath) == 0) {
+        /* File may have been manually deleted during runtime, do re-scan. */
+        oldest_file = nullptr;
+        BLI_freelistN(&disk_cache->files);
+        seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+        continue;
+      }
+
+      STRNCPY(filepath, oldest_file->filepath);
+      break;
+    }
+    BLI_mutex_unlock(&disk_cache->files_mutex);
+
+    if (oldest_file == nullptr) {
+      break;
     }
+
+    /* File lock must be taken before the list lock, the entry is looked up again. */
+    seq_disk_cache_delete_file_by_path(disk_cache, filepath);
   }
 
-  return nullptr;
+  return true;
 }
 
 /* Update file size and timestamp. */
@@ -264,6 +348,10 @@ static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, const char *fil
   int64_t size_after;
 
   cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
+  if (cache_file == nullptr) {
+    /* Removed from the list by a re-scan. */
+    return;
+  }
   size_before = cache_file->fstat.st_size;
 
   if (BLI_stat(filepath, &cache_file->fstat) == -1) {
@@ -367,12 +455,34 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
   }
 }
 
-static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
-                                                Scene *scene,
-                                                Strip *seq,
-                                                int invalidate_types,
-                                                int range_start,
-                                                int range_end)
+static bool seq_disk_cache_file_is_invalid(Strip *seq,
+                                           const char *cache_dir,
+                                           int invalidate_types,
+                                           int range_start,
+                                           int range_end,
+                                           const char *file_dir,
+                                           int file_cache_type,
+                                           int file_start_frame)
+{
+  if ((file_cache_type & invalidate_types) == 0 || !STREQ(cache_dir, file_dir)) {
+    return false;
+  }
+  int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(seq, file_start_frame);
+  return timeline_frame_start > range_start && timeline_frame_start <= range_end;
+}
+
+/**
+ * Collect the files to delete and cancel the pending writes to them, so they are not created
+ * again. Writes to other files, like those of other strips, are kept.
+ * The list mutex is expected to be locked.
+ */
+static void seq_disk_cache_get_invalid_files(SeqDiskCache *disk_cache,
+                                             Scene *scene,
+                                             Strip *seq,
+                                             int invalidate_types,
+                                             int range_start,
+                                             int range_end,
+                                             blender::Vector<std::string> &r_filepaths)
 {
   DiskCacheFile *next_file, *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
   char cache_dir[FILE_MAX];
@@ -381,17 +491,36 @@ static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
 
   while (cache_file) {
     next_file = cache_file->next;
-    if (cache_file->cache_type & invalidate_types) {
-      if (STREQ(cache_dir, cache_file->dir)) {
-        int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(
-            seq, cache_file->start_frame);
-        if (timeline_frame_start > range_start && timeline_frame_start <= range_end) {
-          seq_disk_cache_delete_file(disk_cache, cache_file);
-        }
-      }
+    if (seq_disk_cache_file_is_invalid(seq,
+                                       cache_dir,
+                                       invalidate_types,
+                                       range_start,
+                                       range_end,
+                                       cache_file->dir,
+                                       cache_file->cache_type,
+                                       cache_file->start_frame))
+    {
+      r_filepaths.append(cache_file->filepath);
     }
     cache_file = next_file;
   }
+
+  /* A write that already runs may create its file after the list above was collected, so its
+   * file is deleted as well, which waits for the write to finish. */
+  LISTBASE_FOREACH (DiskCacheWriteTask *, write_task, &disk_cache->pending_writes) {
+    if (seq_disk_cache_file_is_invalid(seq,
+                                       cache_dir,
+                                       invalidate_types,
+                                       range_start,
+                                       range_end,
+                                       write_task->dir,
+                                       write_task->cache_type,
+                                       write_task->start_frame))
+    {
+      write_task->is_canceled = true;
+      r_filepaths.append(write_task->filepath);
+    }
+  }
 }
 
 void seq_disk_cache_invalidate(
@@ -399,15 +528,61 @@ void seq_disk_cache_invalidate(
 {
   int start;
   int end;
+  blender::Vector<std::string> filepaths;
 
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  BLI_mutex_lock(&disk_cache->files_mutex);
 
   start = SEQ_time_left_handle_frame_get(scene, seq_changed) - DCACHE_IMAGES_PER_FILE;
   end = SEQ_time_right_handle_frame_get(scene, seq_changed);
 
-  seq_disk_cache_delete_invalid_files(disk_cache, scene, seq, invalidate_types, start, end);
+  seq_disk_cache_get_invalid_files(
+      disk_cache, scene, seq, invalidate_types, start, end, filepaths);
+
+  BLI_mutex_unlock(&disk_cache->files_mutex);
+
+  for (const std::string &filepath : filepaths) {
+    seq_disk_cache_delete_file_by_path(disk_cache, filepath.c_str());
+  }
+}
+
+/**
+ * Store each byte of a pixel in a separate plane: all first bytes, then all second bytes and so
+ * on. For byte images this splits channels, for float images also bytes of each float, so that
+ * exponents and high mantissa bytes of neighboring pixels end up next to each other. This
+ * compresses much better, even with the fastest compression levels.
+ */
+static void seq_disk_cache_byte_planes_split(const uchar *src,
+                                             uchar *dst,
+                                             const size_t size,
+                                             const size_t pixel_size)
+{
+  const int64_t pixels_num = size / pixel_size;
+  blender::threading::parallel_for(
+      blender::IndexRange(pixels_num), 64 * 1024, [&](const blender::IndexRange range) {
+        for (const size_t plane : blender::IndexRange(pixel_size)) {
+          uchar *dst_plane = dst + plane * pixels_num;
+          for (const int64_t i : range) {
+            dst_plane[i] = src[i * pixel_size + plane];
+          }
+        }
+      });
+}
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+static void seq_disk_cache_byte_planes_merge(const uchar *src,
+                                             uchar *dst,
+                                             const size_t size,
+                                             const size_t pixel_size)
+{
+  const int64_t pixels_num = size / pixel_size;
+  blender::threading::parallel_for(
+      blender::IndexRange(pixels_num), 64 * 1024, [&](const blender::IndexRange range) {
+        for (const size_t plane : blender::IndexRange(pixel_size)) {
+          const uchar *src_plane = src + plane * pixels_num;
+          for (const int64_t i : range) {
+            dst[i * pixel_size + plane] = src_plane[i];
+          }
+        }
+      });
 }
 
 static size_t deflate_imbuf_to_file(ImBuf *ibuf,
@@ -420,8 +595,16 @@ static size_t deflate_imbuf_to_file(ImBuf *ibuf,
 
   /* Apply compression if wanted, otherwise just write directly to the file. */
   if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
+    const size_t pixel_size = header_entry->size_raw / (size_t(ibuf->x) * ibuf->y);
+    uchar *planes = static_cast<uchar *>(MEM_mallocN(header_entry->size_raw, __func__));
+    seq_disk_cache_byte_planes_split(
+        static_cast<const uchar *>(data), planes, header_entry->size_raw, pixel_size);
+    header_entry->flag |= DCACHE_ENTRY_BYTE_PLANES;
+
+    const size_t bytes_written = BLI_file_zstd_from_mem_at_pos(
+        planes, header_entry->size_raw, file, header_entry->offset, level);
+    MEM_freeN(planes);
+    return bytes_written;
   }
 
   fseek(file, header_entry->offset, SEEK_SET);
@@ -440,7 +623,21 @@ static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntr
 
   /* Check if the data is compressed or raw. */
   if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+    if ((header_entry->flag & DCACHE_ENTRY_BYTE_PLANES) == 0) {
+      return BLI_file_unzstd_to_mem_at_pos(
+          data, header_entry->size_raw, file, header_entry->offset);
+    }
+
+    const size_t pixel_size = header_entry->size_raw / (size_t(ibuf->x) * ibuf->y);
+    uchar *planes = static_cast<uchar *>(MEM_mallocN(header_entry->size_raw, __func__));
+    const size_t bytes_read = BLI_file_unzstd_to_mem_at_pos(
+        planes, header_entry->size_raw, file, header_entry->offset);
+    if (bytes_read == header_entry->size_raw) {
+      seq_disk_cache_byte_planes_merge(
+          planes, static_cast<uchar *>(data), header_entry->size_raw, pixel_size);
+    }
+    MEM_freeN(planes);
+    return bytes_read;
   }
 
   fseek(file, header_entry->offset, SEEK_SET);
@@ -475,7 +672,7 @@ static size_t seq_disk_cache_write_header(FILE *file, const DiskCacheHeader *hea
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
+static int seq_disk_cache_add_header_entry(const uint64_t frame_index,
                                            ImBuf *ibuf,
                                            DiskCacheHeader *header)
 {
@@ -510,7 +707,7 @@ static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
   }
 
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  header->entry[i].frameno = frame_index;
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
@@ -538,13 +735,31 @@ static int seq_disk_cache_get_header_entry(const SeqCacheKey *key, const DiskCac
   return -1;
 }
 
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+/**
+ * \param write_task: The asynchronous write that writes the image, if any. Nothing is written if
+ * it has been canceled by invalidation.
+ */
+static bool seq_disk_cache_write_file_ex(SeqDiskCache *disk_cache,
+                                         const char *filepath,
+                                         const uint64_t frame_index,
+                                         ImBuf *ibuf,
+                                         const DiskCacheWriteTask *write_task)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
-
-  char filepath[FILE_MAX];
+  ThreadMutex *file_lock = seq_disk_cache_file_lock(disk_cache, filepath);
+  BLI_mutex_lock(file_lock);
+
+  /* Check while holding the file lock: invalidation either cancels the write before it starts,
+   * or deletes the file after the write is finished. */
+  if (write_task) {
+    BLI_mutex_lock(&disk_cache->files_mutex);
+    const bool is_canceled = write_task->is_canceled;
+    BLI_mutex_unlock(&disk_cache->files_mutex);
+    if (is_canceled) {
+      BLI_mutex_unlock(file_lock);
+      return false;
+    }
+  }
 
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
   BLI_file_ensure_parent_dir_exists(filepath);
 
   /* Touch the file. */
@@ -552,24 +767,36 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
   if (!file) {
     file = BLI_fopen(filepath, "wb+");
     if (!file) {
-      BLI_mutex_unlock(&disk_cache->read_write_mutex);
+      BLI_mutex_unlock(file_lock);
       return false;
     }
+  }
+
+  BLI_mutex_lock(&disk_cache->files_mutex);
+  if (seq_disk_cache_get_file_entry_by_path(disk_cache, filepath) == nullptr) {
     seq_disk_cache_add_file_to_list(disk_cache, filepath);
   }
+  BLI_mutex_unlock(&disk_cache->files_mutex);
+
+  BLI_fseek(file, 0LL, SEEK_END);
+  const bool is_empty = BLI_ftell(file) == 0;
 
-  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
   DiskCacheHeader header;
   memset(&header, 0, sizeof(header));
   /* The file may be empty when touched (above).
    * This is fine, don't attempt reading the header in that case. */
-  if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, &header)) {
+  if (!is_empty && !seq_disk_cache_read_header(file, &header)) {
     fclose(file);
-    seq_disk_cache_delete_file(disk_cache, cache_file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_lock(&disk_cache->files_mutex);
+    DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
+    if (cache_file != nullptr) {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+    }
+    BLI_mutex_unlock(&disk_cache->files_mutex);
+    BLI_mutex_unlock(file_lock);
     return false;
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  int entry_index = seq_disk_cache_add_header_entry(frame_index, ibuf, &header);
 
   size_t bytes_written = deflate_imbuf_to_file(
       ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
@@ -580,36 +807,99 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
      */
     header.entry[entry_index].size_compressed = bytes_written;
     seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, filepath);
-    fclose(file);
+  }
+  fclose(file);
 
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
-    return true;
+  if (bytes_written != 0) {
+    BLI_mutex_lock(&disk_cache->files_mutex);
+    seq_disk_cache_update_file(disk_cache, filepath);
+    BLI_mutex_unlock(&disk_cache->files_mutex);
   }
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-  return false;
+  BLI_mutex_unlock(file_lock);
+  return bytes_written != 0;
 }
 
-ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void *task_data)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(BLI_task_pool_user_data(pool));
+  DiskCacheWriteTask *write_task = static_cast<DiskCacheWriteTask *>(task_data);
 
+  seq_disk_cache_write_file_ex(
+      disk_cache, write_task->filepath, write_task->frame_index, write_task->ibuf, write_task);
+  seq_disk_cache_enforce_limits(disk_cache);
+}
+
+static void seq_disk_cache_write_task_free(TaskPool *__restrict pool, void *task_data)
+{
+  DiskCacheWriteTask *write_task = static_cast<DiskCacheWriteTask *>(task_data);
+  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(BLI_task_pool_user_data(pool));
+  BLI_mutex_lock(&disk_cache->files_mutex);
+  BLI_remlink(&disk_cache->pending_writes, write_task);
+  BLI_mutex_unlock(&disk_cache->files_mutex);
+  IMB_freeImBuf(write_task->ibuf);
+  MEM_freeN(write_task);
+  atomic_sub_and_fetch_int32(&disk_cache->scheduled_writes_num, 1);
+}
+
+void seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  if (atomic_add_and_fetch_int32(&disk_cache->scheduled_writes_num, 1) >
+      DCACHE_MAX_SCHEDULED_WRITES)
+  {
+    /* Writing can't keep up with rendering, avoid keeping an unbounded number of images alive by
+     * writing on this thread, which also slows down rendering. */
+    atomic_sub_and_fetch_int32(&disk_cache->scheduled_writes_num, 1);
+    char filepath[FILE_MAX];
+    seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
+    seq_disk_cache_write_file_ex(disk_cache, filepath, key->frame_index, ibuf, nullptr);
+    seq_disk_cache_enforce_limits(disk_cache);
+    return;
+  }
+
+  DiskCacheWriteTask *write_task = MEM_cnew<DiskCacheWriteTask>(__func__);
+  /* Resolve the path now, strip or scene may not exist anymore once the task runs. */
+  seq_disk_cache_get_file_path(
+      disk_cache, key, write_task->filepath, sizeof(write_task->filepath));
+  BLI_path_split_dir_part(write_task->filepath, write_task->dir, sizeof(write_task->dir));
+  write_task->cache_type = key->type;
+  write_task->start_frame = (int(key->frame_index) / DCACHE_IMAGES_PER_FILE) *
+                            DCACHE_IMAGES_PER_FILE;
+  write_task->frame_index = key->frame_index;
+  IMB_refImBuf(ibuf);
+  write_task->ibuf = ibuf;
+
+  BLI_mutex_lock(&disk_cache->files_mutex);
+  BLI_addtail(&disk_cache->pending_writes, write_task);
+  BLI_mutex_unlock(&disk_cache->files_mutex);
+
+  BLI_task_pool_push(disk_cache->write_pool,
+                     seq_disk_cache_write_task,
+                     write_task,
+                     true,
+                     seq_disk_cache_write_task_free);
+}
+
+ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+{
   char filepath[FILE_MAX];
   DiskCacheHeader header;
 
   seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
   BLI_file_ensure_parent_dir_exists(filepath);
 
+  ThreadMutex *file_lock = seq_disk_cache_file_lock(disk_cache, filepath);
+  BLI_mutex_lock(file_lock);
+
   FILE *file = BLI_fopen(filepath, "rb");
   if (!file) {
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_unlock(file_lock);
     return nullptr;
   }
 
   if (!seq_disk_cache_read_header(file, &header)) {
     fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_unlock(file_lock);
     return nullptr;
   }
   int entry_index = seq_disk_cache_get_header_entry(key, &header);
@@ -617,7 +907,7 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
   /* Item not found. */
   if (entry_index < 0) {
     fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_unlock(file_lock);
     return nullptr;
   }
 
@@ -640,7 +930,7 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
   }
   else {
     fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_unlock(file_lock);
     return nullptr;
   }
 
@@ -650,14 +940,17 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
   if (bytes_read != expected_size) {
     fclose(file);
     IMB_freeImBuf(ibuf);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    BLI_mutex_unlock(file_lock);
     return nullptr;
   }
+  fclose(file);
   BLI_file_touch(filepath);
+
+  BLI_mutex_lock(&disk_cache->files_mutex);
   seq_disk_cache_update_file(disk_cache, filepath);
-  fclose(file);
+  BLI_mutex_unlock(&disk_cache->files_mutex);
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  BLI_mutex_unlock(file_lock);
   return ibuf;
 }
 
@@ -666,7 +959,11 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
   SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(
       MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache"));
   disk_cache->bmain = bmain;
-  BLI_mutex_init(&disk_cache->read_write_mutex);
+  BLI_mutex_init(&disk_cache->files_mutex);
+  for (ThreadMutex &file_lock : disk_cache->file_locks) {
+    BLI_mutex_init(&file_lock);
+  }
+  disk_cache->write_pool = BLI_task_pool_create_background(disk_cache, TASK_PRIORITY_LOW);
   seq_disk_cache_handle_versioning(disk_cache);
   seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
   disk_cache->timestamp = scene->ed->disk_cache_timestamp;
@@ -676,7 +973,13 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 
 void seq_disk_cache_free(SeqDiskCache *disk_cache)
 {
+  BLI_task_pool_work_and_wait(disk_cache->write_pool);
+  BLI_task_pool_free(disk_cache->write_pool);
+
   BLI_freelistN(&disk_cache->files);
-  BLI_mutex_end(&disk_cache->read_write_mutex);
+  BLI_mutex_end(&disk_cache->files_mutex);
+  for (ThreadMutex &file_lock : disk_cache->file_locks) {
+    BLI_mutex_end(&file_lock);
+  }
   MEM_freeN(disk_cache);
 }
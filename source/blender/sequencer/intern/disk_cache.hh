@@ -23,7 +23,8 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene);
 void seq_disk_cache_free(SeqDiskCache *disk_cache);
 bool seq_disk_cache_is_enabled(Main *bmain);
 ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key);
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf);
+/** Queue \a ibuf to be written to disk in the background, \a ibuf is referenced until then. */
+void seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf);
 bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache);
 void seq_disk_cache_invalidate(
     SeqDiskCache *disk_cache, Scene *scene, Strip *seq, Strip *seq_changed, int invalidate_types);
@@ -6,7 +6,9 @@
  * \ingroup sequencer
  */
 
-#include "BLI_math_color_blend.h"
+#include <optional>
+
+#include "BLI_math_color_blend.hh"
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
@@ -142,175 +144,68 @@ static ImBuf *do_alphaunder_effect(const SeqRenderData *context,
 /* -------------------------------------------------------------------- */
 /* Blend Mode Effect */
 
-/* blend_function has to be: void (T* dst, const T *src1, const T *src2) */
-template<typename T, typename Func>
-static void apply_blend_function(
-    float fac, int64_t size, const T *src1, const T *src2, T *dst, Func blend_function)
-{
-  for (int64_t i = 0; i < size; i++) {
-    T achannel = src2[3];
-    ((T *)src2)[3] = T(achannel * fac);
-    blend_function(dst, src1, src2);
-    ((T *)src2)[3] = achannel;
-    dst[3] = src1[3];
-    src1 += 4;
-    src2 += 4;
-    dst += 4;
-  }
-}
-
-static void do_blend_effect_float(
-    float fac, int64_t size, const float *rect1, const float *rect2, int btype, float *out)
-{
-  switch (btype) {
-    case SEQ_TYPE_ADD:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_add_float);
-      break;
-    case SEQ_TYPE_SUB:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_sub_float);
-      break;
-    case SEQ_TYPE_MUL:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_mul_float);
-      break;
-    case SEQ_TYPE_DARKEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_darken_float);
-      break;
-    case SEQ_TYPE_COLOR_BURN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_burn_float);
-      break;
-    case SEQ_TYPE_LINEAR_BURN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_linearburn_float);
-      break;
-    case SEQ_TYPE_SCREEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_screen_float);
-      break;
-    case SEQ_TYPE_LIGHTEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_lighten_float);
-      break;
-    case SEQ_TYPE_DODGE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_dodge_float);
-      break;
-    case SEQ_TYPE_OVERLAY:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_overlay_float);
-      break;
-    case SEQ_TYPE_SOFT_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_softlight_float);
-      break;
-    case SEQ_TYPE_HARD_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_hardlight_float);
-      break;
-    case SEQ_TYPE_PIN_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_pinlight_float);
-      break;
-    case SEQ_TYPE_LIN_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_linearlight_float);
-      break;
-    case SEQ_TYPE_VIVID_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_vividlight_float);
-      break;
-    case SEQ_TYPE_BLEND_COLOR:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_color_float);
-      break;
-    case SEQ_TYPE_HUE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_hue_float);
-      break;
-    case SEQ_TYPE_SATURATION:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_saturation_float);
-      break;
-    case SEQ_TYPE_VALUE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_luminosity_float);
-      break;
-    case SEQ_TYPE_DIFFERENCE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_difference_float);
-      break;
-    case SEQ_TYPE_EXCLUSION:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_exclusion_float);
-      break;
-    default:
-      break;
-  }
-}
-
-static void do_blend_effect_byte(
-    float fac, int64_t size, const uchar *rect1, const uchar *rect2, int btype, uchar *out)
+static std::optional<math::ColorBlendMode> blend_mode_from_seq_type(const int btype)
 {
   switch (btype) {
     case SEQ_TYPE_ADD:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_add_byte);
-      break;
+      return math::ColorBlendMode::Add;
     case SEQ_TYPE_SUB:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_sub_byte);
-      break;
+      return math::ColorBlendMode::Sub;
     case SEQ_TYPE_MUL:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_mul_byte);
-      break;
+      return math::ColorBlendMode::Mul;
     case SEQ_TYPE_DARKEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_darken_byte);
-      break;
+      return math::ColorBlendMode::Darken;
     case SEQ_TYPE_COLOR_BURN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_burn_byte);
-      break;
+      return math::ColorBlendMode::ColorBurn;
     case SEQ_TYPE_LINEAR_BURN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_linearburn_byte);
-      break;
+      return math::ColorBlendMode::LinearBurn;
     case SEQ_TYPE_SCREEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_screen_byte);
-      break;
+      return math::ColorBlendMode::Screen;
     case SEQ_TYPE_LIGHTEN:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_lighten_byte);
-      break;
+      return math::ColorBlendMode::Lighten;
     case SEQ_TYPE_DODGE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_dodge_byte);
-      break;
+      return math::ColorBlendMode::Dodge;
     case SEQ_TYPE_OVERLAY:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_overlay_byte);
-      break;
+      return math::ColorBlendMode::Overlay;
     case SEQ_TYPE_SOFT_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_softlight_byte);
-      break;
+      return math::ColorBlendMode::SoftLight;
     case SEQ_TYPE_HARD_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_hardlight_byte);
-      break;
+      return math::ColorBlendMode::HardLight;
     case SEQ_TYPE_PIN_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_pinlight_byte);
-      break;
+      return math::ColorBlendMode::PinLight;
     case SEQ_TYPE_LIN_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_linearlight_byte);
-      break;
+      return math::ColorBlendMode::LinearLight;
     case SEQ_TYPE_VIVID_LIGHT:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_vividlight_byte);
-      break;
+      return math::ColorBlendMode::VividLight;
     case SEQ_TYPE_BLEND_COLOR:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_color_byte);
-      break;
+      return math::ColorBlendMode::Color;
     case SEQ_TYPE_HUE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_hue_byte);
-      break;
+      return math::ColorBlendMode::Hue;
     case SEQ_TYPE_SATURATION:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_saturation_byte);
-      break;
+      return math::ColorBlendMode::Saturation;
     case SEQ_TYPE_VALUE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_luminosity_byte);
-      break;
+      return math::ColorBlendMode::Luminosity;
     case SEQ_TYPE_DIFFERENCE:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_difference_byte);
-      break;
+      return math::ColorBlendMode::Difference;
     case SEQ_TYPE_EXCLUSION:
-      apply_blend_function(fac, size, rect1, rect2, out, blend_color_exclusion_byte);
-      break;
+      return math::ColorBlendMode::Exclusion;
     default:
-      break;
+      return std::nullopt;
   }
 }
 
 struct BlendModeEffectOp {
   template<typename T> void apply(const T *src1, const T *src2, T *dst, int64_t size) const
   {
+    const std::optional<math::ColorBlendMode> mode = blend_mode_from_seq_type(this->blend_mode);
+    if (!mode) {
+      return;
+    }
     if constexpr (std::is_same_v<T, float>) {
-      do_blend_effect_float(this->factor, size, src1, src2, this->blend_mode, dst);
+      math::blend_color_float(*mode, this->factor, src1, src2, dst, size);
     }
     else {
-      do_blend_effect_byte(this->factor, size, src1, src2, this->blend_mode, dst);
+      math::blend_color_byte(*mode, this->factor, src1, src2, dst, size);
     }
   }
   int blend_mode; /* SEQ_TYPE_ */
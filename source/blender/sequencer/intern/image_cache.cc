@@ -820,8 +820,8 @@ void seq_cache_put(
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
+      /* Limits are enforced once the image has been written. */
       seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
     }
   }
 }
@@ -6,6 +6,9 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
@@ -16,7 +19,9 @@
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
+#include "BLI_assert.h"
 #include "BLI_listbase.h"
 #include "BLI_threads.h"
 
@@ -46,37 +51,64 @@
 #include "prefetch.hh"
 #include "render.hh"
 
-struct PrefetchJob {
-  PrefetchJob *next, *prev;
+/** Upper bound for the number of frames that are prefetched at the same time. */
+#define SEQ_PREFETCH_MAX_WORKERS 4
+
+struct PrefetchJob;
+
+/**
+ * Every worker renders one frame at a time in its own thread. It has its own copy of the scene,
+ * so that multiple frames with different animated values can be rendered at the same time.
+ */
+struct PrefetchWorker {
+  PrefetchJob *pfjob = nullptr;
+  Depsgraph *depsgraph = nullptr;
+  Scene *scene_eval = nullptr;
+  SeqRenderData context_cpy = {};
+  /**
+   * Context of the original scene that the cache entries of this worker are stored with, see
+   * #seq_prefetch_get_original_context. It has the same task ID as #context_cpy.
+   */
+  SeqRenderData context_orig = {};
+  /** Frame that is currently rendered by this worker. */
+  float cfra = 0.0f;
+  /** True while the frame at #cfra is claimed by this worker and not stored in the cache yet. */
+  bool is_rendering = false;
+};
 
-  Main *bmain;
-  Main *bmain_eval;
-  Scene *scene;
-  Scene *scene_eval;
-  Depsgraph *depsgraph;
+struct PrefetchJob {
+  Main *bmain = nullptr;
+  Main *bmain_eval = nullptr;
+  Scene *scene = nullptr;
 
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
 
-  ListBase threads;
+  ListBase threads = {nullptr, nullptr};
+
+  PrefetchWorker workers[SEQ_PREFETCH_MAX_WORKERS];
+  int workers_num = 0;
 
   /* context */
-  SeqRenderData context;
-  SeqRenderData context_cpy;
-  ListBase *seqbasep;
-  ListBase *seqbasep_cpy;
+  SeqRenderData context = {};
 
   /* prefetch area */
-  float cfra;
-  int num_frames_prefetched;
+  float cfra = 0.0f;
+  /** Number of frames after #cfra that have been claimed by a worker. */
+  int num_frames_claimed = 0;
+  /**
+   * Number of frames after #cfra that have been stored in the cache. Frames can finish out of
+   * order, so this only includes the frames before the first frame that is still rendered.
+   */
+  int num_frames_prefetched = 0;
 
   /* Control: */
   /* Set by prefetch. */
-  bool running;
-  bool waiting;
-  bool stop;
+  std::atomic<int> running_workers_num = 0;
+  std::atomic<int> waiting_workers_num = 0;
+  bool stop = false;
   /* Set from outside. */
-  bool is_scrubbing;
+  bool is_scrubbing = false;
 };
 
 static PrefetchJob *seq_prefetch_job_get(Scene *scene)
@@ -95,7 +127,7 @@ bool seq_prefetch_job_is_running(Scene *scene)
     return false;
   }
 
-  return pfjob->running;
+  return pfjob->running_workers_num > 0;
 }
 
 static void seq_prefetch_job_scrubbing_set(Scene *scene, bool is_scrubbing)
@@ -117,7 +149,10 @@ static bool seq_prefetch_job_is_waiting(Scene *scene)
     return false;
   }
 
-  return pfjob->waiting;
+  /* Workers that still produce frames need redraws, so only report waiting once all of them
+   * wait. */
+  return pfjob->waiting_workers_num > 0 &&
+         pfjob->waiting_workers_num >= pfjob->running_workers_num;
 }
 
 static Strip *sequencer_prefetch_get_original_sequence(Strip *seq, ListBase *seqbase)
@@ -148,6 +183,15 @@ SeqRenderData *seq_prefetch_get_original_context(const SeqRenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
+  /* The task ID identifies the worker, also for copies of its context. */
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    PrefetchWorker &worker = pfjob->workers[i];
+    if (worker.context_orig.task_id == context->task_id) {
+      return &worker.context_orig;
+    }
+  }
+
+  BLI_assert_unreachable();
   return &pfjob->context;
 }
 
@@ -164,11 +208,11 @@ static bool seq_prefetch_is_cache_full(Scene *scene)
 
 static float seq_prefetch_cfra(PrefetchJob *pfjob)
 {
-  return pfjob->cfra + pfjob->num_frames_prefetched;
+  return pfjob->cfra + pfjob->num_frames_claimed;
 }
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
+static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchWorker *worker)
 {
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  return BKE_animsys_eval_context_construct(worker->depsgraph, worker->cfra);
 }
 
 void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
@@ -176,40 +220,78 @@ void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
   *r_start = pfjob->cfra;
+  /* Include frames that are still being rendered, their intermediate images must not be
+   * recycled either. */
   *r_end = seq_prefetch_cfra(pfjob);
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchWorker *worker)
+{
+  if (worker->depsgraph != nullptr) {
+    DEG_graph_free(worker->depsgraph);
+  }
+  worker->depsgraph = nullptr;
+  worker->scene_eval = nullptr;
+}
+
+static void seq_prefetch_free_depsgraphs(PrefetchJob *pfjob)
 {
-  if (pfjob->depsgraph != nullptr) {
-    DEG_graph_free(pfjob->depsgraph);
+  for (PrefetchWorker &worker : pfjob->workers) {
+    seq_prefetch_free_depsgraph(&worker);
   }
-  pfjob->depsgraph = nullptr;
-  pfjob->scene_eval = nullptr;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker->depsgraph, worker->cfra);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_init_depsgraph(PrefetchWorker *worker)
 {
+  PrefetchJob *pfjob = worker->pfjob;
   Main *bmain = pfjob->bmain_eval;
   Scene *scene = pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH");
 
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph);
+  DEG_graph_build_for_render_pipeline(worker->depsgraph);
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  worker->cfra = seq_prefetch_cfra(pfjob);
+  seq_prefetch_update_depsgraph(worker);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+  worker->scene_eval->ed->cache_flag = 0;
+}
+
+/**
+ * Every worker keeps at least one frame with all its intermediate images alive. It also has its
+ * own evaluated copy of the scene, so it opens its own reader for every movie strip, which keeps
+ * decoded frames around. So the number of workers is limited by the cache budget as well as by
+ * the number of cores.
+ */
+static int seq_prefetch_workers_num_get(const SeqRenderData *context)
+{
+  const size_t frame_size = size_t(context->rectx) * size_t(context->recty) * 4 * sizeof(float);
+  const size_t cache_limit = size_t(U.memcachelimit) * 1024 * 1024;
+
+  int64_t movie_strips_num = 0;
+  for (const Strip *seq : SEQ_query_all_strips_recursive(&context->scene->ed->seqbase)) {
+    if (seq->type == SEQ_TYPE_MOVIE) {
+      movie_strips_num++;
+    }
+  }
+  /* Assume a few decoded frames per movie reader. Leave most of the cache for the prefetched
+   * frames and the intermediate images of strips. */
+  const size_t worker_size = frame_size * (16 + size_t(movie_strips_num) * 4);
+  const size_t max_workers_by_memory = cache_limit / std::max<size_t>(worker_size, 1);
+
+  int workers_num = BLI_system_thread_count() / 2;
+  workers_num = std::min<int>(workers_num, std::min<size_t>(max_workers_by_memory, INT_MAX));
+  return std::clamp(workers_num, 1, SEQ_PREFETCH_MAX_WORKERS);
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -220,16 +302,14 @@ static void seq_prefetch_update_area(PrefetchJob *pfjob)
   if (cfra > pfjob->cfra) {
     int delta = cfra - pfjob->cfra;
     pfjob->cfra = cfra;
-    pfjob->num_frames_prefetched -= delta;
-
-    if (pfjob->num_frames_prefetched <= 1) {
-      pfjob->num_frames_prefetched = 1;
-    }
+    pfjob->num_frames_claimed = std::max(pfjob->num_frames_claimed - delta, 1);
+    pfjob->num_frames_prefetched = std::max(pfjob->num_frames_prefetched - delta, 1);
   }
 
   /* reset */
   if (cfra < pfjob->cfra) {
     pfjob->cfra = cfra;
+    pfjob->num_frames_claimed = 1;
     pfjob->num_frames_prefetched = 1;
   }
 }
@@ -255,8 +335,8 @@ void SEQ_prefetch_stop(Scene *scene)
 
   pfjob->stop = true;
 
-  while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  while (pfjob->running_workers_num > 0) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -265,19 +345,22 @@ static void seq_prefetch_update_context(const SeqRenderData *context)
   PrefetchJob *pfjob;
   pfjob = seq_prefetch_job_get(context->scene);
 
-  SEQ_render_new_render_data(pfjob->bmain_eval,
-                             pfjob->depsgraph,
-                             pfjob->scene_eval,
-                             context->rectx,
-                             context->recty,
-                             context->preview_render_size,
-                             false,
-                             &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    PrefetchWorker &worker = pfjob->workers[i];
+    SEQ_render_new_render_data(pfjob->bmain_eval,
+                               worker.depsgraph,
+                               worker.scene_eval,
+                               context->rectx,
+                               context->recty,
+                               context->preview_render_size,
+                               false,
+                               &worker.context_cpy);
+    worker.context_cpy.is_prefetch_render = true;
+    worker.context_cpy.task_id = eSeqTaskId(SEQ_TASK_PREFETCH_RENDER + i);
+  }
 
   SEQ_render_new_render_data(pfjob->bmain,
-                             pfjob->depsgraph,
+                             pfjob->workers[0].depsgraph,
                              pfjob->scene,
                              context->rectx,
                              context->recty,
@@ -286,11 +369,14 @@ static void seq_prefetch_update_context(const SeqRenderData *context)
                              &pfjob->context);
   pfjob->context.is_prefetch_render = false;
 
-  /* Same ID as prefetch context, because context will be swapped, but we still
-   * want to assign this ID to cache entries created in this thread.
-   * This is to allow "temp cache" work correctly for both threads.
-   */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  /* The context is swapped for the original context of the worker when storing cache entries,
+   * which keeps the ID of the worker, so that the "temp cache" of every worker is freed
+   * separately. */
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    PrefetchWorker &worker = pfjob->workers[i];
+    worker.context_orig = pfjob->context;
+    worker.context_orig.task_id = worker.context_cpy.task_id;
+  }
 }
 
 static void seq_prefetch_update_scene(Scene *scene)
@@ -302,17 +388,19 @@ static void seq_prefetch_update_scene(Scene *scene)
   }
 
   pfjob->scene = scene;
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
+  seq_prefetch_free_depsgraphs(pfjob);
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    seq_prefetch_init_depsgraph(&pfjob->workers[i]);
+  }
 }
 
-static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
+static void seq_prefetch_update_active_seqbase(PrefetchWorker *worker)
 {
-  MetaStack *ms_orig = SEQ_meta_stack_active_get(SEQ_editing_get(pfjob->scene));
-  Editing *ed_eval = SEQ_editing_get(pfjob->scene_eval);
+  MetaStack *ms_orig = SEQ_meta_stack_active_get(SEQ_editing_get(worker->pfjob->scene));
+  Editing *ed_eval = SEQ_editing_get(worker->scene_eval);
 
   if (ms_orig != nullptr) {
-    Strip *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, pfjob->scene_eval);
+    Strip *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, worker->scene_eval);
     SEQ_seqbase_active_set(ed_eval, &meta_eval->seqbase);
   }
   else {
@@ -324,8 +412,8 @@ static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->waiting_workers_num > 0) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -338,22 +426,24 @@ void seq_prefetch_free(Scene *scene)
 
   SEQ_prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (PrefetchWorker &worker : pfjob->workers) {
+    BLI_threadpool_remove(&pfjob->threads, &worker);
+  }
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
+  seq_prefetch_free_depsgraphs(pfjob);
   BKE_main_free(pfjob->bmain_eval);
-  MEM_freeN(pfjob);
+  MEM_delete(pfjob);
   scene->ed->prefetch_job = nullptr;
 }
 
-static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
+static bool seq_prefetch_seq_has_disk_cache(PrefetchWorker *worker,
                                             Strip *seq,
                                             bool can_have_final_image)
 {
-  SeqRenderData *ctx = &pfjob->context_cpy;
-  float cfra = seq_prefetch_cfra(pfjob);
+  SeqRenderData *ctx = &worker->context_cpy;
+  float cfra = worker->cfra;
 
   ImBuf *ibuf = seq_cache_get(ctx, seq, cfra, SEQ_CACHE_STORE_PREPROCESSED);
   if (ibuf != nullptr) {
@@ -380,28 +470,28 @@ static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
   return false;
 }
 
-static bool seq_prefetch_scene_strip_is_rendered(PrefetchJob *pfjob,
+static bool seq_prefetch_scene_strip_is_rendered(PrefetchWorker *worker,
                                                  ListBase *channels,
                                                  ListBase *seqbase,
                                                  blender::Span<Strip *> scene_strips,
                                                  bool is_recursive_check)
 {
-  float cfra = seq_prefetch_cfra(pfjob);
+  float cfra = worker->cfra;
   blender::Vector<Strip *> strips = seq_get_shown_sequences(
-      pfjob->scene_eval, channels, seqbase, cfra, 0);
+      worker->scene_eval, channels, seqbase, cfra, 0);
 
   /* Iterate over rendered strips. */
   for (Strip *seq : strips) {
     if (seq->type == SEQ_TYPE_META &&
         seq_prefetch_scene_strip_is_rendered(
-            pfjob, &seq->channels, &seq->seqbase, scene_strips, true))
+            worker, &seq->channels, &seq->seqbase, scene_strips, true))
     {
       return true;
     }
 
     /* Disable prefetching 3D scene strips, but check for disk cache. */
     if (seq->type == SEQ_TYPE_SCENE && (seq->flag & SEQ_SCENE_STRIPS) == 0 &&
-        !seq_prefetch_seq_has_disk_cache(pfjob, seq, !is_recursive_check))
+        !seq_prefetch_seq_has_disk_cache(worker, seq, !is_recursive_check))
     {
       return true;
     }
@@ -429,10 +519,12 @@ static blender::VectorSet<Strip *> query_scene_strips(ListBase *seqbase)
 
 /* Prefetch must avoid rendering scene strips, because rendering in background locks UI and can
  * make it unresponsive for long time periods. */
-static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *channels, ListBase *seqbase)
+static bool seq_prefetch_must_skip_frame(PrefetchWorker *worker,
+                                         ListBase *channels,
+                                         ListBase *seqbase)
 {
   blender::VectorSet<Strip *> scene_strips = query_scene_strips(seqbase);
-  if (seq_prefetch_scene_strip_is_rendered(pfjob, channels, seqbase, scene_strips, false)) {
+  if (seq_prefetch_scene_strip_is_rendered(worker, channels, seqbase, scene_strips, false)) {
     return true;
   }
   return false;
@@ -450,26 +542,71 @@ static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
   while (seq_prefetch_need_suspend(pfjob) &&
          (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop)
   {
-    pfjob->waiting = true;
+    pfjob->waiting_workers_num++;
     BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
+    pfjob->waiting_workers_num--;
     seq_prefetch_update_area(pfjob);
   }
-  pfjob->waiting = false;
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 }
 
-static void *seq_prefetch_frames(void *job)
+/**
+ * Reserve the next frame that has not been prefetched yet for the given worker. Returns false
+ * when the end of the scene frame range has been reached.
+ */
+static bool seq_prefetch_claim_frame(PrefetchWorker *worker)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  seq_prefetch_update_area(pfjob);
+  worker->cfra = seq_prefetch_cfra(pfjob);
+  const bool is_in_range = worker->cfra <= pfjob->scene->r.efra;
+  if (is_in_range) {
+    pfjob->num_frames_claimed++;
+    worker->is_rendering = true;
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  return is_in_range;
+}
+
+/**
+ * Mark the frame of the worker as finished, after it has been stored in the cache or skipped.
+ * The prefetched range ends at the first frame that is still being rendered by any worker.
+ */
+static void seq_prefetch_finish_frame(PrefetchWorker *worker)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  worker->is_rendering = false;
+  float prefetched_end = seq_prefetch_cfra(pfjob);
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    const PrefetchWorker &other_worker = pfjob->workers[i];
+    if (other_worker.is_rendering) {
+      prefetched_end = std::min(prefetched_end, other_worker.cfra);
+    }
+  }
+  pfjob->num_frames_prefetched = std::max(int(prefetched_end - pfjob->cfra), 1);
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+}
+
+static bool seq_prefetch_must_stop(PrefetchJob *pfjob)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
+  return !(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop;
+}
+
+static void *seq_prefetch_frames(void *data)
+{
+  PrefetchWorker *worker = static_cast<PrefetchWorker *>(data);
+  PrefetchJob *pfjob = worker->pfjob;
 
-  while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = nullptr;
+  while (seq_prefetch_claim_frame(worker)) {
+    worker->scene_eval->ed->prefetch_job = nullptr;
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
+    seq_prefetch_update_depsgraph(worker);
+    AnimData *adt = BKE_animdata_from_id(&worker->context_cpy.scene->id);
+    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(worker);
     BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+        &worker->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
 
     /* This is quite hacky solution:
      * We need cross-reference original scene with copy for cache.
@@ -477,22 +614,23 @@ static void *seq_prefetch_frames(void *job)
      * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
      * Set to nullptr before return!
      */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+    worker->scene_eval->ed->prefetch_job = pfjob;
 
-    ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(pfjob->scene_eval));
-    ListBase *channels = SEQ_channels_displayed_get(SEQ_editing_get(pfjob->scene_eval));
-    if (seq_prefetch_must_skip_frame(pfjob, channels, seqbase)) {
-      pfjob->num_frames_prefetched++;
+    ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(worker->scene_eval));
+    ListBase *channels = SEQ_channels_displayed_get(SEQ_editing_get(worker->scene_eval));
+    if (seq_prefetch_must_skip_frame(worker, channels, seqbase)) {
+      seq_prefetch_finish_frame(worker);
       /* Break instead of keep looping if the job should be terminated. */
-      if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
+      if (seq_prefetch_must_stop(pfjob)) {
         break;
       }
       continue;
     }
 
-    ImBuf *ibuf = SEQ_render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+    ImBuf *ibuf = SEQ_render_give_ibuf(&worker->context_cpy, worker->cfra, 0);
+    seq_cache_free_temp_cache(pfjob->scene, worker->context_orig.task_id, worker->cfra);
     IMB_freeImBuf(ibuf);
+    seq_prefetch_finish_frame(worker);
 
     /* Suspend thread if there is nothing to be prefetched. */
     seq_prefetch_do_suspend(pfjob);
@@ -503,17 +641,14 @@ static void *seq_prefetch_frames(void *job)
       break;
     }
 
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
+    if (seq_prefetch_must_stop(pfjob)) {
       break;
     }
-
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
   }
 
-  seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = nullptr;
+  seq_cache_free_temp_cache(pfjob->scene, worker->context_orig.task_id, worker->cfra);
+  worker->scene_eval->ed->prefetch_job = nullptr;
+  pfjob->running_workers_num--;
 
   return nullptr;
 }
@@ -524,33 +659,48 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
 
   if (!pfjob) {
     if (context->scene->ed) {
-      pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
+      pfjob = MEM_new<PrefetchJob>("PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
-      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, SEQ_PREFETCH_MAX_WORKERS);
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
       pfjob->bmain_eval = BKE_main_new();
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
+      for (PrefetchWorker &worker : pfjob->workers) {
+        worker.pfjob = pfjob;
+      }
     }
   }
   pfjob->bmain = context->bmain;
 
+  /* Make sure the threads of the previous run have finished before their data is changed. */
+  for (PrefetchWorker &worker : pfjob->workers) {
+    BLI_threadpool_remove(&pfjob->threads, &worker);
+  }
+
   pfjob->cfra = cfra;
+  pfjob->num_frames_claimed = 1;
   pfjob->num_frames_prefetched = 1;
+  pfjob->workers_num = seq_prefetch_workers_num_get(context);
+  for (PrefetchWorker &worker : pfjob->workers) {
+    worker.is_rendering = false;
+  }
 
-  pfjob->waiting = false;
+  pfjob->waiting_workers_num = 0;
   pfjob->stop = false;
-  pfjob->running = true;
+  pfjob->running_workers_num = pfjob->workers_num;
 
   seq_prefetch_update_scene(context->scene);
   seq_prefetch_update_context(context);
-  seq_prefetch_update_active_seqbase(pfjob);
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    seq_prefetch_update_active_seqbase(&pfjob->workers[i]);
+  }
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+  for (const int i : blender::IndexRange(pfjob->workers_num)) {
+    BLI_threadpool_insert(&pfjob->threads, &pfjob->workers[i]);
+  }
 
   return pfjob;
 }
@@ -8,6 +8,10 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
@@ -18,6 +22,7 @@
 #include "BLI_listbase.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -511,7 +516,6 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context, wmJobWorkerStatus *worker_
   Strip *seq = context->seq;
   Scene *scene = context->scene;
   Main *bmain = context->bmain;
-  int timeline_frame;
 
   if (seq->type == SEQ_TYPE_MOVIE) {
     if (context->proxy_builder) {
@@ -544,33 +548,45 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context, wmJobWorkerStatus *worker_
   render_context.is_proxy_render = true;
   render_context.view_id = context->view_id;
 
-  SeqRenderState state;
-
-  for (timeline_frame = SEQ_time_left_handle_frame_get(scene, seq);
-       timeline_frame < SEQ_time_right_handle_frame_get(scene, seq);
-       timeline_frame++)
-  {
-    if (context->size_flags & IMB_PROXY_25) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 25, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_50) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 50, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_75) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 75, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_100) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 100, overwrite);
-    }
-
-    worker_status->progress = float(timeline_frame - SEQ_time_left_handle_frame_get(scene, seq)) /
-                              (SEQ_time_right_handle_frame_get(scene, seq) -
-                               SEQ_time_left_handle_frame_get(scene, seq));
+  /* Frames of image strips are independent of each other, build them in parallel unless the
+   * strip renders other strips. */
+  const int frame_start = SEQ_time_left_handle_frame_get(scene, seq);
+  const int frames_num = std::max(SEQ_time_right_handle_frame_get(scene, seq) - frame_start, 0);
+  const int grain_size = seq_render_strip_supports_threading(seq) ? 1 : std::max(frames_num, 1);
+  /* Progress is only published by the calling thread, which builds frames too. */
+  const std::thread::id caller_thread_id = std::this_thread::get_id();
+  std::atomic<int> frames_done = 0;
+  blender::threading::parallel_for(
+      blender::IndexRange(frames_num), grain_size, [&](const blender::IndexRange range) {
+        SeqRenderState state;
+        for (const int64_t i : range) {
+          const int timeline_frame = frame_start + int(i);
+          if (worker_status->stop || G.is_break) {
+            break;
+          }
+          if (context->size_flags & IMB_PROXY_25) {
+            seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 25, overwrite);
+          }
+          if (context->size_flags & IMB_PROXY_50) {
+            seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 50, overwrite);
+          }
+          if (context->size_flags & IMB_PROXY_75) {
+            seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 75, overwrite);
+          }
+          if (context->size_flags & IMB_PROXY_100) {
+            seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 100, overwrite);
+          }
+
+          frames_done++;
+          if (std::this_thread::get_id() == caller_thread_id) {
+            worker_status->progress = float(frames_done) / frames_num;
+            worker_status->do_update = true;
+          }
+        }
+      });
+  if (frames_num > 0) {
+    worker_status->progress = float(frames_done) / frames_num;
     worker_status->do_update = true;
-
-    if (worker_status->stop || G.is_break) {
-      break;
-    }
   }
 }
 
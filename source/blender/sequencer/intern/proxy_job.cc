@@ -8,11 +8,21 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
 #include "BKE_context.hh"
 
 #include "SEQ_proxy.hh"
@@ -31,22 +41,93 @@ static void proxy_freejob(void *pjv)
   MEM_freeN(pj);
 }
 
+/**
+ * Maximum number of strips that have their proxies built at the same time. Decoders and encoders
+ * are multi-threaded themselves, a few strips are enough to keep all cores busy.
+ */
+#define PROXY_JOB_STRIPS_MAX 4
+
+struct ProxyJobStrips {
+  blender::Vector<SeqIndexBuildContext *> contexts;
+  /** Status of every context, `stop` is forwarded from the job and `progress` collected. */
+  blender::Array<wmJobWorkerStatus> statuses;
+  std::atomic<int64_t> next_index = 0;
+  std::atomic<int> threads_running = 0;
+};
+
+static void *proxy_build_strips_thread(void *data)
+{
+  ProxyJobStrips *strips = static_cast<ProxyJobStrips *>(data);
+  while (true) {
+    const int64_t index = strips->next_index++;
+    if (index >= strips->contexts.size()) {
+      break;
+    }
+    wmJobWorkerStatus &status = strips->statuses[index];
+    if (!status.stop) {
+      SEQ_proxy_rebuild(strips->contexts[index], &status);
+    }
+    status.progress = 1.0f;
+  }
+  strips->threads_running--;
+  return nullptr;
+}
+
+/**
+ * Build proxies of several strips at the same time. The job thread only forwards cancellation
+ * to the strips and reports their combined progress.
+ */
+static void proxy_build_strips_parallel(ProxyJobStrips &strips, wmJobWorkerStatus *worker_status)
+{
+  const int threads_num = int(std::min<int64_t>(strips.contexts.size(), PROXY_JOB_STRIPS_MAX));
+  strips.statuses.reinitialize(strips.contexts.size());
+  strips.statuses.fill({});
+  strips.threads_running = threads_num;
+
+  ListBase threads;
+  BLI_threadpool_init(&threads, proxy_build_strips_thread, threads_num);
+  for (int i = 0; i < threads_num; i++) {
+    BLI_threadpool_insert(&threads, &strips);
+  }
+
+  while (strips.threads_running > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    float progress = 0.0f;
+    for (wmJobWorkerStatus &status : strips.statuses) {
+      status.stop = worker_status->stop;
+      progress += status.progress;
+    }
+    worker_status->progress = progress / strips.statuses.size();
+    worker_status->do_update = true;
+  }
+
+  BLI_threadpool_end(&threads);
+}
+
 /* Only this runs inside thread. */
 static void proxy_startjob(void *pjv, wmJobWorkerStatus *worker_status)
 {
   ProxyJob *pj = static_cast<ProxyJob *>(pjv);
 
+  ProxyJobStrips strips;
   LISTBASE_FOREACH (LinkData *, link, &pj->queue) {
-    SeqIndexBuildContext *context = static_cast<SeqIndexBuildContext *>(link->data);
-
-    SEQ_proxy_rebuild(context, worker_status);
+    strips.contexts.append(static_cast<SeqIndexBuildContext *>(link->data));
+  }
 
-    if (worker_status->stop) {
-      pj->stop = true;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
-      break;
+  if (strips.contexts.size() > 1) {
+    proxy_build_strips_parallel(strips, worker_status);
+  }
+  else {
+    for (SeqIndexBuildContext *context : strips.contexts) {
+      SEQ_proxy_rebuild(context, worker_status);
     }
   }
+
+  if (worker_status->stop) {
+    pj->stop = true;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
+  }
 }
 
 static void proxy_endjob(void *pjv)
@@ -8,7 +8,10 @@
  * \ingroup sequencer
  */
 
+#include <condition_variable>
 #include <ctime>
+#include <mutex>
+#include <shared_mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -18,6 +21,7 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math_geom.h"
@@ -72,6 +76,7 @@
 #include "prefetch.hh"
 #include "proxy.hh"
 #include "render.hh"
+#include "render_timing.hh"
 #include "utils.hh"
 
 #include <algorithm>
@@ -85,7 +90,20 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      float timeline_frame,
                                      int chanshown);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/**
+ * Prefetch workers render separate copies of the scene, so they can render at the same time and
+ * only take a shared lock. Other renders take an exclusive lock.
+ */
+static std::shared_mutex seq_render_mutex;
+/**
+ * Number of threads waiting for the exclusive lock. Prefetch workers don't start rendering new
+ * frames while this is non-zero, so that they can't keep the main thread waiting indefinitely.
+ * Protected by #seq_render_exclusive_waiting_mutex, prefetch workers wait for it to become zero
+ * with #seq_render_exclusive_waiting_cond.
+ */
+static int seq_render_exclusive_waiting_num = 0;
+static std::mutex seq_render_exclusive_waiting_mutex;
+static std::condition_variable seq_render_exclusive_waiting_cond;
 SequencerDrawView sequencer_view3d_fn = nullptr; /* nullptr in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -709,6 +727,8 @@ static ImBuf *input_preprocess(const SeqRenderData *context,
   }
 
   if (seq->modifiers.first) {
+    blender::seq::ScopedRenderTimer timer(
+        context, seq, timeline_frame, blender::seq::RenderTimingStage::Modifiers);
     SEQ_modifier_apply_stack(context, seq, preprocessed_ibuf, timeline_frame);
   }
 
@@ -736,6 +756,8 @@ static ImBuf *seq_render_preprocess_ibuf(const SeqRenderData *context,
   }
 
   if (use_preprocess) {
+    blender::seq::ScopedRenderTimer timer(
+        context, seq, timeline_frame, blender::seq::RenderTimingStage::Preprocess);
     ibuf = input_preprocess(context, seq, timeline_frame, ibuf, is_proxy_image);
   }
 
@@ -1747,6 +1769,7 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
 
   ibuf = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_PREPROCESSED);
   if (ibuf != nullptr) {
+    blender::seq::render_timing_cache_hit(context, seq, timeline_frame);
     return ibuf;
   }
 
@@ -1754,9 +1777,14 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
   if (!SEQ_can_use_proxy(context, seq, SEQ_rendersize_to_proxysize(context->preview_render_size)))
   {
     ibuf = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_RAW);
+    if (ibuf != nullptr) {
+      blender::seq::render_timing_cache_hit(context, seq, timeline_frame);
+    }
   }
 
   if (ibuf == nullptr) {
+    blender::seq::ScopedRenderTimer timer(
+        context, seq, timeline_frame, blender::seq::RenderTimingStage::Render);
     ibuf = do_render_strip_uncached(context, state, seq, timeline_frame, &is_proxy_image);
   }
 
@@ -1816,6 +1844,8 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   SeqEffectHandle sh = seq_effect_get_sequence_blend(seq);
   float fac = seq->blend_opacity / 100.0f;
   int swap_input = seq_must_swap_input_in_blend_mode(seq);
+  blender::seq::ScopedRenderTimer timer(
+      context, seq, timeline_frame, blender::seq::RenderTimingStage::Blend);
 
   if (swap_input) {
     out = sh.execute(context, seq, timeline_frame, fac, ibuf2, ibuf1);
@@ -1847,6 +1877,57 @@ static bool is_opaque_alpha_over(const Strip *seq)
   return true;
 }
 
+bool seq_render_strip_supports_threading(const Strip *seq)
+{
+  if (!ELEM(seq->type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE)) {
+    return false;
+  }
+  LISTBASE_FOREACH (const SequenceModifierData *, smd, &seq->modifiers) {
+    /* The mask strip is rendered by the modifier, it can be of any type. */
+    if ((smd->flag & SEQUENCE_MODIFIER_MUTE) == 0 &&
+        smd->mask_input_type == SEQUENCE_MASK_INPUT_STRIP && smd->mask_sequence != nullptr)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Render the strips above the bottom of the stack that will be blended, as far as they can be
+ * rendered in parallel. Decoding movies and loading images is typically much more expensive than
+ * the blending itself, so rendering those concurrently speeds up stacks with many channels.
+ * Strips that are not rendered here remain null and are rendered when they are blended.
+ */
+static void seq_render_strip_stack_inputs_parallel(const SeqRenderData *context,
+                                                   SeqRenderState *state,
+                                                   const Span<Strip *> strips,
+                                                   const int64_t start,
+                                                   const OpaqueQuadTracker &opaques,
+                                                   const float timeline_frame,
+                                                   MutableSpan<ImBuf *> r_ibufs)
+{
+  Vector<int64_t> indices;
+  for (int64_t i = start; i < strips.size(); i++) {
+    Strip *seq = strips[i];
+    if (!seq_render_strip_supports_threading(seq) || opaques.is_occluded(context, seq, i)) {
+      continue;
+    }
+    if (seq_get_early_out_for_blend_mode(seq) != StripEarlyOut::DoEffect) {
+      continue;
+    }
+    indices.append(i);
+  }
+  if (indices.size() < 2) {
+    return;
+  }
+  threading::parallel_for(indices.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : indices.as_span().slice(range)) {
+      r_ibufs[i] = seq_render_strip(context, state, strips[i], timeline_frame);
+    }
+  });
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *channels,
@@ -1870,6 +1951,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     out = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
 
     if (out) {
+      blender::seq::render_timing_cache_hit(context, seq, timeline_frame);
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
@@ -1949,6 +2031,10 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
   }
 
   i++;
+  Array<ImBuf *> rendered_ibufs(strips.size(), nullptr);
+  seq_render_strip_stack_inputs_parallel(
+      context, state, strips, i, opaques, timeline_frame, rendered_ibufs);
+
   for (; i < strips.size(); i++) {
     Strip *seq = strips[i];
 
@@ -1958,7 +2044,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
 
     if (seq_get_early_out_for_blend_mode(seq) == StripEarlyOut::DoEffect) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf2 = rendered_ibufs[i] ?
+                         rendered_ibufs[i] :
+                         seq_render_strip(context, state, seq, timeline_frame);
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -2009,17 +2097,33 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   SEQ_relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
   if (!strips.is_empty() && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
-    out = seq_render_strip_stack(context, &state, channels, seqbasep, timeline_frame, chanshown);
-
     if (context->is_prefetch_render) {
+      {
+        std::unique_lock waiting_lock(seq_render_exclusive_waiting_mutex);
+        seq_render_exclusive_waiting_cond.wait(
+            waiting_lock, [] { return seq_render_exclusive_waiting_num == 0; });
+      }
+      std::shared_lock lock(seq_render_mutex);
+      out = seq_render_strip_stack(
+          context, &state, channels, seqbasep, timeline_frame, chanshown);
       seq_cache_put(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
     else {
+      {
+        std::lock_guard waiting_lock(seq_render_exclusive_waiting_mutex);
+        seq_render_exclusive_waiting_num++;
+      }
+      std::unique_lock lock(seq_render_mutex);
+      {
+        std::lock_guard waiting_lock(seq_render_exclusive_waiting_mutex);
+        seq_render_exclusive_waiting_num--;
+      }
+      seq_render_exclusive_waiting_cond.notify_all();
+      out = seq_render_strip_stack(
+          context, &state, channels, seqbasep, timeline_frame, chanshown);
       seq_cache_put_if_possible(
           context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
   }
 
   seq_prefetch_start(context, timeline_frame);
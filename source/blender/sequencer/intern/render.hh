@@ -48,6 +48,14 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
                         Strip *seq,
                         float timeline_frame);
 
+/**
+ * Image and movie strips only access their own data and the thread-safe cache while rendering, so
+ * multiple of them can be rendered at the same time. Other strip types may render scenes, use the
+ * GPU or recursively render other strips, so they are always rendered on the calling thread. The
+ * same is true for strips with modifiers that use another strip as mask input.
+ */
+bool seq_render_strip_supports_threading(const Strip *seq);
+
 /* Renders Mask into an image suitable for sequencer:
  * RGB channels contain mask intensity; alpha channel is opaque. */
 ImBuf *seq_render_mask(const SeqRenderData *context,
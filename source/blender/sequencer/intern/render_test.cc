@@ -0,0 +1,59 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "DNA_sequence_types.h"
+
+#include "BLI_listbase.h"
+
+#include "render.hh"
+
+#include "testing/testing.h"
+
+namespace blender::seq::tests {
+
+TEST(sequencer_render, strip_type_supports_threading)
+{
+  Strip strip{};
+  for (const int type : {SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE}) {
+    strip.type = type;
+    EXPECT_TRUE(seq_render_strip_supports_threading(&strip));
+  }
+  for (const int type : {SEQ_TYPE_SCENE, SEQ_TYPE_META, SEQ_TYPE_MOVIECLIP, SEQ_TYPE_MASK,
+                         SEQ_TYPE_COLOR, SEQ_TYPE_CROSS, SEQ_TYPE_TEXT, SEQ_TYPE_ADJUSTMENT})
+  {
+    strip.type = type;
+    EXPECT_FALSE(seq_render_strip_supports_threading(&strip));
+  }
+}
+
+TEST(sequencer_render, mask_strip_modifier_disables_threading)
+{
+  Strip mask_strip{};
+  mask_strip.type = SEQ_TYPE_SCENE;
+
+  Strip strip{};
+  strip.type = SEQ_TYPE_MOVIE;
+  SequenceModifierData mask_id_modifier{};
+  mask_id_modifier.type = seqModifierType_Mask;
+  mask_id_modifier.mask_input_type = SEQUENCE_MASK_INPUT_ID;
+  mask_id_modifier.mask_sequence = &mask_strip;
+  BLI_addtail(&strip.modifiers, &mask_id_modifier);
+  SequenceModifierData mask_strip_modifier{};
+  mask_strip_modifier.type = seqModifierType_BrightContrast;
+  mask_strip_modifier.mask_input_type = SEQUENCE_MASK_INPUT_STRIP;
+  BLI_addtail(&strip.modifiers, &mask_strip_modifier);
+
+  /* Modifiers without a mask strip don't render other strips. */
+  EXPECT_TRUE(seq_render_strip_supports_threading(&strip));
+
+  /* The mask strip would be rendered on the worker thread. */
+  mask_strip_modifier.mask_sequence = &mask_strip;
+  EXPECT_FALSE(seq_render_strip_supports_threading(&strip));
+
+  /* Muted modifiers are not evaluated. */
+  mask_strip_modifier.flag |= SEQUENCE_MODIFIER_MUTE;
+  EXPECT_TRUE(seq_render_strip_supports_threading(&strip));
+}
+
+}  // namespace blender::seq::tests
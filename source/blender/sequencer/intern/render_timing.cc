@@ -0,0 +1,255 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup sequencer
+ */
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.hh"
+#include "BLI_map.hh"
+#include "BLI_math_base.h"
+#include "BLI_serialize.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+
+#include "SEQ_render.hh"
+#include "SEQ_render_timing.hh"
+
+#include "prefetch.hh"
+#include "render_timing.hh"
+
+namespace blender::seq {
+
+struct RenderTimingsData {
+  std::mutex mutex;
+  /** Timings per strip name and timeline frame. */
+  Map<std::string, Map<int, StripFrameTiming>> strips;
+};
+
+struct RenderTimings {
+  /** Only accessed from the main thread. */
+  int users_num = 0;
+  /**
+   * Shared with the timers that are running, so that a render on another thread can still
+   * record into it after recording stopped.
+   */
+  std::shared_ptr<RenderTimingsData> data = std::make_shared<RenderTimingsData>();
+};
+
+/**
+ * Guards the timings pointer of the editing against being freed while a render thread takes a
+ * reference to its data. The main thread is the only one changing the pointer, so it can read it
+ * without locking.
+ */
+static std::mutex timings_pointer_mutex;
+
+/** Innermost timer that is running on this thread. */
+static thread_local ScopedRenderTimer *active_timer = nullptr;
+
+bool render_timings_add_user(Scene *scene)
+{
+  if (scene->ed == nullptr) {
+    return false;
+  }
+  if (scene->ed->runtime.render_timings == nullptr) {
+    RenderTimings *timings = MEM_new<RenderTimings>(__func__);
+    std::scoped_lock lock(timings_pointer_mutex);
+    scene->ed->runtime.render_timings = timings;
+  }
+  scene->ed->runtime.render_timings->users_num++;
+  return true;
+}
+
+void render_timings_remove_user(Scene *scene)
+{
+  if (!render_timings_is_recording(scene)) {
+    return;
+  }
+  RenderTimings *timings = scene->ed->runtime.render_timings;
+  BLI_assert(timings->users_num > 0);
+  timings->users_num--;
+  if (timings->users_num <= 0) {
+    render_timings_free(scene);
+  }
+}
+
+void render_timings_free(Scene *scene)
+{
+  if (scene->ed == nullptr || scene->ed->runtime.render_timings == nullptr) {
+    return;
+  }
+  RenderTimings *timings = scene->ed->runtime.render_timings;
+  {
+    std::scoped_lock lock(timings_pointer_mutex);
+    scene->ed->runtime.render_timings = nullptr;
+  }
+  /* Timers that are still running keep their own reference to the data. */
+  MEM_delete(timings);
+}
+
+bool render_timings_is_recording(const Scene *scene)
+{
+  return scene->ed != nullptr && scene->ed->runtime.render_timings != nullptr;
+}
+
+void render_timings_foreach_frame(
+    const Scene *scene,
+    const Strip *seq,
+    FunctionRef<void(int timeline_frame, const StripFrameTiming &)> fn)
+{
+  if (!render_timings_is_recording(scene)) {
+    return;
+  }
+  RenderTimingsData &timings = *scene->ed->runtime.render_timings->data;
+  std::scoped_lock lock(timings.mutex);
+  const Map<int, StripFrameTiming> *frames = timings.strips.lookup_ptr_as(
+      StringRef(seq->name + 2));
+  if (frames == nullptr) {
+    return;
+  }
+  for (const auto item : frames->items()) {
+    fn(item.key, item.value);
+  }
+}
+
+bool render_timings_write_json(const Scene *scene, const char *filepath)
+{
+  using namespace io::serialize;
+
+  DictionaryValue root;
+  root.append_str("scene", scene->id.name + 2);
+  root.append_double("fps", double(scene->r.frs_sec) / double(scene->r.frs_sec_base));
+  std::shared_ptr<ArrayValue> strips = root.append_array("strips");
+
+  if (render_timings_is_recording(scene)) {
+    RenderTimingsData &timings = *scene->ed->runtime.render_timings->data;
+    std::scoped_lock lock(timings.mutex);
+    for (const auto strip_item : timings.strips.items()) {
+      std::shared_ptr<DictionaryValue> strip = strips->append_dict();
+      strip->append_str("name", strip_item.key);
+      std::shared_ptr<ArrayValue> frames = strip->append_array("frames");
+
+      Vector<int> frame_numbers;
+      for (const int frame : strip_item.value.keys()) {
+        frame_numbers.append(frame);
+      }
+      std::sort(frame_numbers.begin(), frame_numbers.end());
+
+      for (const int frame_number : frame_numbers) {
+        const StripFrameTiming &timing = strip_item.value.lookup(frame_number);
+        std::shared_ptr<DictionaryValue> frame = frames->append_dict();
+        frame->append_int("frame", frame_number);
+        frame->append_double("render_ms", timing.stage_ms[int(RenderTimingStage::Render)]);
+        frame->append_double("preprocess_ms", timing.stage_ms[int(RenderTimingStage::Preprocess)]);
+        frame->append_double("modifiers_ms", timing.stage_ms[int(RenderTimingStage::Modifiers)]);
+        frame->append_double("blend_ms", timing.stage_ms[int(RenderTimingStage::Blend)]);
+        frame->append_double("total_ms", timing.total_ms());
+        frame->append_int("cache_hits", timing.cache_hits);
+      }
+    }
+  }
+
+  fstream stream(filepath, std::ios::out);
+  if (!stream.is_open()) {
+    return false;
+  }
+  JsonFormatter formatter;
+  formatter.indentation_len = 2;
+  formatter.serialize(stream, root);
+  return !stream.fail();
+}
+
+/**
+ * Timings of prefetch renders are recorded in the original scene, which is the one that is
+ * displayed.
+ */
+static std::shared_ptr<RenderTimingsData> render_timings_get(const SeqRenderData *context)
+{
+  if (context->is_proxy_render) {
+    return nullptr;
+  }
+  if (context->is_prefetch_render) {
+    context = seq_prefetch_get_original_context(context);
+  }
+  const Scene *scene = context->scene;
+  if (scene == nullptr || scene->ed == nullptr) {
+    return nullptr;
+  }
+  std::scoped_lock lock(timings_pointer_mutex);
+  const RenderTimings *timings = scene->ed->runtime.render_timings;
+  if (timings == nullptr) {
+    return nullptr;
+  }
+  return timings->data;
+}
+
+ScopedRenderTimer::ScopedRenderTimer(const SeqRenderData *context,
+                                     const Strip *seq,
+                                     const float timeline_frame,
+                                     const RenderTimingStage stage)
+    : timings_(render_timings_get(context)),
+      seq_(seq),
+      timeline_frame_(round_fl_to_int(timeline_frame)),
+      stage_(stage)
+{
+  if (timings_ == nullptr) {
+    return;
+  }
+  parent_ = active_timer;
+  active_timer = this;
+  start_ = timeit::Clock::now();
+}
+
+ScopedRenderTimer::~ScopedRenderTimer()
+{
+  if (timings_ == nullptr) {
+    return;
+  }
+  const timeit::Nanoseconds duration = timeit::Clock::now() - start_;
+  active_timer = parent_;
+  if (parent_ != nullptr) {
+    parent_->nested_time_ += duration;
+  }
+
+  const timeit::Nanoseconds own_duration = std::max(duration - nested_time_,
+                                                    timeit::Nanoseconds(0));
+  const float own_ms = std::chrono::duration<float, std::milli>(own_duration).count();
+
+  std::scoped_lock lock(timings_->mutex);
+  StripFrameTiming &timing =
+      timings_->strips.lookup_or_add_default_as(StringRef(seq_->name + 2))
+          .lookup_or_add_default(timeline_frame_);
+  if (stage_ == RenderTimingStage::Render) {
+    /* Preprocessing is timed after rendering, don't keep the times of a previous render when the
+     * strip is not preprocessed anymore. */
+    timing.stage_ms[int(RenderTimingStage::Preprocess)] = 0.0f;
+    timing.stage_ms[int(RenderTimingStage::Modifiers)] = 0.0f;
+  }
+  timing.stage_ms[int(stage_)] = own_ms;
+}
+
+void render_timing_cache_hit(const SeqRenderData *context,
+                             const Strip *seq,
+                             const float timeline_frame)
+{
+  const std::shared_ptr<RenderTimingsData> timings = render_timings_get(context);
+  if (timings == nullptr) {
+    return;
+  }
+  std::scoped_lock lock(timings->mutex);
+  StripFrameTiming &timing = timings->strips.lookup_or_add_default_as(StringRef(seq->name + 2))
+                                 .lookup_or_add_default(round_fl_to_int(timeline_frame));
+  timing.cache_hits++;
+}
+
+}  // namespace blender::seq
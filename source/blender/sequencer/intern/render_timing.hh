@@ -0,0 +1,51 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup sequencer
+ */
+
+#include <memory>
+
+#include "BLI_timeit.hh"
+#include "BLI_utility_mixins.hh"
+
+#include "SEQ_render_timing.hh"
+
+struct SeqRenderData;
+struct Strip;
+
+namespace blender::seq {
+
+struct RenderTimingsData;
+
+/**
+ * Measures the time of one render stage of a strip and records it when going out of scope, if
+ * the scene is recording timings. Timers that are active on the same thread while this one runs
+ * are nested: their time is subtracted, so every strip only gets the time spent on itself.
+ */
+class ScopedRenderTimer : NonCopyable, NonMovable {
+ private:
+  std::shared_ptr<RenderTimingsData> timings_;
+  const Strip *seq_;
+  int timeline_frame_;
+  RenderTimingStage stage_;
+  timeit::TimePoint start_;
+  timeit::Nanoseconds nested_time_{0};
+  ScopedRenderTimer *parent_ = nullptr;
+
+ public:
+  ScopedRenderTimer(const SeqRenderData *context,
+                    const Strip *seq,
+                    float timeline_frame,
+                    RenderTimingStage stage);
+  ~ScopedRenderTimer();
+};
+
+/** Record that the image of a strip was taken from the cache instead of being rendered. */
+void render_timing_cache_hit(const SeqRenderData *context, const Strip *seq, float timeline_frame);
+
+}  // namespace blender::seq
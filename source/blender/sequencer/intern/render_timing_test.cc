@@ -0,0 +1,190 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <chrono>
+#include <thread>
+
+#include "BLI_map.hh"
+#include "BLI_string.h"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+
+#include "SEQ_render.hh"
+#include "SEQ_render_timing.hh"
+
+#include "render_timing.hh"
+
+#include "testing/testing.h"
+
+namespace blender::seq::tests {
+
+/** Scene with sequencer data and a single strip, without any of the main database. */
+struct RenderTimingTestContext {
+  Scene scene{};
+  Editing ed{};
+  Strip strip{};
+  SeqRenderData render_context{};
+
+  RenderTimingTestContext()
+  {
+    scene.ed = &ed;
+    STRNCPY(strip.name, "SQStrip");
+    render_context.scene = &scene;
+  }
+
+  ~RenderTimingTestContext()
+  {
+    render_timings_free(&scene);
+  }
+
+  Map<int, StripFrameTiming> recorded_frames() const
+  {
+    Map<int, StripFrameTiming> frames;
+    render_timings_foreach_frame(
+        &scene, &strip, [&](const int timeline_frame, const StripFrameTiming &timing) {
+          frames.add_new(timeline_frame, timing);
+        });
+    return frames;
+  }
+};
+
+static void sleep_ms(const int ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST(sequencer_render_timing, users)
+{
+  RenderTimingTestContext ctx;
+  EXPECT_FALSE(render_timings_is_recording(&ctx.scene));
+
+  EXPECT_TRUE(render_timings_add_user(&ctx.scene));
+  EXPECT_TRUE(render_timings_add_user(&ctx.scene));
+  EXPECT_TRUE(render_timings_is_recording(&ctx.scene));
+
+  /* Removing one of the users keeps the recorded timings of the other. */
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 1.0f);
+  render_timings_remove_user(&ctx.scene);
+  EXPECT_TRUE(render_timings_is_recording(&ctx.scene));
+  EXPECT_EQ(ctx.recorded_frames().size(), 1);
+
+  render_timings_remove_user(&ctx.scene);
+  EXPECT_FALSE(render_timings_is_recording(&ctx.scene));
+  EXPECT_TRUE(ctx.recorded_frames().is_empty());
+}
+
+TEST(sequencer_render_timing, scene_without_sequencer_data)
+{
+  Scene scene{};
+  EXPECT_FALSE(render_timings_add_user(&scene));
+  EXPECT_FALSE(render_timings_is_recording(&scene));
+}
+
+TEST(sequencer_render_timing, not_recording)
+{
+  RenderTimingTestContext ctx;
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 1.0f, RenderTimingStage::Render);
+  }
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 1.0f);
+
+  /* Timings of earlier renders are not kept when recording starts. */
+  render_timings_add_user(&ctx.scene);
+  EXPECT_TRUE(ctx.recorded_frames().is_empty());
+  render_timings_remove_user(&ctx.scene);
+}
+
+TEST(sequencer_render_timing, stages_and_cache_hits)
+{
+  RenderTimingTestContext ctx;
+  render_timings_add_user(&ctx.scene);
+
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 3.0f, RenderTimingStage::Render);
+    sleep_ms(2);
+  }
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 3.0f, RenderTimingStage::Blend);
+  }
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 3.0f);
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 3.0f);
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 4.0f);
+
+  const Map<int, StripFrameTiming> frames = ctx.recorded_frames();
+  ASSERT_EQ(frames.size(), 2);
+  const StripFrameTiming &timing = frames.lookup(3);
+  EXPECT_GE(timing.stage_ms[int(RenderTimingStage::Render)], 2.0f);
+  EXPECT_EQ(timing.stage_ms[int(RenderTimingStage::Preprocess)], 0.0f);
+  EXPECT_EQ(timing.cache_hits, 2);
+  EXPECT_EQ(frames.lookup(4).cache_hits, 1);
+  EXPECT_EQ(frames.lookup(4).total_ms(), 0.0f);
+
+  render_timings_remove_user(&ctx.scene);
+}
+
+TEST(sequencer_render_timing, nested_timers_record_own_time)
+{
+  RenderTimingTestContext ctx;
+  render_timings_add_user(&ctx.scene);
+
+  /* Effect strip that renders its input, the time of the input is only recorded for the input. */
+  Strip input{};
+  STRNCPY(input.name, "SQInput");
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 1.0f, RenderTimingStage::Render);
+    {
+      ScopedRenderTimer input_timer(
+          &ctx.render_context, &input, 1.0f, RenderTimingStage::Render);
+      sleep_ms(20);
+    }
+  }
+
+  float input_ms = 0.0f;
+  render_timings_foreach_frame(
+      &ctx.scene, &input, [&](const int /*timeline_frame*/, const StripFrameTiming &timing) {
+        input_ms = timing.stage_ms[int(RenderTimingStage::Render)];
+      });
+  const Map<int, StripFrameTiming> frames = ctx.recorded_frames();
+  ASSERT_EQ(frames.size(), 1);
+  const float own_ms = frames.lookup(1).stage_ms[int(RenderTimingStage::Render)];
+  EXPECT_GE(input_ms, 20.0f);
+  EXPECT_LT(own_ms, input_ms);
+
+  render_timings_remove_user(&ctx.scene);
+}
+
+TEST(sequencer_render_timing, timer_outlives_recording)
+{
+  RenderTimingTestContext ctx;
+  render_timings_add_user(&ctx.scene);
+
+  /* Recording can stop on the main thread while a render is still running on another one. */
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 1.0f, RenderTimingStage::Render);
+    render_timings_remove_user(&ctx.scene);
+  }
+  EXPECT_FALSE(render_timings_is_recording(&ctx.scene));
+
+  render_timings_add_user(&ctx.scene);
+  EXPECT_TRUE(ctx.recorded_frames().is_empty());
+  render_timings_remove_user(&ctx.scene);
+}
+
+TEST(sequencer_render_timing, proxy_renders_are_not_recorded)
+{
+  RenderTimingTestContext ctx;
+  render_timings_add_user(&ctx.scene);
+
+  ctx.render_context.is_proxy_render = true;
+  {
+    ScopedRenderTimer timer(&ctx.render_context, &ctx.strip, 1.0f, RenderTimingStage::Render);
+  }
+  render_timing_cache_hit(&ctx.render_context, &ctx.strip, 1.0f);
+  EXPECT_TRUE(ctx.recorded_frames().is_empty());
+
+  render_timings_remove_user(&ctx.scene);
+}
+
+}  // namespace blender::seq::tests
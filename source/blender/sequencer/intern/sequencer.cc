@@ -47,6 +47,7 @@
 #include "SEQ_modifier.hh"
 #include "SEQ_proxy.hh"
 #include "SEQ_relations.hh"
+#include "SEQ_render_timing.hh"
 #include "SEQ_retiming.hh"
 #include "SEQ_select.hh"
 #include "SEQ_sequencer.hh"
@@ -308,6 +309,7 @@ void SEQ_editing_free(Scene *scene, const bool do_id_user)
   SEQ_sequence_lookup_free(scene);
   blender::seq::media_presence_free(scene);
   blender::seq::thumbnail_cache_destroy(scene);
+  blender::seq::render_timings_free(scene);
   SEQ_channels_free(&ed->channels);
 
   MEM_freeN(ed);
@@ -204,7 +204,26 @@ ListBase *SEQ_get_seqbase_from_sequence(Strip *seq, ListBase **r_channels, int *
   return seqbase;
 }
 
-static void open_anim_filepath(Strip *seq, StripAnim *sanim, const char *filepath, bool openfile)
+/**
+ * Number of frames that movies decode ahead and behind the current frame. It is only worth it
+ * when frames are not prefetched already. Prefetch workers render a copy of the scene with the
+ * cache disabled, so their movies don't decode ahead either. The decoded frames are allocated
+ * like cached images, so they count towards the memory cache limit.
+ */
+static int decode_ahead_frames_num(const Editing *ed)
+{
+  if ((ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || (ed->cache_flag & SEQ_CACHE_ALL_TYPES) == 0)
+  {
+    return 0;
+  }
+  return 2;
+}
+
+static void open_anim_filepath(const Editing *ed,
+                               Strip *seq,
+                               StripAnim *sanim,
+                               const char *filepath,
+                               bool openfile)
 {
   if (openfile) {
     sanim->anim = openanim(filepath,
@@ -218,6 +237,9 @@ static void open_anim_filepath(Strip *seq, StripAnim *sanim, const char *filepat
                                   seq->streamindex,
                                   seq->data->colorspace_settings.name);
   }
+  if (sanim->anim) {
+    MOV_set_decode_ahead(sanim->anim, decode_ahead_frames_num(ed));
+  }
 }
 
 static bool use_proxy(Editing *ed, Strip *seq)
@@ -277,7 +299,7 @@ static bool open_anim_file_multiview(Scene *scene, Strip *seq, const char *filep
 
     StripAnim *sanim = static_cast<StripAnim *>(MEM_mallocN(sizeof(StripAnim), "Strip Anim"));
     /* Multiview files must be loaded, otherwise it is not possible to detect failure. */
-    open_anim_filepath(seq, sanim, filepath_view, true);
+    open_anim_filepath(ed, seq, sanim, filepath_view, true);
 
     if (sanim->anim == nullptr) {
       SEQ_relations_sequence_free_anim(seq);
@@ -319,7 +341,7 @@ void seq_open_anim_file(Scene *scene, Strip *seq, bool openfile)
   if (!is_multiview || !multiview_is_loaded) {
     StripAnim *sanim = static_cast<StripAnim *>(MEM_mallocN(sizeof(StripAnim), "Strip Anim"));
     BLI_addtail(&seq->anims, sanim);
-    open_anim_filepath(seq, sanim, filepath, openfile);
+    open_anim_filepath(ed, seq, sanim, filepath, openfile);
     index_dir_set(ed, seq, sanim);
   }
 }
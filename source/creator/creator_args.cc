@@ -739,6 +739,7 @@ static void print_help(bArgs *ba, bool all)
   }
   BLI_args_print_arg_doc(ba, "--debug-memory");
   BLI_args_print_arg_doc(ba, "--debug-jobs");
+  BLI_args_print_arg_doc(ba, "--debug-compositor-trace");
   BLI_args_print_arg_doc(ba, "--debug-python");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-eval");
@@ -1431,6 +1432,23 @@ static int arg_handle_debug_value_set(int argc, const char **argv, void * /*data
   return 0;
 }
 
+static const char arg_handle_debug_compositor_trace_set_doc[] =
+    "<filepath>\n"
+    "\tWrite a trace of every compositor evaluation to a file, for viewing in a trace viewer\n"
+    "\tlike Perfetto. Use '#' in the path to insert the frame number, so traces of animations\n"
+    "\tare not overwritten.";
+static int arg_handle_debug_compositor_trace_set(int argc, const char **argv, void * /*data*/)
+{
+  const char *arg_id = "--debug-compositor-trace";
+  if (argc > 1) {
+    STRNCPY(G.compositor_trace_filepath, argv[1]);
+    BLI_path_abs_from_cwd(G.compositor_trace_filepath, sizeof(G.compositor_trace_filepath));
+    return 1;
+  }
+  fprintf(stderr, "\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_debug_gpu_set_doc[] =
     "\n"
     "\tEnable GPU debug context and information for OpenGL 4.3+.";
@@ -2791,6 +2809,11 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
                "--debug-jobs",
                CB_EX(arg_handle_debug_mode_generic_set, jobs),
                (void *)G_DEBUG_JOBS);
+  BLI_args_add(ba,
+               nullptr,
+               "--debug-compositor-trace",
+               CB(arg_handle_debug_compositor_trace_set),
+               nullptr);
   BLI_args_add(ba, nullptr, "--debug-gpu", CB(arg_handle_debug_gpu_set), nullptr);
   BLI_args_add(ba,
                nullptr,